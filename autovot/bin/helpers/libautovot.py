@@ -0,0 +1,194 @@
+from __future__ import print_function
+from __future__ import division
+from __future__ import absolute_import
+# Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+#
+# This file is part of Autovot, a package for automatic extraction of
+# voice onset time (VOT) from audio files.
+#
+# Autovot is free software: you can redistribute it and/or modify it
+# under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3 of the
+# License, or (at your option) any later version.
+#
+# Autovot is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with Autovot.  If not, see
+# <http://www.gnu.org/licenses/>.
+#
+
+# ctypes wrapper of libautovot.so (see autovot.h): front end and decoding
+# in-process, without feature files.
+
+import ctypes
+import os
+import wave
+
+import numpy as np
+
+NUM_FEATURES = 63
+FRAME_SIZE = 0.001
+
+
+class _Options(ctypes.Structure):
+    _fields_ = [("min_vot_length", ctypes.c_int),
+                ("max_vot_length", ctypes.c_int),
+                ("max_onset", ctypes.c_int),
+                ("pos_only", ctypes.c_int),
+                ("kernel_expansion", ctypes.c_char_p),
+                ("sigma", ctypes.c_double),
+                ("ignore_features", ctypes.c_char_p),
+                ("text_precision", ctypes.c_int)]
+
+
+class _Prediction(ctypes.Structure):
+    _fields_ = [("confidence", ctypes.c_double),
+                ("burst", ctypes.c_int),
+                ("voice", ctypes.c_int)]
+
+
+def _load_library(path=None):
+    if path is None:
+        path = os.path.join(os.path.dirname(os.path.dirname(os.path.abspath(__file__))), "libautovot.so")
+    lib = ctypes.CDLL(path)
+    double_p = ctypes.POINTER(ctypes.c_double)
+    lib.autovot_strerror.restype = ctypes.c_char_p
+    lib.autovot_default_options.argtypes = [ctypes.POINTER(_Options)]
+    lib.autovot_model_load.argtypes = [ctypes.c_char_p, ctypes.POINTER(_Options), ctypes.POINTER(ctypes.c_void_p)]
+    lib.autovot_model_free.argtypes = [ctypes.c_void_p]
+    lib.autovot_window_frames.argtypes = [ctypes.c_long, ctypes.c_double, ctypes.c_double, ctypes.c_double,
+                                          ctypes.POINTER(ctypes.c_long)]
+    lib.autovot_extract_features.argtypes = [double_p, ctypes.c_long, ctypes.c_double, ctypes.c_double,
+                                             ctypes.c_double, ctypes.c_int, double_p, ctypes.c_long,
+                                             ctypes.POINTER(ctypes.c_long)]
+    lib.autovot_decode.argtypes = [ctypes.c_void_p, double_p, ctypes.c_long, ctypes.POINTER(_Prediction)]
+    lib.autovot_stream_new.argtypes = [ctypes.c_void_p, ctypes.c_double, ctypes.POINTER(ctypes.c_void_p)]
+    lib.autovot_stream_free.argtypes = [ctypes.c_void_p]
+    lib.autovot_stream_reset.argtypes = [ctypes.c_void_p]
+    lib.autovot_stream_push.argtypes = [ctypes.c_void_p, double_p, ctypes.c_long, ctypes.POINTER(ctypes.c_long),
+                                        ctypes.POINTER(ctypes.c_int)]
+    lib.autovot_stream_finish.argtypes = [ctypes.c_void_p]
+    lib.autovot_stream_best.argtypes = [ctypes.c_void_p, ctypes.POINTER(_Prediction), ctypes.POINTER(ctypes.c_long)]
+    return lib
+
+
+class AutovotError(Exception):
+    pass
+
+
+class Autovot(object):
+    """A loaded classifier. extract_features() returns a frames x NUM_FEATURES
+    numpy array written in place by the library; decode() returns
+    (confidence, burst, voice) with burst and voice in seconds."""
+
+    def __init__(self, classifier_filename, min_vot_length=15, max_vot_length=200, max_onset=150,
+                 pos_only=False, kernel_expansion="", sigma=1.0, ignore_features="", library=None):
+        self._lib = _load_library(library)
+        options = _Options()
+        self._lib.autovot_default_options(ctypes.byref(options))
+        options.min_vot_length = min_vot_length
+        options.max_vot_length = max_vot_length
+        options.max_onset = max_onset
+        options.pos_only = int(pos_only)
+        options.kernel_expansion = kernel_expansion.encode()
+        options.sigma = sigma
+        options.ignore_features = ignore_features.encode()
+        self._model = ctypes.c_void_p()
+        self._check(self._lib.autovot_model_load(classifier_filename.encode(), ctypes.byref(options),
+                                                 ctypes.byref(self._model)))
+
+    def __del__(self):
+        if getattr(self, "_model", None):
+            self._lib.autovot_model_free(self._model)
+            self._model = None
+
+    def _check(self, rc):
+        if rc != 0:
+            raise AutovotError(self._lib.autovot_strerror(rc).decode())
+
+    @staticmethod
+    def read_wav(wav_filename):
+        """Samples of a 16-bit wav file scaled as by the front end, and its
+        sampling rate"""
+        wav_file = wave.open(wav_filename, "r")
+        data = wav_file.readframes(wav_file.getnframes())
+        sampling_rate = wav_file.getframerate()
+        wav_file.close()
+        return np.frombuffer(data, dtype="<i2") / 32767.0, sampling_rate
+
+    def extract_features(self, samples, sampling_rate, window_start, window_end=-1, normalize=True):
+        samples = np.ascontiguousarray(samples, dtype=np.float64)
+        num_frames = ctypes.c_long()
+        self._check(self._lib.autovot_window_frames(len(samples), sampling_rate, window_start, window_end,
+                                                    ctypes.byref(num_frames)))
+        features = np.empty((num_frames.value, NUM_FEATURES))
+        double_p = ctypes.POINTER(ctypes.c_double)
+        self._check(self._lib.autovot_extract_features(samples.ctypes.data_as(double_p), len(samples),
+                                                       sampling_rate, window_start, window_end, int(normalize),
+                                                       features.ctypes.data_as(double_p), len(features),
+                                                       ctypes.byref(num_frames)))
+        return features
+
+    def decode(self, features, window_start=0.0):
+        features = np.ascontiguousarray(features, dtype=np.float64)
+        prediction = _Prediction()
+        self._check(self._lib.autovot_decode(self._model,
+                                             features.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+                                             len(features), ctypes.byref(prediction)))
+        return (prediction.confidence, window_start + prediction.burst * FRAME_SIZE,
+                window_start + prediction.voice * FRAME_SIZE)
+
+    def stream(self, sampling_rate):
+        """An AutovotStream decoding the window starting at the first sample
+        pushed"""
+        return AutovotStream(self, sampling_rate)
+
+
+class AutovotStream(object):
+    """Incremental decoding of a window while its samples arrive. push()
+    returns the number of samples used (fewer once the decoding is final);
+    best() returns (confidence, burst, voice) in seconds from the start of
+    the window, or None before the first frame is scored."""
+
+    def __init__(self, autovot, sampling_rate):
+        self._autovot = autovot
+        self._lib = autovot._lib
+        self._stream = ctypes.c_void_p()
+        self.final = False
+        autovot._check(self._lib.autovot_stream_new(autovot._model, sampling_rate, ctypes.byref(self._stream)))
+
+    def __del__(self):
+        if getattr(self, "_stream", None):
+            self._lib.autovot_stream_free(self._stream)
+            self._stream = None
+
+    def reset(self):
+        self._autovot._check(self._lib.autovot_stream_reset(self._stream))
+        self.final = False
+
+    def push(self, samples):
+        samples = np.ascontiguousarray(samples, dtype=np.float64)
+        num_used = ctypes.c_long()
+        final = ctypes.c_int()
+        self._autovot._check(self._lib.autovot_stream_push(self._stream,
+                                                           samples.ctypes.data_as(ctypes.POINTER(ctypes.c_double)),
+                                                           len(samples), ctypes.byref(num_used), ctypes.byref(final)))
+        self.final = bool(final.value)
+        return num_used.value
+
+    def finish(self):
+        self._autovot._check(self._lib.autovot_stream_finish(self._stream))
+        self.final = True
+
+    def best(self):
+        prediction = _Prediction()
+        frames_scored = ctypes.c_long()
+        rc = self._lib.autovot_stream_best(self._stream, ctypes.byref(prediction), ctypes.byref(frames_scored))
+        if frames_scored.value == 0:
+            return None
+        self._autovot._check(rc)
+        return (prediction.confidence, prediction.burst * FRAME_SIZE, prediction.voice * FRAME_SIZE)
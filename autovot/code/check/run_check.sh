@@ -0,0 +1,141 @@
+#!/bin/bash
+#
+# Golden output regression check: runs the front end and the decoder on
+# the test set of experiments/data/tutorialExample with the classifiers of
+# experiments/models, and compares the results with the references stored
+# in check/reference:
+#   - the features of a subset of the tokens, within the per-feature
+#     tolerances of check/feature_tolerances.txt
+#   - the predictions of each model, exactly or within -frame_tolerance
+# The wall time of each stage is reported next to that of the reference
+# run.
+#
+# usage: run_check.sh [-update] [-frame_tolerance N] [-keep] BIN_DIR
+#   -update             store the outputs of this run as the references
+#   -frame_tolerance N  allowed difference of the predicted onsets (0)
+#   -keep               keep the temporary directory with the outputs
+#
+# Run by "make check" and "make check-update" in autovot/code.
+#
+
+UPDATE=no
+FRAME_TOLERANCE=0
+KEEP=no
+while [ $# -gt 1 ]; do
+    case "$1" in
+        -update) UPDATE=yes; shift ;;
+        -frame_tolerance) FRAME_TOLERANCE="$2"; shift 2 ;;
+        -keep) KEEP=yes; shift ;;
+        *) echo "run_check.sh: unknown option $1" >&2; exit 1 ;;
+    esac
+done
+if [ $# -ne 1 ]; then
+    echo "usage: run_check.sh [-update] [-frame_tolerance N] [-keep] BIN_DIR" >&2
+    exit 1
+fi
+
+BIN=$(cd "$1" && pwd) || exit 1
+CHECK=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$CHECK/../../.." && pwd)
+REF=$CHECK/reference
+MODELS="bb_jasa nattalia_jasa"
+# tokens of tutorial_test.input whose features are stored (0-based)
+FEATURE_TOKENS="0 10 20 30 40 50"
+
+if [ ! -d "$ROOT/experiments/data/tutorialExample/test" ]; then
+    echo "[check] experiments/data/tutorialExample is missing, nothing to check." >&2
+    exit 1
+fi
+
+TMP=$(mktemp -d "${TMPDIR:-/tmp}/autovot_check.XXXXXX") || exit 1
+if [ $KEEP = no ]; then
+    trap 'rm -rf "$TMP"' EXIT
+else
+    echo "[check] outputs are kept in $TMP"
+fi
+
+# wall time of a command in seconds
+timed() {
+    local start=$(date +%s.%N)
+    "$@" || return 1
+    local end=$(date +%s.%N)
+    awk -v s=$start -v e=$end 'BEGIN { printf "%.2f", e-s }'
+}
+
+# the wall time next to that of the reference run
+report_time() {
+    local name=$1 seconds=$2
+    local ref=$(awk -v n=$name '$1 == n { print $2 }' "$REF/timing.txt" 2>/dev/null)
+    if [ -n "$ref" ]; then
+        awk -v n=$name -v s=$seconds -v r=$ref \
+            'BEGIN { printf "[check] %-24s %8.2f s  (reference %.2f s, %+.1f%%)\n", n, s, r, (r > 0 ? 100*(s-r)/r : 0) }'
+    else
+        printf "[check] %-24s %8.2f s\n" $name $seconds
+    fi
+    echo "$name $seconds" >> "$TMP/timing.txt"
+}
+
+cd "$ROOT"
+NUM_TOKENS=$(grep -c . "$CHECK/tutorial_test.input")
+mkdir -p "$TMP/features" "$TMP/models"
+for ((i = 0; i < NUM_TOKENS; i++)); do
+    echo "$TMP/features/$i.txt"
+done > "$TMP/features.list"
+
+# nattalia_jasa has only the weights of the positive class
+cp experiments/models/bb_jasa.classifier.pos "$TMP/models/bb_jasa.pos"
+cp experiments/models/bb_jasa.classifier.neg "$TMP/models/bb_jasa.neg"
+cp experiments/models/nattalia_jasa.classifier "$TMP/models/nattalia_jasa.pos"
+cp experiments/models/bb_jasa.classifier.neg "$TMP/models/nattalia_jasa.neg"
+
+echo "[check] Front end on $NUM_TOKENS tokens."
+seconds=$(timed "$BIN/VotFrontEnd2" -verbose ERROR "$CHECK/tutorial_test.input" \
+                "$TMP/features.list" "$TMP/labels") || { echo "[check] VotFrontEnd2 failed." >&2; exit 1; }
+report_time frontend $seconds
+
+for model in $MODELS; do
+    seconds=$(timed "$BIN/VotDecode" -verbose ERROR -max_onset 200 -min_vot_length 15 -max_vot_length 250 \
+                    -output_predictions "$TMP/$model.pred" "$TMP/features.list" "$TMP/labels" \
+                    "$TMP/models/$model") || { echo "[check] VotDecode failed." >&2; exit 1; }
+    report_time decode_$model $seconds
+done
+
+if [ $UPDATE = yes ]; then
+    rm -f "$REF"/features/*.txt.gz
+    mkdir -p "$REF/features"
+    for i in $FEATURE_TOKENS; do
+        gzip -9 -n -c "$TMP/features/$i.txt" > "$REF/features/$i.txt.gz"
+    done
+    for model in $MODELS; do
+        cp "$TMP/$model.pred" "$REF/$model.pred"
+    done
+    cp "$TMP/timing.txt" "$REF/timing.txt"
+    echo "[check] References updated in $REF."
+    exit 0
+fi
+
+FAILED=0
+
+echo "[check] Features of tokens $FEATURE_TOKENS:"
+mkdir -p "$TMP/reference"
+rm -f "$TMP/reference.list" "$TMP/output.list"
+for i in $FEATURE_TOKENS; do
+    gzip -d -c "$REF/features/$i.txt.gz" > "$TMP/reference/$i.txt" || exit 1
+    echo "$TMP/reference/$i.txt" >> "$TMP/reference.list"
+    echo "$TMP/features/$i.txt" >> "$TMP/output.list"
+done
+"$BIN/VotCompare" -verbose ERROR -tolerances "$CHECK/feature_tolerances.txt" \
+    "$TMP/reference.list" "$TMP/output.list" || FAILED=1
+
+for model in $MODELS; do
+    echo "[check] Predictions of $model:"
+    "$BIN/VotCompare" -verbose ERROR -predictions -frame_tolerance $FRAME_TOLERANCE \
+        "$REF/$model.pred" "$TMP/$model.pred" || FAILED=1
+done
+
+if [ $FAILED = 0 ]; then
+    echo "[check] Passed."
+else
+    echo "[check] FAILED: the outputs differ from the references in $REF." >&2
+fi
+exit $FAILED
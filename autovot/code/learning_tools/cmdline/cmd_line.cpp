@@ -136,6 +136,7 @@ int cmd_line::parse(int argc, char **argv)
         string &tag = option->tag();
         // check if the current argument is the same as the option's tag
         if (tag.compare(argv[i]) == 0) {
+          given_tags.push_back(tag);
           // check if the option needs a value after the tag
           if (option->needs_value()) {
             // check if such argument exists
@@ -189,6 +190,16 @@ int cmd_line::parse(int argc, char **argv)
 
 //-----------------------------------------------------------------------------
 
+bool cmd_line::given(const std::string &tag)
+{
+  for (unsigned int i = 0; i < given_tags.size(); i++)
+    if (given_tags[i] == tag)
+      return true;
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+
 void cmd_line::print_help()
 {
   vector<cmd_option*>::iterator I;
@@ -84,6 +84,10 @@ class cmd_line
  */  
   int parse(int argc, char **argv) ;
 //-----------------------------------------------------------------------------
+/** Returns true if the option with this tag was given on the command line
+ */  
+  bool given(const std::string &tag);
+//-----------------------------------------------------------------------------
 /** Prints help information for program and usage of tags
  */  
   void print_help();
@@ -95,6 +99,7 @@ class cmd_line
   std::string info_;
   std::vector<cmd_option*> options_vector;
   std::vector<cmd_option*> master_options_vector;
+  std::vector<std::string> given_tags;
   std::string program_name;
 };
 
@@ -16,6 +16,8 @@
 #include "infra_vv_funcs.h"
 #include "infra_vm_funcs.h"
 #include "infra_mm_funcs.h"
+#include "infra_simd.h"
+#include "infra_arena.h"
 
 #endif
 //*****************************************************************************
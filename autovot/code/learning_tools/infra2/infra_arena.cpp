@@ -0,0 +1,152 @@
+//=============================================================================
+// File Name: infra_arena.cpp
+// Written by: the Autovot contributors
+// Date: 19 Oct., 2026
+//
+// Distributed as part of the infra C++ library for linear algebra
+// Copyright (C) 2026 the Autovot contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//=============================================================================
+
+//*****************************************************************************
+// Included Files
+//*****************************************************************************
+#include "infra_arena.h"
+#include <stdlib.h>
+#include <new>
+
+//.............................................................................
+// the arena installed on each thread, see arena::scope
+static thread_local infra::arena* installed_arena = 0;
+//.............................................................................
+
+//----------------------------------------------------------------------------
+infra::arena::arena(unsigned long block_size) :
+  _block(0), _next(0), _end(0), _block_size(block_size), _used(0), 
+  _live(0) {}
+
+//----------------------------------------------------------------------------
+infra::arena::~arena() {
+  // memory still in use stays valid, at the price of a leak
+  if (_live != 0) return;
+  for (unsigned long i = 0; i < _blocks.size(); ++i) free(_blocks[i].raw);
+}
+
+//----------------------------------------------------------------------------
+void* infra::arena::allocate(unsigned long bytes) {
+
+  // keep every allocation aligned
+  bytes = (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  if (bytes == 0) bytes = ALIGNMENT;
+
+  // move on to the next block that fits, or add one
+  while ((unsigned long)(_end - _next) < bytes) {
+    if (_block + 1 < _blocks.size()) {
+      ++_block;
+      _next = _blocks[_block].begin;
+      _end = _next + _blocks[_block].size;
+    }
+    else {
+      add_block(bytes);
+    }
+  }
+
+  void* p = _next;
+  _next += bytes;
+  _used += bytes;
+  ++_live;
+  return p;
+}
+
+//----------------------------------------------------------------------------
+void infra::arena::release() {
+  --_live;
+}
+
+//----------------------------------------------------------------------------
+bool infra::arena::reset() {
+  if (_live != 0) return false;
+
+  // one block for what the last round needed
+  if (_blocks.size() > 1) {
+    unsigned long total = capacity();
+    for (unsigned long i = 0; i < _blocks.size(); ++i) free(_blocks[i].raw);
+    _blocks.clear();
+    add_block(total);
+  }
+  if (_blocks.size() > 0) {
+    _block = 0;
+    _next = _blocks[0].begin;
+    _end = _next + _blocks[0].size;
+  }
+  _used = 0;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+unsigned long infra::arena::live() const {
+  return _live;
+}
+
+//----------------------------------------------------------------------------
+unsigned long infra::arena::used() const {
+  return _used;
+}
+
+//----------------------------------------------------------------------------
+unsigned long infra::arena::capacity() const {
+  unsigned long total = 0;
+  for (unsigned long i = 0; i < _blocks.size(); ++i) total += _blocks[i].size;
+  return total;
+}
+
+//----------------------------------------------------------------------------
+infra::arena* infra::arena::current() {
+  return installed_arena;
+}
+
+//----------------------------------------------------------------------------
+void infra::arena::add_block(unsigned long bytes) {
+  if (bytes < _block_size) bytes = _block_size;
+  bytes = (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+  block b;
+  b.raw = (char*)malloc(bytes + ALIGNMENT - 1);
+  if (b.raw == 0) throw std::bad_alloc();
+  b.begin = b.raw + (ALIGNMENT - (unsigned long)b.raw % ALIGNMENT) % ALIGNMENT;
+  b.size = bytes;
+  _blocks.push_back(b);
+
+  _block = _blocks.size() - 1;
+  _next = b.begin;
+  _end = _next + b.size;
+}
+
+//----------------------------------------------------------------------------
+infra::arena::scope::scope(arena* a) :
+  _previous(installed_arena) {
+  installed_arena = a;
+}
+
+//----------------------------------------------------------------------------
+infra::arena::scope::~scope() {
+  installed_arena = _previous;
+}
+
+//*****************************************************************************
+//                                     E O F
+//*****************************************************************************
@@ -0,0 +1,179 @@
+//=============================================================================
+// File Name: infra_arena.h
+// Written by: the Autovot contributors
+// Date: 19 Oct., 2026
+//
+// Distributed as part of the infra C++ library for linear algebra
+// Copyright (C) 2026 the Autovot contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//=============================================================================
+#ifndef _INFRA_ARENA_H_
+#define _INFRA_ARENA_H_
+
+//*****************************************************************************
+// Included Files
+//*****************************************************************************
+#include <atomic>
+#include <vector>
+
+//*****************************************************************************
+/** An arena from which vectors and matrices can take their memory instead
+    of the heap, for the many short-lived temporaries of a computation that
+    is repeated, such as the features of one utterance after the other. 
+    Allocating is moving a pointer, and reset() makes all the memory 
+    available again at once, so after the first few utterances the arena 
+    stops calling malloc altogether.
+
+    An arena is used by the vectors and matrices allocated (constructed or
+    resized) on a thread while an arena::scope installed it on that thread;
+    there is none by default, and they use the heap. A thread must install its own arena: 
+    an arena is not shared by threads while memory is taken from it. The
+    vectors and matrices may however be destroyed on any thread.
+*/
+namespace infra {
+
+//----------------------------------------------------------------------------
+/** Memory taken from big blocks, and released all at once
+*/
+class arena
+{
+//=============================================================================
+// arena Function Declarations
+//=============================================================================
+public:
+//----------------------------------------------------------------------------
+/** The size of the first block, and the least size of the others
+*/
+  static const unsigned long DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+//----------------------------------------------------------------------------
+/** The alignment of the memory returned by allocate(), in bytes
+*/
+  static const unsigned long ALIGNMENT = 64;
+
+//----------------------------------------------------------------------------
+/** Constructs an arena. No memory is allocated until it is needed.
+    @param block_size The size of the first block, in bytes
+*/
+  explicit arena(unsigned long block_size = DEFAULT_BLOCK_SIZE);
+
+//----------------------------------------------------------------------------
+/** Destructor. Frees the blocks, unless memory taken from them is still 
+    in use, in which case they are left allocated.
+*/
+  ~arena();
+
+//----------------------------------------------------------------------------
+/** Takes memory from the arena, adding a block if the current one is full.
+    Each call must be matched by a call to release() once the memory is no
+    longer used.
+    @param bytes The number of bytes
+    @return A pointer to memory aligned to ALIGNMENT bytes
+*/
+  void* allocate(unsigned long bytes);
+
+//----------------------------------------------------------------------------
+/** Tells the arena that the memory of one allocate() is no longer used. 
+    The memory itself is only reused after reset(). May be called from any 
+    thread.
+*/
+  void release();
+
+//----------------------------------------------------------------------------
+/** Makes all the memory of the arena available again, if none of it is in
+    use. When the last round needed several blocks, they are replaced by 
+    one block as big as all of them.
+    @return 'true' if the arena was reset, 'false' if memory was still in
+    use and nothing was done
+*/
+  bool reset();
+
+//----------------------------------------------------------------------------
+/** Returns the number of allocations not released yet
+    @return The number of allocations in use
+*/
+  unsigned long live() const;
+
+//----------------------------------------------------------------------------
+/** Returns the number of bytes taken since the last reset()
+    @return The bytes taken, rounded up to ALIGNMENT for each allocation
+*/
+  unsigned long used() const;
+
+//----------------------------------------------------------------------------
+/** Returns the total size of the blocks
+    @return The size of the blocks, in bytes
+*/
+  unsigned long capacity() const;
+
+//----------------------------------------------------------------------------
+/** Returns the arena installed on the calling thread
+    @return The arena, or NULL if vectors and matrices use the heap
+*/
+  static arena* current();
+
+//----------------------------------------------------------------------------
+/** Installs an arena on the calling thread for the lifetime of the scope 
+    object, and then restores the one that was installed before. Scopes 
+    can be nested, and a scope of NULL makes the vectors and matrices it 
+    covers use the heap, e.g. for results that must outlive the arena.
+*/
+  class scope
+  {
+  public:
+    explicit scope(arena* a);
+    ~scope();
+  private:
+    scope(const scope&);
+    void operator=(const scope&);
+    arena* _previous;
+  };
+
+//=============================================================================
+// Private Functions
+//=============================================================================
+private:
+  arena(const arena&);
+  void operator=(const arena&);
+
+//----------------------------------------------------------------------------
+/** Allocates a block of at least 'bytes' bytes and makes it the current one
+    @param bytes The size of the block
+*/
+  void add_block(unsigned long bytes);
+
+//=============================================================================
+// arena Data Members
+//=============================================================================
+  struct block {
+    char* raw;               // as returned by malloc
+    char* begin;             // aligned to ALIGNMENT
+    unsigned long size;
+  };
+  std::vector<block> _blocks;
+  unsigned long _block;      // the current block
+  char* _next;               // its first free byte
+  char* _end;
+  unsigned long _block_size;
+  unsigned long _used;
+  std::atomic<unsigned long> _live;
+};
+};
+#endif
+//*****************************************************************************
+//                                     E O F
+//*****************************************************************************
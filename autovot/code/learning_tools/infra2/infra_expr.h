@@ -0,0 +1,339 @@
+//=============================================================================
+// File Name: infra_expr.h
+// Written by: the Autovot contributors
+// Date: 19 Oct., 2026
+//
+// Distributed as part of the infra C++ library for linear algebra
+// Copyright (C) 2026 the Autovot contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//=============================================================================
+#ifndef _INFRA_EXPR_H_
+#define _INFRA_EXPR_H_
+
+//*****************************************************************************
+/** Expression templates for the coordinate-wise operators of vectors. 
+    u + v, u - v, u * s, s * u, u / s, s / u, u + s, s + u, u - s and 
+    s - u no longer compute a new vector: they return a small object that 
+    remembers the operands, and the elements are computed only where the 
+    expression is used, in a single loop. For example
+
+      w += (u - v) * tau;
+
+    makes one pass over w, u and v and allocates nothing, where it used to
+    allocate and fill two temporary vectors. An expression is used by:
+    - assignment to a vector or a vector_view, and operators += and -=,
+    - the dot product operator * with another expression or vector, and
+      sum() and norm2(),
+    - anywhere a vector is expected, into which it converts, e.g. a function
+      taking a const vector_base& or "infra::vector d = u - v;".
+
+    An expression refers to its operands, so it must be used within the 
+    statement that builds it: do not keep one in an 'auto' variable. The
+    destination of an assignment may be one of the operands ("w = w * 2")
+    but if it overlaps an operand in any other way the expression is first
+    computed into a temporary vector, as it was before.
+
+    The dot products and norm2() of expressions add the products in the 
+    order of infra::simd::dot() (see infra_simd.h), so w * (u - v) equals 
+    w * d for d = u - v to the last bit. sum() adds the elements in order, 
+    as vector_base::sum() does.
+*/
+namespace infra {
+
+//=============================================================================
+// forward declarations
+//=============================================================================
+class vector_base;
+class vector;
+
+//-----------------------------------------------------------------------------
+/** The base of all vector expressions, and of vector_base. E is the class
+    of the expression itself.
+*/
+template <class E>
+class vector_expr
+{
+public:
+//-----------------------------------------------------------------------------
+/** Returns the expression as its own class
+    @return A reference to this expression
+*/
+  inline const E& self() const;
+};
+
+//-----------------------------------------------------------------------------
+/** How a vector_base is read within an expression: its elements, without 
+    counting a reference to its memory.
+*/
+class vector_ref
+{
+public:
+//-----------------------------------------------------------------------------
+/** Constructs a reference to the elements of a vector_base
+    @param v A constant reference to the vector_base
+*/
+  inline vector_ref(const vector_base& v);
+
+//-----------------------------------------------------------------------------
+/** Returns the number of elements
+    @return The size of the vector
+*/
+  inline unsigned long size() const;
+
+//-----------------------------------------------------------------------------
+/** Returns an element
+    @param i The index of the element
+    @return The value of the element
+*/
+  inline double operator[] (unsigned long i) const;
+
+//-----------------------------------------------------------------------------
+/** Checks if assigning the expression to a vector would overwrite elements
+    before they are read: if the vector shares memory with this one other
+    than element for element.
+    @param data A pointer to the first element of the vector
+    @param step The step of the vector
+    @param size The size of the vector
+    @return 'true' if the expression must be computed into a temporary
+*/
+  inline bool aliases(const double* data, unsigned long step, 
+                      unsigned long size) const;
+
+private:
+  const double* _data;
+  unsigned long _step;
+  unsigned long _size;
+};
+
+//-----------------------------------------------------------------------------
+/** The class an operand of class E is kept as in an expression: a 
+    vector_ref for a vector_base, a copy for an expression.
+*/
+template <class E>
+struct expr_operand { typedef E type; };
+
+template <>
+struct expr_operand<vector_base> { typedef vector_ref type; };
+
+//-----------------------------------------------------------------------------
+/** The coordinate-wise operations
+*/
+struct expr_add { static inline double apply(double a, double b); };
+struct expr_sub { static inline double apply(double a, double b); };
+struct expr_mul { static inline double apply(double a, double b); };
+struct expr_div { static inline double apply(double a, double b); };
+
+//-----------------------------------------------------------------------------
+/** The base of the expressions built by the operators: besides being used 
+    as a vector_expr, an expression can be reduced or converted to a vector.
+*/
+template <class E>
+class vector_node : public vector_expr<E>
+{
+public:
+//-----------------------------------------------------------------------------
+/** Computes the expression into a new vector
+    @return The vector
+*/
+  inline operator vector() const;
+
+//-----------------------------------------------------------------------------
+/** Returns the sum of the elements, added in order
+    @return The sum
+*/
+  inline double sum() const;
+
+//-----------------------------------------------------------------------------
+/** Returns the sum of the squares of the elements, in the order of
+    infra::simd::dot()
+    @return The squared l2 norm
+*/
+  inline double norm2() const;
+};
+
+//-----------------------------------------------------------------------------
+/** u op v, coordinate-wise
+*/
+template <class L, class R, class Op>
+class vector_binary_expr : public vector_node< vector_binary_expr<L,R,Op> >
+{
+public:
+  inline vector_binary_expr(const L& u, const R& v);
+  inline unsigned long size() const;
+  inline double operator[] (unsigned long i) const;
+  inline bool aliases(const double* data, unsigned long step, 
+                      unsigned long size) const;
+private:
+  typename expr_operand<L>::type _u;
+  typename expr_operand<R>::type _v;
+};
+
+//-----------------------------------------------------------------------------
+/** u op s, for each element of u
+*/
+template <class L, class Op>
+class vector_scalar_expr : public vector_node< vector_scalar_expr<L,Op> >
+{
+public:
+  inline vector_scalar_expr(const L& u, double s);
+  inline unsigned long size() const;
+  inline double operator[] (unsigned long i) const;
+  inline bool aliases(const double* data, unsigned long step, 
+                      unsigned long size) const;
+private:
+  typename expr_operand<L>::type _u;
+  double _s;
+};
+
+//-----------------------------------------------------------------------------
+/** s op u, for each element of u
+*/
+template <class R, class Op>
+class scalar_vector_expr : public vector_node< scalar_vector_expr<R,Op> >
+{
+public:
+  inline scalar_vector_expr(double s, const R& u);
+  inline unsigned long size() const;
+  inline double operator[] (unsigned long i) const;
+  inline bool aliases(const double* data, unsigned long step, 
+                      unsigned long size) const;
+private:
+  double _s;
+  typename expr_operand<R>::type _u;
+};
+
+//-----------------------------------------------------------------------------
+/** The dot product of two expressions, in the order of infra::simd::dot()
+    @param u The first expression, as kept by expr_operand
+    @param v The second expression, as kept by expr_operand
+    @return The sum of u[i]*v[i]
+*/
+template <class U, class V>
+inline double expr_dot(const U& u, const V& v);
+
+//-----------------------------------------------------------------------------
+/** Compares two expressions element by element
+    @param u The first expression, as kept by expr_operand
+    @param v The second expression, as kept by expr_operand
+    @return 'true' if all elements are equal
+*/
+template <class U, class V>
+inline bool expr_equal(const U& u, const V& v);
+
+//-----------------------------------------------------------------------------
+/** Operator + for vector-vector addition
+    @param u A constant reference to a vector or an expression
+    @param v A constant reference to a vector or an expression
+    @return The sum, as an expression
+*/
+template <class L, class R>
+inline vector_binary_expr<L,R,expr_add> operator+(const vector_expr<L>& u,
+                                                  const vector_expr<R>& v);
+
+//-----------------------------------------------------------------------------
+/** Operator - for vector-vector subtraction
+    @param u A constant reference to a vector or an expression
+    @param v A constant reference to a vector or an expression
+    @return The difference, as an expression
+*/
+template <class L, class R>
+inline vector_binary_expr<L,R,expr_sub> operator-(const vector_expr<L>& u,
+                                                  const vector_expr<R>& v);
+
+//-----------------------------------------------------------------------------
+/** Operator * for the dot product of vectors and expressions. The product
+    of two vectors is the non-template operator * of infra_vv_funcs.h. A
+    vector and an expression have overloads of their own, which take the 
+    vector as that operator does: otherwise it would be as good a match,
+    by converting the expression to a vector, and the call ambiguous.
+    @param u A constant reference to a vector or an expression
+    @param v A constant reference to a vector or an expression
+    @return The dot product
+*/
+template <class L, class R>
+inline double operator*(const vector_expr<L>& u, const vector_expr<R>& v);
+template <class R>
+inline double operator*(const vector_base& u, const vector_expr<R>& v);
+template <class L>
+inline double operator*(const vector_expr<L>& u, const vector_base& v);
+
+//-----------------------------------------------------------------------------
+/** Operators == and != of expressions, compared element by element. Two 
+    vectors are compared by vector_base::operator == and !=, and a vector
+    and an expression by overloads taking the vector as those do, as for
+    operator *.
+    @param u A constant reference to a vector or an expression
+    @param v A constant reference to a vector or an expression
+    @return 'true' if all elements are equal (==) or if any differs (!=)
+*/
+template <class L, class R>
+inline bool operator==(const vector_expr<L>& u, const vector_expr<R>& v);
+template <class R>
+inline bool operator==(const vector_base& u, const vector_expr<R>& v);
+template <class L>
+inline bool operator==(const vector_expr<L>& u, const vector_base& v);
+template <class L, class R>
+inline bool operator!=(const vector_expr<L>& u, const vector_expr<R>& v);
+template <class R>
+inline bool operator!=(const vector_base& u, const vector_expr<R>& v);
+template <class L>
+inline bool operator!=(const vector_expr<L>& u, const vector_base& v);
+
+//-----------------------------------------------------------------------------
+/** Operators +, -, * and / of a vector or an expression and a scalar, 
+    coordinate-wise.
+    @param u A constant reference to a vector or an expression
+    @param s A scalar
+    @return The outcome, as an expression
+*/
+template <class L>
+inline vector_scalar_expr<L,expr_add> operator+(const vector_expr<L>& u,
+                                                const double& s);
+template <class L>
+inline vector_scalar_expr<L,expr_sub> operator-(const vector_expr<L>& u,
+                                                const double& s);
+template <class L>
+inline vector_scalar_expr<L,expr_mul> operator*(const vector_expr<L>& u,
+                                                const double& s);
+template <class L>
+inline vector_scalar_expr<L,expr_div> operator/(const vector_expr<L>& u,
+                                                const double& s);
+
+//-----------------------------------------------------------------------------
+/** Operators +, -, * and / of a scalar and a vector or an expression, 
+    coordinate-wise.
+    @param s A scalar
+    @param u A constant reference to a vector or an expression
+    @return The outcome, as an expression
+*/
+template <class R>
+inline scalar_vector_expr<R,expr_add> operator+(const double& s,
+                                                const vector_expr<R>& u);
+template <class R>
+inline scalar_vector_expr<R,expr_sub> operator-(const double& s,
+                                                const vector_expr<R>& u);
+template <class R>
+inline scalar_vector_expr<R,expr_mul> operator*(const double& s,
+                                                const vector_expr<R>& u);
+template <class R>
+inline scalar_vector_expr<R,expr_div> operator/(const double& s,
+                                                const vector_expr<R>& u);
+};
+#endif
+//*****************************************************************************
+//                                     E O F
+//*****************************************************************************
@@ -28,6 +28,7 @@
 //*****************************************************************************
 #include <stdio.h>
 #include <iostream>
+#include <utility>
 #include "infra_refcount_darray.h"
 #include "infra_vector.h"
 
@@ -54,6 +55,13 @@ class matrix_base
 */
   inline matrix_base(const matrix_base& other);
 
+//-----------------------------------------------------------------------------
+/** Move constructor. Takes over the reference to the memory of the other 
+    matrix_base, which is left empty. Does not allocate any new memory.
+    @param other A reference to the matrix_base being moved
+*/
+  inline matrix_base(matrix_base&& other);
+
 //-----------------------------------------------------------------------------
 /** Standard Destructor. 
 */
@@ -396,7 +404,7 @@ protected:
                      double* data, infra::refcount_darray memory, 
                      unsigned long allocated_height, 
                      unsigned long allocated_width) :
-    _height(height), _width(width), _data(data), _memory(memory), 
+    _height(height), _width(width), _data(data), _memory(std::move(memory)), 
     _allocated_height(allocated_height), _allocated_width(allocated_width) {}
 
 //=============================================================================
@@ -621,11 +629,46 @@ class matrix : public matrix_base
 */
   inline matrix(const matrix_base& other);
 
+//-----------------------------------------------------------------------------
+/** Move constructor. Takes over the memory of the other matrix, which is
+    left empty. Does not allocate any new memory.
+    @param other A reference to the matrix being moved
+*/
+  inline matrix(matrix&& other);
+
 //-----------------------------------------------------------------------------
 /** Standard Destructor. 
 */
   inline ~matrix();
 
+//-----------------------------------------------------------------------------
+/** Assignment operator. Assigns the values of the other matrix to this 
+    matrix, as matrix_base::operator = does. Both matrices must have equal
+    dimensions.
+    @param other The matrix being assigned
+    @return A reference to this matrix
+*/
+  inline matrix_base& operator = (const matrix& other);
+
+//-----------------------------------------------------------------------------
+/** Assignment operator. Assigns the values of the other matrix_base to this 
+    matrix, without making a temporary copy of it. Both matrices must have
+    equal dimensions.
+    @param other The matrix_base being assigned
+    @return A reference to this matrix
+*/
+  inline matrix_base& operator = (const matrix_base& other);
+
+//-----------------------------------------------------------------------------
+/** Move assignment operator. Both matrices must have equal dimensions. If
+    no view references the memory of either matrix, the memory of the two 
+    matrices is swapped instead of copying the values. Otherwise the values 
+    are copied, as in operator = above.
+    @param other The matrix being assigned
+    @return A reference to this matrix
+*/
+  inline matrix_base& operator = (matrix&& other);
+
 //-----------------------------------------------------------------------------
 /** Resizes the matrix by reallocating its memory. The original coordiantes
     that still fit in the new matrix dimensions remain intact. New
@@ -27,6 +27,7 @@
 #include "infra_mm_funcs.h"
 #include "infra_matrix.imp"
 #include "infra_exception.h"
+#include "infra_simd.h"
 
 //.............................................................................
 #ifdef _USE_ATLAS_
@@ -196,12 +197,13 @@ void infra::prod_t(const infra::matrix_base& A, const infra::matrix_base& B,
 #else //_USE_ATLAS_  
 //.............................................................................
 
+  // each element is the dot product of a row of A and a row of B, as
+  // operator* of the two rows computes it
   for(unsigned long i = 0; i < outcome.height(); ++i) {
     for(unsigned long j = 0; j < outcome.width(); ++j) {
-      outcome(i,j) = 0.0;
-      for(unsigned long k = 0; k < A.width(); ++k) {
-	outcome(i,j) += A(i,k) * B(j,k);
-      }
+      outcome(i,j) = infra::simd::dot(A.begin().ptr() + i, A.allocated_height(),
+                                      B.begin().ptr() + j, B.allocated_height(),
+                                      A.width());
     }
   }
 
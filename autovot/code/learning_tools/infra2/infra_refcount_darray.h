@@ -23,17 +23,37 @@
 #ifndef _INFRA_REFCOUNT_DARRAY_H
 #define _INFRA_REFCOUNT_DARRAY_H
 
+#ifdef _INFRA_ATOMIC_REFCOUNT_
+#include <atomic>
+#endif
+#include "infra_arena.h"
+
 //*****************************************************************************
 /** Implements an array of doubles with reference counting.
     @author Ofer Dekel (oferd@cs.huji.ac.il)
 */
 namespace infra{
+//----------------------------------------------------------------------------
+/** The type of the reference count. When _INFRA_ATOMIC_REFCOUNT_ is defined
+    the count is atomic, and copies of the same refcount_darray may be made
+    and destroyed concurrently by different threads.
+*/
+#ifdef _INFRA_ATOMIC_REFCOUNT_
+typedef std::atomic<unsigned int> refcount_t;
+#else
+typedef unsigned int refcount_t;
+#endif
+
 //----------------------------------------------------------------------------
 /** This class holds an array of doubles, and maintains a reference count
     for the datastructure. That is, all copies of the refcount_darray point
     to the same allocated memory - changing one will change them all. The data
     is kept in memory as long as someone is referencing it. It is deallocated
     automatically when the last reference to it dies. 
+    An array of size 0 allocates nothing, and neither does a default
+    constructed refcount_darray, which owns no memory and is not counted.
+    When an arena is installed on the calling thread (see infra_arena.h),
+    the array and its counter are taken from the arena instead of the heap.
 */ 
 class refcount_darray
 {
@@ -42,11 +62,18 @@ class refcount_darray
 //=============================================================================
 public:
 //----------------------------------------------------------------------------
-/** Constructs a reference counting array of doubles. Allocates new memory.
+/** Constructs a reference counting array of doubles. Allocates new memory,
+    from the arena installed on the calling thread if there is one.
     @param size The array size
 */
   explicit inline refcount_darray(unsigned long size);
 
+//----------------------------------------------------------------------------
+/** Constructs an empty refcount_darray which owns no memory. Does not 
+    allocate anything.
+*/
+  inline refcount_darray();
+
 //----------------------------------------------------------------------------
 /** Destructor. Reduces the reference count by 1. If the count reaches 0, the
     allocated memory is released.
@@ -60,6 +87,13 @@ public:
 */
   inline refcount_darray(const refcount_darray& r);
 
+//----------------------------------------------------------------------------
+/** Move constructor - takes the memory and the counter of the other 
+    refcount_darray, which is left empty. The reference count is unchanged.
+    @param r A reference to the other refcount_darray being moved
+*/
+  inline refcount_darray(refcount_darray&& r);
+
 //----------------------------------------------------------------------------
 /** Swaps the memory and the counter between two refcount_darrays
     @param r A reference to the other refcount_darray 
@@ -73,6 +107,19 @@ public:
 */
   inline double* ptr() const;
 
+//----------------------------------------------------------------------------
+/** Returns true if no other refcount_darray references this memory (or if
+    this refcount_darray owns no memory)
+    @return 'true' if this is the only reference
+*/
+  inline bool unique() const;
+
+//----------------------------------------------------------------------------
+/** Returns the arena the memory was taken from
+    @return The arena, or NULL if the memory is on the heap or not owned
+*/
+  inline arena* owner() const;
+
 //=============================================================================
 // Private Functions
 //=============================================================================  
@@ -88,7 +135,8 @@ private:
 // refcount_darray Data Members
 //=============================================================================
     double* _ptr;
-    unsigned int* _count;
+    refcount_t* _count;
+    arena* _arena;
 };
 };
 #endif
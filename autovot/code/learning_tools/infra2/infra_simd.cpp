@@ -0,0 +1,359 @@
+//=============================================================================
+// File Name: infra_simd.cpp
+// Written by: the Autovot contributors
+// Date: 19 Oct., 2026
+//
+// Distributed as part of the infra C++ library for linear algebra
+// Copyright (C) 2026 the Autovot contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//=============================================================================
+
+//*****************************************************************************
+// Included Files
+//*****************************************************************************
+#include "infra_simd.h"
+#include <stdlib.h>
+#include <string.h>
+
+//.............................................................................
+// The SSE2, AVX2 and AVX-512 kernels are compiled with the target attribute
+// of gcc and clang, so the rest of the library keeps the default flags. The
+// library is built with -ffp-contract=off: a multiply followed by an add is
+// never fused, which would change the results between levels.
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define _INFRA_SIMD_X86_
+#include <immintrin.h>
+#endif
+//.............................................................................
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// the partial sums of dot() are added as ((s0+s4)+(s2+s6))+((s1+s5)+(s3+s7)),
+// which is how the lanes of the registers are folded below
+inline double fold(const double* s) {
+  double t0 = s[0] + s[4];
+  double t1 = s[1] + s[5];
+  double t2 = s[2] + s[6];
+  double t3 = s[3] + s[7];
+  return (t0 + t2) + (t1 + t3);
+}
+
+//-----------------------------------------------------------------------------
+// the products of the last n%8 elements, added in order
+inline double dot_tail(double sum, const double* u, unsigned long u_step,
+                       const double* v, unsigned long v_step,
+                       unsigned long i, unsigned long n) {
+  for (; i < n; ++i) {
+    double p = u[i * u_step] * v[i * v_step];
+    sum += p;
+  }
+  return sum;
+}
+
+//-----------------------------------------------------------------------------
+double dot_portable(const double* u, unsigned long u_step,
+                    const double* v, unsigned long v_step, unsigned long n) {
+  double s[8] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  unsigned long i = 0;
+  for (; i + 8 <= n; i += 8) {
+    for (int k = 0; k < 8; ++k) {
+      double p = u[(i + k) * u_step] * v[(i + k) * v_step];
+      s[k] += p;
+    }
+  }
+  return dot_tail(fold(s), u, u_step, v, v_step, i, n);
+}
+
+//-----------------------------------------------------------------------------
+void axpy_portable(double a, const double* x, unsigned long x_step,
+                   double* y, unsigned long y_step, unsigned long n) {
+  for (unsigned long i = 0; i < n; ++i) {
+    double p = a * x[i * x_step];
+    y[i * y_step] += p;
+  }
+}
+
+#ifdef _INFRA_SIMD_X86_
+//-----------------------------------------------------------------------------
+// SSE2: the 8 partial sums are in four registers, two per register
+__attribute__((target("sse2")))
+inline __m128d load2(const double* p, unsigned long step) {
+  if (step == 1) return _mm_loadu_pd(p);
+  return _mm_loadh_pd(_mm_load_sd(p), p + step);
+}
+
+__attribute__((target("sse2")))
+inline void store2(double* p, unsigned long step, __m128d x) {
+  if (step == 1) {
+    _mm_storeu_pd(p, x);
+  } else {
+    _mm_storel_pd(p, x);
+    _mm_storeh_pd(p + step, x);
+  }
+}
+
+__attribute__((target("sse2")))
+double dot_sse2(const double* u, unsigned long u_step,
+                const double* v, unsigned long v_step, unsigned long n) {
+  __m128d a0 = _mm_setzero_pd();
+  __m128d a1 = _mm_setzero_pd();
+  __m128d a2 = _mm_setzero_pd();
+  __m128d a3 = _mm_setzero_pd();
+  unsigned long i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const double* pu = u + i * u_step;
+    const double* pv = v + i * v_step;
+    a0 = _mm_add_pd(a0, _mm_mul_pd(load2(pu, u_step), load2(pv, v_step)));
+    a1 = _mm_add_pd(a1, _mm_mul_pd(load2(pu + 2 * u_step, u_step),
+                                   load2(pv + 2 * v_step, v_step)));
+    a2 = _mm_add_pd(a2, _mm_mul_pd(load2(pu + 4 * u_step, u_step),
+                                   load2(pv + 4 * v_step, v_step)));
+    a3 = _mm_add_pd(a3, _mm_mul_pd(load2(pu + 6 * u_step, u_step),
+                                   load2(pv + 6 * v_step, v_step)));
+  }
+  double s[8];
+  _mm_storeu_pd(s, a0);
+  _mm_storeu_pd(s + 2, a1);
+  _mm_storeu_pd(s + 4, a2);
+  _mm_storeu_pd(s + 6, a3);
+  return dot_tail(fold(s), u, u_step, v, v_step, i, n);
+}
+
+__attribute__((target("sse2")))
+void axpy_sse2(double a, const double* x, unsigned long x_step,
+               double* y, unsigned long y_step, unsigned long n) {
+  __m128d va = _mm_set1_pd(a);
+  unsigned long i = 0;
+  for (; i + 2 <= n; i += 2) {
+    double* py = y + i * y_step;
+    __m128d p = _mm_mul_pd(va, load2(x + i * x_step, x_step));
+    store2(py, y_step, _mm_add_pd(load2(py, y_step), p));
+  }
+  axpy_portable(a, x + i * x_step, x_step, y + i * y_step, y_step, n - i);
+}
+
+//-----------------------------------------------------------------------------
+// AVX2: the 8 partial sums are in two registers, four per register. A
+// strided vector is read with a gather, and written element by element.
+__attribute__((target("avx2")))
+inline __m256d load4(const double* p, unsigned long step) {
+  if (step == 1) return _mm256_loadu_pd(p);
+  __m256i index = _mm256_set_epi64x(3 * step, 2 * step, step, 0);
+  return _mm256_i64gather_pd(p, index, 8);
+}
+
+__attribute__((target("avx2")))
+inline void store4(double* p, unsigned long step, __m256d x) {
+  if (step == 1) {
+    _mm256_storeu_pd(p, x);
+  } else {
+    __m128d lo = _mm256_castpd256_pd128(x);
+    __m128d hi = _mm256_extractf128_pd(x, 1);
+    _mm_storel_pd(p, lo);
+    _mm_storeh_pd(p + step, lo);
+    _mm_storel_pd(p + 2 * step, hi);
+    _mm_storeh_pd(p + 3 * step, hi);
+  }
+}
+
+__attribute__((target("avx2")))
+double dot_avx2(const double* u, unsigned long u_step,
+                const double* v, unsigned long v_step, unsigned long n) {
+  __m256d a0 = _mm256_setzero_pd();
+  __m256d a1 = _mm256_setzero_pd();
+  unsigned long i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const double* pu = u + i * u_step;
+    const double* pv = v + i * v_step;
+    a0 = _mm256_add_pd(a0, _mm256_mul_pd(load4(pu, u_step),
+                                         load4(pv, v_step)));
+    a1 = _mm256_add_pd(a1, _mm256_mul_pd(load4(pu + 4 * u_step, u_step),
+                                         load4(pv + 4 * v_step, v_step)));
+  }
+  double s[8];
+  _mm256_storeu_pd(s, a0);
+  _mm256_storeu_pd(s + 4, a1);
+  return dot_tail(fold(s), u, u_step, v, v_step, i, n);
+}
+
+__attribute__((target("avx2")))
+void axpy_avx2(double a, const double* x, unsigned long x_step,
+               double* y, unsigned long y_step, unsigned long n) {
+  __m256d va = _mm256_set1_pd(a);
+  unsigned long i = 0;
+  for (; i + 4 <= n; i += 4) {
+    double* py = y + i * y_step;
+    __m256d p = _mm256_mul_pd(va, load4(x + i * x_step, x_step));
+    store4(py, y_step, _mm256_add_pd(load4(py, y_step), p));
+  }
+  axpy_portable(a, x + i * x_step, x_step, y + i * y_step, y_step, n - i);
+}
+
+//-----------------------------------------------------------------------------
+// AVX-512: the 8 partial sums are the lanes of one register. A strided
+// vector is read with a gather and written with a scatter.
+__attribute__((target("avx512f")))
+inline __m512d load8(const double* p, unsigned long step) {
+  if (step == 1) return _mm512_loadu_pd(p);
+  __m512i index = _mm512_set_epi64(7 * step, 6 * step, 5 * step, 4 * step,
+                                   3 * step, 2 * step, step, 0);
+  return _mm512_i64gather_pd(index, p, 8);
+}
+
+__attribute__((target("avx512f")))
+inline void store8(double* p, unsigned long step, __m512d x) {
+  if (step == 1) {
+    _mm512_storeu_pd(p, x);
+  } else {
+    __m512i index = _mm512_set_epi64(7 * step, 6 * step, 5 * step, 4 * step,
+                                     3 * step, 2 * step, step, 0);
+    _mm512_i64scatter_pd(p, index, x, 8);
+  }
+}
+
+__attribute__((target("avx512f")))
+double dot_avx512(const double* u, unsigned long u_step,
+                  const double* v, unsigned long v_step, unsigned long n) {
+  __m512d a = _mm512_setzero_pd();
+  unsigned long i = 0;
+  for (; i + 8 <= n; i += 8)
+    a = _mm512_add_pd(a, _mm512_mul_pd(load8(u + i * u_step, u_step),
+                                       load8(v + i * v_step, v_step)));
+  double s[8];
+  _mm512_storeu_pd(s, a);
+  return dot_tail(fold(s), u, u_step, v, v_step, i, n);
+}
+
+__attribute__((target("avx512f")))
+void axpy_avx512(double a, const double* x, unsigned long x_step,
+                 double* y, unsigned long y_step, unsigned long n) {
+  __m512d va = _mm512_set1_pd(a);
+  unsigned long i = 0;
+  for (; i + 8 <= n; i += 8) {
+    double* py = y + i * y_step;
+    __m512d p = _mm512_mul_pd(va, load8(x + i * x_step, x_step));
+    store8(py, y_step, _mm512_add_pd(load8(py, y_step), p));
+  }
+  axpy_portable(a, x + i * x_step, x_step, y + i * y_step, y_step, n - i);
+}
+#endif //_INFRA_SIMD_X86_
+
+//-----------------------------------------------------------------------------
+// the kernels of the level in use
+typedef double (*dot_t)(const double*, unsigned long, const double*,
+                        unsigned long, unsigned long);
+typedef void (*axpy_t)(double, const double*, unsigned long, double*,
+                       unsigned long, unsigned long);
+
+struct kernels {
+  infra::simd::level_t level;
+  dot_t dot;
+  axpy_t axpy;
+};
+
+//-----------------------------------------------------------------------------
+infra::simd::level_t supported_level() {
+#ifdef _INFRA_SIMD_X86_
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return infra::simd::AVX512;
+  if (__builtin_cpu_supports("avx2")) return infra::simd::AVX2;
+  if (__builtin_cpu_supports("sse2")) return infra::simd::SSE2;
+#endif
+  return infra::simd::PORTABLE;
+}
+
+//-----------------------------------------------------------------------------
+kernels make_kernels(infra::simd::level_t l) {
+  kernels k;
+  if (l > supported_level()) l = supported_level();
+  k.level = l;
+  k.dot = dot_portable;
+  k.axpy = axpy_portable;
+#ifdef _INFRA_SIMD_X86_
+  if (l == infra::simd::SSE2) {
+    k.dot = dot_sse2;
+    k.axpy = axpy_sse2;
+  } else if (l == infra::simd::AVX2) {
+    k.dot = dot_avx2;
+    k.axpy = axpy_avx2;
+  } else if (l == infra::simd::AVX512) {
+    k.dot = dot_avx512;
+    k.axpy = axpy_avx512;
+  }
+#endif
+  return k;
+}
+
+//-----------------------------------------------------------------------------
+// the highest supported level, or the one named by INFRA_SIMD
+kernels initial_kernels() {
+  const char* name = getenv("INFRA_SIMD");
+  for (int l = infra::simd::PORTABLE; name && l <= infra::simd::AVX512; ++l)
+    if (strcmp(name, infra::simd::level_name(infra::simd::level_t(l))) == 0)
+      return make_kernels(infra::simd::level_t(l));
+  return make_kernels(infra::simd::AVX512);
+}
+
+//-----------------------------------------------------------------------------
+// chosen before the first kernel call (the initialization of a static is
+// thread safe)
+kernels& current() {
+  static kernels k = initial_kernels();
+  return k;
+}
+
+};
+
+//-----------------------------------------------------------------------------
+infra::simd::level_t infra::simd::level() {
+  return current().level;
+}
+
+//-----------------------------------------------------------------------------
+infra::simd::level_t infra::simd::set_level(infra::simd::level_t l) {
+  current() = make_kernels(l);
+  return current().level;
+}
+
+//-----------------------------------------------------------------------------
+const char* infra::simd::level_name(infra::simd::level_t l) {
+  switch (l) {
+  case SSE2: return "sse2";
+  case AVX2: return "avx2";
+  case AVX512: return "avx512";
+  default: return "portable";
+  }
+}
+
+//-----------------------------------------------------------------------------
+double infra::simd::dot(const double* u, unsigned long u_step,
+                        const double* v, unsigned long v_step,
+                        unsigned long n) {
+  return current().dot(u, u_step, v, v_step, n);
+}
+
+//-----------------------------------------------------------------------------
+void infra::simd::axpy(double a, const double* x, unsigned long x_step,
+                       double* y, unsigned long y_step, unsigned long n) {
+  current().axpy(a, x, x_step, y, y_step, n);
+}
+
+//*****************************************************************************
+//                                     E O F
+//*****************************************************************************
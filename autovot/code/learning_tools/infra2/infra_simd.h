@@ -0,0 +1,107 @@
+//=============================================================================
+// File Name: infra_simd.h
+// Written by: the Autovot contributors
+// Date: 19 Oct., 2026
+//
+// Distributed as part of the infra C++ library for linear algebra
+// Copyright (C) 2026 the Autovot contributors
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//=============================================================================
+#ifndef _INFRA_SIMD_H_
+#define _INFRA_SIMD_H_
+
+//*****************************************************************************
+/** The dot product and axpy kernels behind the vector operations when
+    _USE_ATLAS_ is not defined. Each kernel has an SSE2, an AVX2 and an
+    AVX-512 version, and one of them is chosen at run time according to the
+    CPU (or to the INFRA_SIMD environment variable, see level()). All
+    kernels take a step, the number of elements between consecutive
+    elements of a vector, so that matrix rows are handled as well.
+
+    Reproducibility: the dot product is accumulated in 8 partial sums,
+    element i going to sum i%8, which are added pairwise and then to the
+    products of the last n%8 elements in order. Every level, including the
+    portable one, follows this order without fused multiply-adds, so the
+    result is the same on every CPU. It differs from the sequential sum
+    u[0]*v[0] + u[1]*v[1] + ... by at most n * 2^-52 * sum |u[i]*v[i]|.
+    axpy is computed element by element and is exact with respect to the
+    sequential loop.
+*/
+namespace infra {
+namespace simd {
+
+//-----------------------------------------------------------------------------
+/** The instruction sets the kernels can be built for
+*/
+enum level_t { PORTABLE = 0, SSE2 = 1, AVX2 = 2, AVX512 = 3 };
+
+//-----------------------------------------------------------------------------
+/** Returns the level used by the kernels. It is the highest level supported
+    by the CPU, unless the environment variable INFRA_SIMD is set to a lower
+    one ("portable", "sse2", "avx2" or "avx512").
+    @return The level in use
+*/
+level_t level();
+
+//-----------------------------------------------------------------------------
+/** Selects the level used by the kernels, e.g. to compare their speed. A
+    level the CPU does not support is lowered to the highest one it does.
+    Must not be called while other threads use the kernels.
+    @param l The requested level
+    @return The level now in use
+*/
+level_t set_level(level_t l);
+
+//-----------------------------------------------------------------------------
+/** Returns the name of a level, as accepted by INFRA_SIMD
+    @param l The level
+    @return The name of the level
+*/
+const char* level_name(level_t l);
+
+//-----------------------------------------------------------------------------
+/** Dot product of two vectors of n elements
+    @param u A pointer to the first element of u
+    @param u_step The number of elements between consecutive elements of u
+    @param v A pointer to the first element of v
+    @param v_step The number of elements between consecutive elements of v
+    @param n The number of elements
+    @return The sum of u[i]*v[i], in the order described above
+*/
+double dot(const double* u, unsigned long u_step,
+           const double* v, unsigned long v_step, unsigned long n);
+
+//-----------------------------------------------------------------------------
+/** Adds a times x to y: y[i] += a*x[i]. With a = 1 or a = -1 the result
+    equals y[i] + x[i] or y[i] - x[i] exactly.
+    @param a The scalar
+    @param x A pointer to the first element of x
+    @param x_step The number of elements between consecutive elements of x
+    @param y A pointer to the first element of y
+    @param y_step The number of elements between consecutive elements of y
+    @param n The number of elements
+*/
+void axpy(double a, const double* x, unsigned long x_step,
+          double* y, unsigned long y_step, unsigned long n);
+
+};
+};
+
+#endif
+//*****************************************************************************
+//                                     E O F
+//*****************************************************************************
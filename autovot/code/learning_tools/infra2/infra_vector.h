@@ -28,7 +28,9 @@
 //*****************************************************************************
 #include <iostream>
 #include <stdio.h>
+#include <utility>
 #include "infra_refcount_darray.h"
+#include "infra_expr.h"
 
 typedef unsigned int uint;
 
@@ -43,13 +45,15 @@ class matrix_base;
     should not be used directly, instead use infra::vector or
     infra::vector_view.
     @author Ofer Dekel (oferd@cs.huji.ac.il)
+    A vector_base is also a vector_expr, see infra_expr.h.
 */
-class vector_base {
+class vector_base : public vector_expr<vector_base> {
  public:
 //=============================================================================
 // friend declaration and forward declarations
 //=============================================================================
   friend class matrix_base;
+  friend class vector_ref;
   class const_iterator;
   class iterator;
 
@@ -65,11 +69,48 @@ class vector_base {
 */
   inline vector_base(const vector_base& other);
 
+//-----------------------------------------------------------------------------
+/** Move constructor. Takes over the reference to the memory of the other 
+    vector, which is left empty. Does not allocate any new memory and does
+    not change the reference count.
+    @param other A reference to the vector_base being moved
+*/
+  inline vector_base(vector_base&& other);
+
 //-----------------------------------------------------------------------------
 /** Standard Destructor. 
 */
   inline ~vector_base();
 
+//-----------------------------------------------------------------------------
+/** Returns a vector_base which views memory that is not managed by infra,
+    such as a std::vector or a C array. The view never allocates and does
+    not hold a reference count, so it may be created and destroyed by 
+    several threads at once. The memory must outlive the view. A view of
+    the memory of an infra::vector is not known to that vector: it must
+    not be resized or move-assigned while the view is used.
+    @param data A pointer to the first element
+    @param size The number of elements in the view
+    @param step The number of elements between consecutive elements of the 
+           view (default = 1)
+    @return A vector_base viewing the memory
+*/
+  static inline vector_base external(double* data, unsigned long size,
+                                     unsigned long step=1);
+
+//-----------------------------------------------------------------------------
+/** Returns a constant vector_base which views memory that is not managed
+    by infra. See external() above.
+    @param data A pointer to the first element
+    @param size The number of elements in the view
+    @param step The number of elements between consecutive elements of the 
+           view (default = 1)
+    @return A constant vector_base viewing the memory
+*/
+  static inline const vector_base external(const double* data, 
+                                           unsigned long size,
+                                           unsigned long step=1);
+
 //=============================================================================
 // Binary file interface
 //=============================================================================
@@ -108,6 +149,16 @@ class vector_base {
 */
   inline vector_base& copy_neg (const vector_base& other);
 
+//-----------------------------------------------------------------------------
+/** Assigns the values of an expression (see infra_expr.h) to this vector, 
+    computing each element once and without a temporary vector. Both must 
+    be of equal size.
+    @param e The expression being assigned 
+    @return A reference to this vector
+*/
+  template <class E>
+  inline vector_base& operator = (const vector_expr<E>& e);
+
 //=============================================================================
 // access to vector_base parameters
 //=============================================================================
@@ -305,6 +356,23 @@ class vector_base {
 */
   inline vector_base& operator -= (const vector_base& other);
 
+//-----------------------------------------------------------------------------
+/** Adds an expression (see infra_expr.h) to this vector_base, in one pass.
+    @param e The expression to be added this vector_base
+    @return A reference to this vector.
+*/
+  template <class E>
+  inline vector_base& operator += (const vector_expr<E>& e);
+
+//-----------------------------------------------------------------------------
+/** Subtracts an expression (see infra_expr.h) from this vector_base, in one
+    pass.
+    @param e The expression being subtracted from this vector_base
+    @return A reference to this vector.
+*/
+  template <class E>
+  inline vector_base& operator -= (const vector_expr<E>& e);
+
 //-----------------------------------------------------------------------------
 /** Point-wise multiplication of another vector_base with this one.  
     @param other The other vector_base to be multiplied (point-wise) with this
@@ -421,7 +489,7 @@ protected:
 */
   inline vector_base(unsigned long size, double* data, unsigned long step, 
                infra::refcount_darray memory, unsigned long allocated_size) : 
-    _size(size), _data(data), _step(step), _memory(memory), 
+    _size(size), _data(data), _step(step), _memory(std::move(memory)), 
     _allocated_size(allocated_size) {}
 
 //=============================================================================
@@ -602,11 +670,55 @@ class vector : public vector_base {
 */
   inline vector(const vector_base& other);
 
+//-----------------------------------------------------------------------------
+/** Move constructor. Takes over the memory of the other vector, which is
+    left empty. Does not allocate any new memory.
+    @param other A reference to the vector being moved
+*/
+  inline vector(vector&& other);
+
 //-----------------------------------------------------------------------------
 /** Standard Destructor. 
 */
   inline ~vector();
 
+//-----------------------------------------------------------------------------
+/** Assignment operator. Assigns the values of the other vector to this 
+    vector, as vector_base::operator = does. Both vectors must be of equal
+    size.
+    @param other The vector being assigned 
+    @return A reference to this vector
+*/
+  inline vector_base& operator = (const vector& other);
+
+//-----------------------------------------------------------------------------
+/** Assignment operator. Assigns the values of the other vector_base to this 
+    vector, without making a temporary copy of it. Both vectors must be of 
+    equal size.
+    @param other The vector_base being assigned 
+    @return A reference to this vector
+*/
+  inline vector_base& operator = (const vector_base& other);
+
+//-----------------------------------------------------------------------------
+/** Move assignment operator. Both vectors must be of equal size. If no
+    vector_view references the memory of either vector, the memory of the
+    two vectors is swapped instead of copying the values. Otherwise the 
+    values are copied, as in operator = above.
+    @param other The vector being assigned 
+    @return A reference to this vector
+*/
+  inline vector_base& operator = (vector&& other);
+
+//-----------------------------------------------------------------------------
+/** Assigns the values of an expression (see infra_expr.h) to this vector, 
+    as vector_base::operator = does.
+    @param e The expression being assigned 
+    @return A reference to this vector
+*/
+  template <class E>
+  inline vector_base& operator = (const vector_expr<E>& e);
+
 //-----------------------------------------------------------------------------
 /** Swaps the memory and dimensions of this vector with the memory and
     dimensions of another vector.
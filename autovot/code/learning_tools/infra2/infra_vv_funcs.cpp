@@ -27,6 +27,7 @@
 #include "infra_vv_funcs.h"
 #include "infra_vector.imp"
 #include "infra_exception.h"
+#include "infra_simd.h"
 
 //.............................................................................
 #ifdef _USE_ATLAS_
@@ -64,16 +65,8 @@ void infra::prod(const infra::vector_base& u, const infra::vector_base& v,
 #else //_USE_ATLAS_
 //.............................................................................
 
-  infra::vector_base::const_iterator u_iter = u.begin();
-  infra::vector_base::const_iterator u_end = u.end();
-  infra::vector_base::const_iterator v_iter = v.begin();
-  
-  outcome = 0.0;
-  while(u_iter < u_end) {
-    outcome += (*u_iter) * (*v_iter);
-    ++u_iter;
-    ++v_iter;
-  }
+  outcome = infra::simd::dot(u.begin().ptr(), u.step(), v.begin().ptr(), 
+                             v.step(), u.size());
 
 #endif //_USE_ATLAS_
 }
@@ -104,15 +97,8 @@ void infra::add_prod(const infra::vector_base& u, const infra::vector_base& v,
 #else //_USE_ATLAS_
 //.............................................................................
 
-  infra::vector_base::const_iterator u_iter = u.begin();
-  infra::vector_base::const_iterator u_end = u.end();
-  infra::vector_base::const_iterator v_iter = v.begin();
-  
-  while(u_iter < u_end) {
-    outcome += (*u_iter) * (*v_iter);
-    ++u_iter;
-    ++v_iter;
-  }
+  outcome += infra::simd::dot(u.begin().ptr(), u.step(), v.begin().ptr(), 
+                              v.step(), u.size());
 
 #endif //_USE_ATLAS_
 }
@@ -140,16 +126,6 @@ void infra::sum(const infra::vector_base& u, const infra::vector_base& v,
   }
 }
 
-//-----------------------------------------------------------------------------
-infra::vector_base infra::operator+(const infra::vector_base& u, 
-                                    const infra::vector_base& v) {
-
-  // call the prod function 
-  infra::vector outcome(u.size());
-  sum(u, v, outcome);
-  return outcome;
-}
-
 //-----------------------------------------------------------------------------
 void infra::diff(const infra::vector_base& u, const infra::vector_base& v,
 		 infra::vector_base& outcome) {
@@ -173,16 +149,6 @@ void infra::diff(const infra::vector_base& u, const infra::vector_base& v,
   }
 }
 
-//-----------------------------------------------------------------------------
-infra::vector_base infra::operator-(const infra::vector_base& u, 
-                                    const infra::vector_base& v) {
-
-  // call the prod function 
-  infra::vector outcome(u.size());
-  diff(u, v, outcome);
-  return outcome;
-}
-
 //-----------------------------------------------------------------------------
 void infra::coordwise_mult(const infra::vector_base& u, 
                            const infra::vector_base& v,
@@ -266,91 +232,6 @@ double infra::dist2(const infra::vector_base& u, const infra::vector_base& v) {
   return outcome;
 }
 
-//-----------------------------------------------------------------------------
-infra::vector_base infra::operator+(const infra::vector_base& u, 
-                                    const double& s) {
-  infra::vector new_vector(u);
-  new_vector += s;
-  return new_vector;
-}
-
-//-----------------------------------------------------------------------------
-infra::vector_base infra::operator+(const double& s,
-                                    const infra::vector_base& u) {
-  infra::vector new_vector(u);
-  new_vector += s;
-  return new_vector;
-}
-
-//-----------------------------------------------------------------------------
-infra::vector_base infra::operator*(const infra::vector_base& u, 
-                                    const double& s) {
-  infra::vector new_vector(u);
-  new_vector *= s;
-  return new_vector;
-}
-
-//-----------------------------------------------------------------------------
-infra::vector_base infra::operator*(const double& s,
-                                    const infra::vector_base& u) {
-  infra::vector new_vector(u);
-  new_vector *= s;
-  return new_vector;
-}
-
-//-----------------------------------------------------------------------------
-infra::vector_base infra::operator-(const infra::vector_base& u, 
-                                    const double& s) {
-  infra::vector new_vector(u);
-  new_vector -= s;
-  return new_vector;
-}
-
-//-----------------------------------------------------------------------------
-infra::vector_base infra::operator-(const double& s,
-                                    const infra::vector_base& u) {
-  infra::vector new_vector(u.size());
-
-  infra::vector_base::iterator iter = new_vector.begin();
-  infra::vector_base::iterator end = new_vector.end();
-  infra::vector_base::const_iterator u_iter = u.begin();
-
-  while(iter < end) {
-    *iter = s - *(u_iter);
-    ++iter;
-    ++u_iter;
-  }
-
-  return new_vector;
-}
-
-//-----------------------------------------------------------------------------
-infra::vector_base infra::operator/(const infra::vector_base& u, 
-                                    const double& s) {
-  infra::vector new_vector(u);
-  new_vector /= s;
-  return new_vector;
-}
-
-//-----------------------------------------------------------------------------
-infra::vector_base infra::operator/(const double& s,
-                                    const infra::vector_base& u) {
-  infra::vector new_vector(u.size());
-
-  infra::vector_base::iterator iter = new_vector.begin();
-  infra::vector_base::iterator end = new_vector.end();
-  infra::vector_base::const_iterator u_iter = u.begin();
-
-  while(iter < end) {
-    infra_assert( *u_iter != 0.0, "Divide by zero error");
-    *iter = s / (*u_iter);
-    ++iter;
-    ++u_iter;
-  }
-
-  return new_vector;
-}
-
 
 //*****************************************************************************
 //                                     E O F
@@ -65,15 +65,6 @@ void add_prod(const infra::vector_base& u, const infra::vector_base& v, double&
 void sum(const infra::vector_base& u, const infra::vector_base& v,
 	 infra::vector_base& outcome);
 
-//-----------------------------------------------------------------------------
-/** Operator + for vector-vector addition
-    @param u A constant reference to a vector_base
-    @param v A constant reference to a vector_base
-    @return The sum vector
-*/
-infra::vector_base operator+(const infra::vector_base& u, 
-                             const infra::vector_base& v);
-
 //-----------------------------------------------------------------------------
 /** Performs vector_base subtraction
     @param u A constant reference to a vector_base
@@ -84,15 +75,6 @@ infra::vector_base operator+(const infra::vector_base& u,
 void diff(const infra::vector_base& u, const infra::vector_base& v,
 	  infra::vector_base& outcome);
 
-//-----------------------------------------------------------------------------
-/** Operator + for vector-vector subtraction
-    @param u A constant reference to a vector_base
-    @param v A constant reference to a vector_base
-    @return The difference vector
-*/
-infra::vector_base operator-(const infra::vector_base& u, 
-                             const infra::vector_base& v);
-
 //-----------------------------------------------------------------------------
 /** Coordinate-wise multiplication
     @param u A constant reference to a vector_base
@@ -129,77 +111,8 @@ void dist2(const infra::vector_base& u, const infra::vector_base& v, double&
 double dist2(const infra::vector_base& u, const infra::vector_base& v);
 
 //-----------------------------------------------------------------------------
-/** Operator + for vector-scalar coordinate-wise addition. 
-    @param u A constant reference to a vector
-    @param s A scalar
-    @return The outcome
-*/
-infra::vector_base operator+(const infra::vector_base& u, 
-                             const double& s);
-
-//-----------------------------------------------------------------------------
-/** Operator + for scalar-vector coordinate-wise addition. 
-    @param s A scalar
-    @param u A constant reference to a vector
-    @return The outcome
-*/
-infra::vector_base operator+(const double& s,
-                             const infra::vector_base& u);
-
-//-----------------------------------------------------------------------------
-/** Operator - for vector-scalar coordinate-wise subtraction;
-    @param u A constant reference to a vector
-    @param s A scalar
-    @return The outcome
-*/
-infra::vector_base operator-(const infra::vector_base& u, 
-                             const double& s);
-
-//-----------------------------------------------------------------------------
-/** Operator - for scalar-vector coordinate-wise subtraction;
-    @param s A scalar
-    @param u A constant reference to a vector
-    @return The outcome
-*/
-infra::vector_base operator-(const double& s,
-                             const infra::vector_base& u);
-
-//-----------------------------------------------------------------------------
-/** Operator * for vector-scalar coordinate-wise multiplication.
-    @param u A constant reference to a vector
-    @param s A scalar
-    @return The outcome
-*/
-infra::vector_base operator*(const infra::vector_base& u, 
-                             const double& s);
-
-//-----------------------------------------------------------------------------
-/** Operator * for scalar-vector coordinate-wise multiplication.
-    @param s A scalar
-    @param u A constant reference to a vector
-    @return The outcome
-*/
-infra::vector_base operator*(const double& s,
-                             const infra::vector_base& u);
-
-//-----------------------------------------------------------------------------
-/** Operator / for vector-scalar coordinate-wise division.
-    @param u A constant reference to a vector
-    @param s A scalar
-    @return The outcome
-*/
-infra::vector_base operator/(const infra::vector_base& u, 
-                             const double& s);
-
-
-//-----------------------------------------------------------------------------
-/** Operator / for scalar-vector coordinate-wise division.
-    @param s A scalar
-    @param u A constant reference to a vector
-    @return The outcome
-*/
-infra::vector_base operator/(const double& s,
-                             const infra::vector_base& u);
+// The operators + and - of two vectors, and +, -, * and / of a vector and a
+// scalar, build expressions computed where they are used, see infra_expr.h
 };
 #endif
 //*****************************************************************************
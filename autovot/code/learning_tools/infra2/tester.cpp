@@ -12,6 +12,8 @@
 #include <time.h>
 #include <cstdio>
 #include <fstream>
+#include <cfloat>
+#include <cmath>
 using namespace std;
 
 #define SMALL_NUMBER 1e-20
@@ -379,6 +381,24 @@ int test_infra_vv_funcs()
   for (uint i=0;i < u3.size(); ++i) s += (u3(i) == 2.0/u1(i));
   check_bug(s == 2*u3.size(),"operator /");
 
+  // expressions: fused assignment, reductions, and an operand overlapping
+  // the destination
+  s = 0;
+  infra::vector d(u1.size());
+  d = u2 - u1;
+  u3 = u1;
+  u3 += (u2 - u1) * 0.5;
+  for (uint i=0;i < u3.size(); ++i) s += (u3(i) == u1(i) + d(i)*0.5);
+  s += ((u2 - u1) * u2 == d * u2);
+  s += ((u2 - u1).norm2() == d.norm2());
+  s += ((u2 - u1).sum() == d.sum());
+  infra::vector e = u1 + u2;
+  s += (e == u1 + u2);
+  u3 = u2;
+  u3.subvector(1,u3.size()-1) = u3.subvector(0,u3.size()-1) * 2.0;
+  for (uint i=1;i < u3.size(); ++i) s += (u3(i) == u2(i-1)*2.0);
+  check_bug(s == 2*u3.size()+3,"expressions");
+
   return 1;
 }
 
@@ -1136,6 +1156,269 @@ int test_infra_mm_funcs() {
 
 }
 
+int test_vector_memory()
+{
+  // -----------------------------------------------------------
+  // move constructor: the memory is taken, the source is empty
+  // -----------------------------------------------------------
+  infra::vector u1(10);
+  for (unsigned int i=0;i<u1.size();++i) u1(i) = i;
+  double* u1_data = &u1(0);
+  infra::vector u2(std::move(u1));
+  check_bug(u1.size() == 0 && u2.size() == 10 && &u2(0) == u1_data && 
+            u2(9) == 9.0,"move constructor");
+
+  // -----------------------------------------------------------
+  // move assignment of unique vectors swaps the memory
+  // -----------------------------------------------------------
+  infra::vector u3(10);
+  u3.zeros();
+  double* u3_data = &u3(0);
+  u3 = std::move(u2);
+  check_bug(&u3(0) == u1_data && &u2(0) == u3_data && u3(9) == 9.0 &&
+            u2(9) == 0.0,"move assignment of unique vectors");
+
+  // -----------------------------------------------------------
+  // a vector referenced by a view is copied, not stolen
+  // -----------------------------------------------------------
+  infra::vector u4(10);
+  u4.ones();
+  infra::vector_view v4 = u4.subvector(0, 10);
+  u3 = std::move(u4);
+  u4(0) = 5.0;
+  check_bug(&u3(0) != &u4(0) && u3(0) == 1.0 && v4(0) == 5.0 && 
+            u4.size() == 10,"move assignment of a shared vector");
+
+  // nor is one whose destination is referenced by a view
+  infra::vector_view v3 = u3.subvector(0, 10);
+  infra::vector u5(10);
+  u5.zeros();
+  u3 = std::move(u5);
+  check_bug(&v3(0) == &u3(0) && v3(0) == 0.0 && u5.size() == 10,
+            "move assignment to a shared vector");
+
+  // -----------------------------------------------------------
+  // matrices move as vectors do
+  // -----------------------------------------------------------
+  infra::matrix A(3,4);
+  A.ones();
+  double* A_data = &A(0,0);
+  infra::matrix B(std::move(A));
+  check_bug(A.height() == 0 && B.height() == 3 && &B(0,0) == A_data,
+            "matrix move constructor");
+  infra::matrix C(3,4);
+  C.zeros();
+  infra::matrix_view D = C.submatrix(0,0,3,4);
+  C = std::move(B);
+  check_bug(&D(0,0) == &C(0,0) && D(2,3) == 1.0 && B.height() == 3,
+            "matrix move assignment to a shared matrix");
+
+  // -----------------------------------------------------------
+  // external views read and write the memory of the caller
+  // -----------------------------------------------------------
+  double buffer[6] = {0.0, 1.0, 2.0, 3.0, 4.0, 5.0};
+  infra::vector_base e1 = infra::vector_base::external(buffer, 6);
+  e1(2) = 7.0;
+  check_bug(buffer[2] == 7.0 && &e1(0) == buffer && e1(5) == 5.0,
+            "external view");
+  infra::vector_base e2 = infra::vector_base::external(buffer + 1, 3, 2);
+  e2 = 8.0;
+  check_bug(buffer[1] == 8.0 && buffer[3] == 8.0 && buffer[5] == 8.0 &&
+            buffer[4] == 4.0,"external view with a step");
+  const double* const_buffer = buffer;
+  const infra::vector_base e3 = infra::vector_base::external(const_buffer, 6);
+  check_bug(e3.sum() == 0.0 + 8.0 + 7.0 + 8.0 + 4.0 + 8.0,
+            "constant external view");
+
+  // -----------------------------------------------------------
+  // resize to the same size keeps the memory unless it is shared
+  // -----------------------------------------------------------
+  infra::vector u6(10);
+  u6.ones();
+  double* u6_data = &u6(0);
+  u6.resize(10);
+  check_bug(&u6(0) == u6_data && u6(9) == 1.0,"resize to the same size");
+  infra::vector_view v6 = u6.subvector(0, 10);
+  u6.resize(10);
+  u6(0) = 3.0;
+  check_bug(&u6(0) != u6_data && v6(0) == 1.0 && u6(9) == 1.0,
+            "resize of a shared vector to the same size");
+
+  // -----------------------------------------------------------
+  // move assignment swaps only memory of the same arena
+  // -----------------------------------------------------------
+  infra::arena a;
+  infra::vector h1(10);
+  h1.ones();
+  double* h1_data = &h1(0);
+  {
+    infra::arena::scope arena_scope(&a);
+    infra::vector a1(10);
+    a1.zeros();
+    double* a1_data = &a1(0);
+    a1 = std::move(h1);
+    check_bug(&a1(0) == a1_data && &h1(0) == h1_data && a1(0) == 1.0,
+              "move assignment from the heap into an arena");
+    infra::vector a2(10);
+    a2.zeros();
+    double* a2_data = &a2(0);
+    a2 = std::move(a1);
+    check_bug(&a2(0) == a1_data && &a1(0) == a2_data && a2(0) == 1.0,
+              "move assignment within an arena");
+  }
+  check_bug(a.live() == 0,"vectors of an arena released");
+
+  return 1;
+}
+
+int test_simd()
+{
+  // -----------------------------------------------------------
+  // every level the CPU supports against the sequential loops, on
+  // lengths around the 8 partial sums, unaligned starts and steps
+  // -----------------------------------------------------------
+  const unsigned long max_n = 17;
+  const unsigned long max_step = 3;
+  const unsigned long max_offset = 3;
+  const unsigned long buffer_size = max_offset + max_step*max_n + 1;
+  double u[buffer_size], v[buffer_size], y[buffer_size], y_ref[buffer_size];
+  for (unsigned long i=0; i < buffer_size; ++i) {
+    u[i] = sin(0.7*i + 0.1) * 3.0;
+    v[i] = cos(1.3*i) / (i + 1.0);
+  }
+
+  infra::simd::level_t original = infra::simd::level();
+  std::vector<double> portable_dots;
+  int levels = 0;
+  for (int l = infra::simd::PORTABLE; l <= infra::simd::AVX512; ++l) {
+    infra::simd::level_t requested = infra::simd::level_t(l);
+    if (infra::simd::set_level(requested) != requested) continue;
+    levels++;
+    bool dot_ok = true;
+    bool axpy_ok = true;
+    unsigned long k = 0;
+    for (unsigned long n = 0; n <= max_n; ++n) {
+      for (unsigned long offset = 0; offset <= max_offset; ++offset) {
+        for (unsigned long step = 1; step <= max_step; ++step) {
+          const double* x = u + offset;
+          const double* z = v + (max_offset - offset);
+          unsigned long z_step = max_step + 1 - step;
+
+          // the dot product is within n ulps of the sequential sum, and
+          // the same at every level
+          double sequential = 0.0;
+          double bound = 0.0;
+          for (unsigned long i = 0; i < n; ++i) {
+            sequential += x[i*step] * z[i*z_step];
+            bound += fabs(x[i*step] * z[i*z_step]);
+          }
+          bound *= n * DBL_EPSILON;
+          double d = infra::simd::dot(x, step, z, z_step, n);
+          if (fabs(d - sequential) > bound) dot_ok = false;
+          if (l == infra::simd::PORTABLE) portable_dots.push_back(d);
+          else if (d != portable_dots[k]) dot_ok = false;
+          k++;
+
+          // axpy is exact, and leaves the other elements alone
+          for (unsigned long i = 0; i < buffer_size; ++i) 
+            y[i] = y_ref[i] = v[i];
+          for (unsigned long i = 0; i < n; ++i) 
+            y_ref[offset + i*step] += 0.37 * z[i*z_step];
+          infra::simd::axpy(0.37, z, z_step, y + offset, step, n);
+          for (unsigned long i = 0; i < buffer_size; ++i)
+            if (y[i] != y_ref[i]) axpy_ok = false;
+        }
+      }
+    }
+    check_bug(dot_ok,"simd::dot at level " << infra::simd::level_name(requested));
+    check_bug(axpy_ok,"simd::axpy at level " << infra::simd::level_name(requested));
+  }
+  infra::simd::set_level(original);
+  check_bug(levels > 0 && infra::simd::level() == original,"simd levels");
+
+  return 1;
+}
+
+int test_arena()
+{
+  // -----------------------------------------------------------
+  // allocations are aligned, whatever their sizes
+  // -----------------------------------------------------------
+  infra::arena a;
+  unsigned long sizes[] = {1, 8, 100, 64, 0, 65, 1000};
+  bool aligned = true;
+  for (unsigned int i = 0; i < sizeof(sizes)/sizeof(sizes[0]); ++i) {
+    void* p = a.allocate(sizes[i]);
+    if ((unsigned long)p % infra::arena::ALIGNMENT != 0) aligned = false;
+  }
+  check_bug(aligned && a.live() == 7,"arena alignment");
+
+  // -----------------------------------------------------------
+  // reset() refuses while memory is in use, then reuses it
+  // -----------------------------------------------------------
+  unsigned long used = a.used();
+  check_bug(!a.reset() && a.used() == used && a.live() == 7,
+            "arena reset with live memory");
+  for (int i = 0; i < 7; ++i) a.release();
+  check_bug(a.reset() && a.used() == 0 && a.live() == 0,"arena reset");
+  void* first = a.allocate(10);
+  void* second = a.allocate(10);
+  check_bug(a.used() == 2 * infra::arena::ALIGNMENT &&
+            (char*)second - (char*)first == (long)infra::arena::ALIGNMENT,
+            "arena reuse after reset");
+  a.release();
+  a.release();
+  a.reset();
+
+  // -----------------------------------------------------------
+  // blocks are added past the first one, and merged by reset()
+  // -----------------------------------------------------------
+  unsigned long block = infra::arena::DEFAULT_BLOCK_SIZE;
+  a.allocate(block / 2);
+  a.allocate(block);
+  a.allocate(3 * block);
+  unsigned long capacity = a.capacity();
+  check_bug(capacity >= 4 * block + block / 2 && a.used() == 4 * block + block / 2,
+            "arena growth");
+  for (int i = 0; i < 3; ++i) a.release();
+  a.reset();
+  a.allocate(4 * block + block / 2);
+  check_bug(a.capacity() == capacity,"arena blocks merged by reset");
+  a.release();
+  a.reset();
+
+  // -----------------------------------------------------------
+  // scopes nest and restore the arena installed before them
+  // -----------------------------------------------------------
+  infra::arena b;
+  check_bug(infra::arena::current() == NULL,"no arena by default");
+  {
+    infra::arena::scope scope_a(&a);
+    infra::vector u1(100);
+    check_bug(infra::arena::current() == &a && a.live() == 1,
+              "arena scope");
+    {
+      infra::arena::scope scope_b(&b);
+      infra::vector u2(100);
+      check_bug(infra::arena::current() == &b && b.live() == 1 &&
+                a.live() == 1,"nested arena scope");
+      {
+        infra::arena::scope scope_heap(NULL);
+        infra::vector u3(100);
+        check_bug(infra::arena::current() == NULL && b.live() == 1 &&
+                  a.live() == 1,"heap scope within an arena scope");
+      }
+      check_bug(infra::arena::current() == &b,"heap scope restored");
+    }
+    check_bug(infra::arena::current() == &a && b.live() == 0,
+              "nested arena scope restored");
+  }
+  check_bug(infra::arena::current() == NULL && a.live() == 0,
+            "arena scope restored");
+
+  return 1;
+}
+
 int main()
 {
 
@@ -1198,6 +1481,30 @@ int main()
     return 0;
   }
 
+  // Test move semantics and external views
+  std::cerr << "TESTING vector memory\n"
+	    << "====================\n";
+  if (!test_vector_memory()) {
+    std::cerr << "Problem with test_vector_memory\n";
+    return 0;
+  }
+
+  // Test the simd kernels
+  std::cerr << "TESTING simd kernels\n"
+	    << "====================\n";
+  if (!test_simd()) {
+    std::cerr << "Problem with test_simd\n";
+    return 0;
+  }
+
+  // Test the arenas
+  std::cerr << "TESTING arena\n"
+	    << "====================\n";
+  if (!test_arena()) {
+    std::cerr << "Problem with test_arena\n";
+    return 0;
+  }
+
 
   
   std::cerr << "\nDONE.\n";
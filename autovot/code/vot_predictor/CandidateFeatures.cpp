@@ -0,0 +1,215 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   CandidateFeatures
+ Purpose:  Cache of the feature vectors of all candidate VOT locations
+ Date:     19 Oct., 2026
+
+ **************************** INCLUDE FILES *****************************/
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include "CandidateFeatures.h"
+#include "Logger.h"
+
+/************************************************************************
+ Function:     CandidateFeatures::CandidateFeatures
+
+ Description:  Constructor
+ Inputs:       none.
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+CandidateFeatures::CandidateFeatures() :
+_data(NULL),
+_num_bytes(0),
+_pos_dim(0),
+_neg_dim(0),
+_mapped(false)
+{
+}
+
+/************************************************************************
+ Function:     CandidateFeatures::~CandidateFeatures
+
+ Description:  Destructor
+ Inputs:       none.
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+CandidateFeatures::~CandidateFeatures()
+{
+	if (_data == NULL)
+		return;
+	if (_mapped)
+		munmap(_data, _num_bytes);
+	else
+		free(_data);
+}
+
+/************************************************************************
+ Function:     CandidateFeatures::allocate
+
+ Description:  Allocate the storage for the feature rows
+ Inputs:       unsigned long num_candidates - number of candidates
+               int pos_dim - size of phi_pos
+               int neg_dim - size of phi_neg (0 if only positive VOTs)
+               std::string &cache_dir - if not empty, the rows are kept
+               in a memory mapped file in this directory
+ Output:       bool - true on success
+ Comments:     The file is unlinked right after it is mapped, so it is
+               removed when the cache is destroyed or the process dies.
+ ***********************************************************************/
+bool CandidateFeatures::allocate(unsigned long num_candidates, int pos_dim,
+																 int neg_dim, const std::string &cache_dir)
+{
+	_pos_dim = pos_dim;
+	_neg_dim = neg_dim;
+	_num_bytes = num_candidates*(pos_dim+neg_dim)*sizeof(double);
+	candidates.reserve(num_candidates);
+
+	if (_num_bytes == 0)
+		return true;
+
+	if (cache_dir == "") {
+		_data = (double*)malloc(_num_bytes);
+		return (_data != NULL);
+	}
+
+	std::string filename = cache_dir + "/VotTrain.XXXXXX";
+	int fd = mkstemp(&filename[0]);
+	if (fd < 0) {
+		LOG(ERROR) << "Unable to create cache file in " << cache_dir;
+		return false;
+	}
+	unlink(filename.c_str());
+	if (ftruncate(fd, _num_bytes) != 0) {
+		LOG(ERROR) << "Unable to allocate " << _num_bytes << " bytes for cache file in " << cache_dir;
+		close(fd);
+		return false;
+	}
+	void *p = mmap(NULL, _num_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED) {
+		LOG(ERROR) << "Unable to map cache file in " << cache_dir;
+		return false;
+	}
+	_data = (double*)p;
+	_mapped = true;
+
+	return true;
+}
+
+/************************************************************************
+ Function:     CandidateFeaturesCache::CandidateFeaturesCache
+
+ Description:  Constructor
+ Inputs:       double max_megabytes - maximal size of the cache (0 disables it)
+               std::string cache_dir - directory for memory mapped files,
+               or empty to keep the features in RAM
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+CandidateFeaturesCache::CandidateFeaturesCache(double max_megabytes, std::string cache_dir) :
+_cache_dir(cache_dir),
+_max_bytes((unsigned long)(max_megabytes*1024.0*1024.0)),
+_num_bytes(0),
+_cap_reported(false)
+{
+}
+
+/************************************************************************
+ Function:     CandidateFeaturesCache::~CandidateFeaturesCache
+
+ Description:  Destructor
+ Inputs:       none.
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+CandidateFeaturesCache::~CandidateFeaturesCache()
+{
+	std::map<unsigned long, CandidateFeatures*>::iterator it;
+	for (it = _entries.begin(); it != _entries.end(); it++)
+		delete it->second;
+}
+
+/************************************************************************
+ Function:     CandidateFeaturesCache::find
+
+ Description:  Find the cached features of an utterance
+ Inputs:       unsigned long index - position of the utterance in the dataset
+ Output:       CandidateFeatures* - the cached features or NULL
+ Comments:     none.
+ ***********************************************************************/
+CandidateFeatures *CandidateFeaturesCache::find(unsigned long index)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::map<unsigned long, CandidateFeatures*>::iterator it = _entries.find(index);
+	if (it == _entries.end())
+		return NULL;
+	return it->second;
+}
+
+/************************************************************************
+ Function:     CandidateFeaturesCache::add
+
+ Description:  Allocate a new entry for an utterance
+ Inputs:       unsigned long index - position of the utterance in the dataset
+               unsigned long num_candidates - number of candidates
+               int pos_dim, int neg_dim - sizes of phi_pos and phi_neg
+ Output:       CandidateFeatures* - the new entry or NULL if the cache is
+               disabled, full or the allocation failed
+ Comments:     none.
+ ***********************************************************************/
+CandidateFeatures *CandidateFeaturesCache::add(unsigned long index,
+																							 unsigned long num_candidates,
+																							 int pos_dim, int neg_dim)
+{
+	if (!enabled())
+		return NULL;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	unsigned long num_bytes = num_candidates*(pos_dim+neg_dim)*sizeof(double);
+	if (_num_bytes + num_bytes > _max_bytes) {
+		if (!_cap_reported) {
+			LOG(INFO) << "Candidate features cache is full (" << _num_bytes/(1024*1024)
+			<< " MB). Features of the remaining utterances are recomputed.";
+			_cap_reported = true;
+		}
+		return NULL;
+	}
+
+	CandidateFeatures *entry = new CandidateFeatures;
+	if (!entry->allocate(num_candidates, pos_dim, neg_dim, _cache_dir)) {
+		LOG(WARNING) << "Unable to allocate " << num_bytes << " bytes for the candidate features cache";
+		delete entry;
+		return NULL;
+	}
+	_entries[index] = entry;
+	_num_bytes += num_bytes;
+
+	return entry;
+}
+
+// ------------------------------- EOF -----------------------------//
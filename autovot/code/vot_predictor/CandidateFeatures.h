@@ -0,0 +1,103 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+#ifndef _CANDIDATE_FEATURES_H
+#define _CANDIDATE_FEATURES_H
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   CandidateFeatures
+ Purpose:  Cache of the feature vectors of all candidate VOT locations
+           of an utterance, reused across training epochs
+ Date:     19 Oct., 2026
+
+ *************************** INCLUDE FILES ******************************/
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include "infra.h"
+#include "Dataset.h"
+
+/***********************************************************************/
+
+// The feature vectors phi_pos and phi_neg of every candidate of one
+// utterance, stored candidate after candidate (one contiguous row per
+// candidate). The rows are either kept in RAM or in an unlinked file
+// mapped into memory.
+class CandidateFeatures
+{
+public:
+  CandidateFeatures();
+  ~CandidateFeatures();
+  bool allocate(unsigned long num_candidates, int pos_dim, int neg_dim,
+                const std::string &cache_dir);
+  unsigned long size() { return candidates.size(); }
+  unsigned long size_in_bytes() { return _num_bytes; }
+  int pos_dim() { return _pos_dim; }
+  int neg_dim() { return _neg_dim; }
+  double *pos_row(unsigned long c) { return _data + c*(_pos_dim+_neg_dim); }
+  double *neg_row(unsigned long c) { return _data + c*(_pos_dim+_neg_dim) + _pos_dim; }
+
+public:
+  // candidate locations in the order they are enumerated by the
+  // Classifier. The negative candidate of row c is the same location
+  // with burst and voice swapped.
+  std::vector<VotLocation> candidates;
+
+private:
+  CandidateFeatures(const CandidateFeatures&);
+  void operator=(const CandidateFeatures&);
+
+  double *_data;
+  unsigned long _num_bytes;
+  int _pos_dim;
+  int _neg_dim;
+  bool _mapped;
+};
+
+/***********************************************************************/
+
+// A set of CandidateFeatures indexed by the position of the utterance in
+// the training set. Utterances are added as long as the total size stays
+// below the given cap; the remaining ones are recomputed every epoch.
+// find() and add() may be called from several training threads.
+class CandidateFeaturesCache
+{
+public:
+  CandidateFeaturesCache(double max_megabytes, std::string cache_dir="");
+  ~CandidateFeaturesCache();
+  bool enabled() { return (_max_bytes > 0); }
+  CandidateFeatures *find(unsigned long index);
+  CandidateFeatures *add(unsigned long index, unsigned long num_candidates,
+                         int pos_dim, int neg_dim);
+  unsigned long size_in_bytes() { return _num_bytes; }
+
+private:
+  std::map<unsigned long, CandidateFeatures*> _entries;
+  std::string _cache_dir;
+  unsigned long _max_bytes;
+  unsigned long _num_bytes;
+  bool _cap_reported;
+  std::mutex _mutex;
+};
+
+#endif // _CANDIDATE_FEATURES_H
@@ -29,6 +29,7 @@ License along with Autovot.  If not, see
  **************************** INCLUDE FILES *****************************/
 #include <iostream>
 #include "Classifier.h"
+#include "Profiler.h"
 #include "Logger.h"
 
 #define MISPAR_KATAN_MEOD (-1000000)
@@ -38,7 +39,81 @@ License along with Autovot.  If not, see
 int Classifier::phi_pos_size = 77;
 int Classifier::phi_neg_size = 59;
 
+/************************************************************************
+ Function:     point_feature_slots
+
+ Description:  Find columns of the scores in the point features
+ Inputs:       const int *columns, int n
+ Output:       std::vector<int> - the slot of each column
+ Comments:     All the columns phi_pos() and phi_neg() read at a single
+               frame are point features, see point_feature_columns.
+ ***********************************************************************/
+static std::vector<int> point_feature_slots(const int *columns, int n)
+{
+	std::vector<int> slots(n);
+	for (int i = 0; i < n; i++)
+		slots[i] = point_feature_slot(columns[i]);
+	return slots;
+}
+
+/************************************************************************
+ Function:     gather_point_features
+
+ Description:  Copy point features of one frame of x into v
+ Inputs:       const SpeechUtterance &x, int frame
+               const std::vector<int> &slots
+               infra::vector &v, int &v_i - the next element of v
+ Output:       none.
+ Comments:     The point features of a frame are in four cache lines,
+               the same columns of the scores in one cache line each.
+ ***********************************************************************/
+static void gather_point_features(const SpeechUtterance &x, int frame,
+																	const std::vector<int> &slots,
+																	infra::vector &v, int &v_i)
+{
+	const double *point = x.point_features(frame);
+	for (unsigned int i = 0; i < slots.size(); i++, v_i++)
+		v[v_i] = point[slots[i]];
+}
+
+
+
+/************************************************************************
+ Function:     PrefixStatistics::reset
+ 
+ Description:  Drop the statistics of all frames
+ Inputs:       none.
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+void PrefixStatistics::reset()
+{
+	sum_3.clear();
+	sum_4.clear();
+	sum_7.clear();
+	max_3.clear();
+	max_4.clear();
+}
 
+/************************************************************************
+ Function:     PrefixStatistics::extend
+ 
+ Description:  Add the statistics of the next frames
+ Inputs:       SpeechUtterance &x, int last
+ Output:       none.
+ Comments:     The sums start at 0 and the maxima at MISPAR_KATAN_MEOD,
+               as in phi_pos().
+ ***********************************************************************/
+void PrefixStatistics::extend(SpeechUtterance& x, int last)
+{
+	for (int i = size(); i <= last; i++) {
+		sum_3.push_back((i > 0 ? sum_3[i-1] : 0.0) + x.scores(i,3));
+		sum_4.push_back((i > 0 ? sum_4[i-1] : 0.0) + x.scores(i,4));
+		sum_7.push_back((i > 0 ? sum_7[i-1] : 0.0) + x.scores(i,7));
+		max_3.push_back(_max(x.scores(i,3), (i > 0 ? max_3[i-1] : double(MISPAR_KATAN_MEOD))));
+		max_4.push_back(_max(x.scores(i,4), (i > 0 ? max_4[i-1] : double(MISPAR_KATAN_MEOD))));
+	}
+}
 
 /************************************************************************
  Function:     Classifier::Classifier
@@ -64,7 +139,9 @@ w_pos(phi_pos_size),
 w_neg(phi_neg_size),
 w_pos_sum(phi_pos_size),
 w_neg_sum(phi_neg_size),
-kernel(_kernel_name, phi_pos_size, _sigma)
+num_averaged_examples(0),
+kernel(_kernel_name, phi_pos_size, _sigma),
+binary_model(false)
 {
 	kernel_phi_pos_size = kernel.features_dim();
 	LOG(DEBUG) << "size(w_pos)=" << w_pos.size();
@@ -133,11 +210,15 @@ void Classifier::ignore_features(std::string &ignore_features_str)
  Description:  Train classifier with one example
  Inputs:       infra::vector& x - example instance
  int y - label
+ bool stale_y_hat - y_hat was predicted with an older w
  Output:       double - squared loss
- Comments:     none.
+ Comments:     A negative hinge loss is expected when y_hat is stale (mini-batch
+               training), and then there is no update.
  ***********************************************************************/
-double Classifier::update( SpeechUtterance& x, VotLocation y, VotLocation &y_hat, bool vot_loss)
+double Classifier::update( SpeechUtterance& x, VotLocation y, VotLocation &y_hat, bool vot_loss,
+													bool stale_y_hat)
 {
+	ProfileScope profile(PROFILE_UPDATE);
 	double current_loss = 0.0;
 	
 	if (vot_loss)
@@ -145,44 +226,52 @@ double Classifier::update( SpeechUtterance& x, VotLocation y, VotLocation &y_hat
 	else
 		current_loss = loss(y,y_hat);
 	
-	infra::vector_view phi_x_y = phi(x,y);
-	infra::vector_view phi_x_y_hat = phi(x,y_hat);
-	
-	// std::cout << "phi_x_y=" << phi_x_y << std::endl;;
-	// std::cout << "phi_x_y_hat=" << phi_x_y_hat << std::endl;
+	// one more example contributes to the averaged classifier
+	num_averaged_examples++;
 	
-	infra::vector delta_phi(phi_size);
-	delta_phi = phi_x_y - phi_x_y_hat;
+	infra::vector_view phi_x_y_pos = phi_pos(x,y);
+	infra::vector_view phi_x_y_neg = phi_neg(x,y);
+	infra::vector_view phi_x_y_hat_pos = phi_pos(x,y_hat);
+	infra::vector_view phi_x_y_hat_neg = phi_neg(x,y_hat);
 	
-	infra::vector w(phi_size);
-	w.zeros();
-	w.subvector(0, kernel_phi_pos_size) = w_pos;
-	w.subvector(kernel_phi_pos_size, phi_neg_size) = w_neg;
+	infra::vector delta_phi_pos(kernel_phi_pos_size);
+	delta_phi_pos = phi_x_y_pos - phi_x_y_hat_pos;
+	infra::vector delta_phi_neg(phi_neg_size);
+	delta_phi_neg = phi_x_y_neg - phi_x_y_hat_neg;
 	
 	LOG(DEBUG) << "y=" << y << " y_hat=" << y_hat;
-	LOG(DEBUG) << "w*phi(x,y)=" << w*phi_x_y << " w*phi(x,y_hat)=" << w*phi_x_y_hat
-	<< " w*phi(x,y_hat)+loss(y,y_hat)=" << w*phi_x_y_hat + current_loss;
+	LOG(DEBUG) << "w*phi(x,y)=" << w_prod(phi_x_y_pos, phi_x_y_neg)
+	<< " w*phi(x,y_hat)=" << w_prod(phi_x_y_hat_pos, phi_x_y_hat_neg)
+	<< " w*phi(x,y_hat)+loss(y,y_hat)=" << w_prod(phi_x_y_hat_pos, phi_x_y_hat_neg) + current_loss;
 	LOG(DEBUG) << "gamma=" << current_loss;
 	
 	// changed 3/27/10 for consistency w/ matlab version -- MS
 	// delta_phi /= 2.0;
-	current_loss -= w*delta_phi;
+	current_loss -= w_prod(delta_phi_pos, delta_phi_neg);
+	
+	// squared norm of delta_phi, the sum of the squared norms of its two parts
+	double delta_phi_norm2 = delta_phi_pos.norm2();
+	infra::add_prod(delta_phi_neg, delta_phi_neg, delta_phi_norm2);
 	
-	//std::cout << "phi(x,y)= " << phi_x_y << std::endl;
-	//std::cout << "phi(x,y_hat)= " << phi_x_y_hat << std::endl;
-	//  std::cout << "delta_phi = " << delta_phi << std::endl;
 	LOG(DEBUG) << "hinge_loss=" << current_loss;
-	LOG(DEBUG) << "delta_phi.norm2()="  << delta_phi.norm2();
+	LOG(DEBUG) << "delta_phi.norm2()="  << delta_phi_norm2;
 	
 	if (current_loss > 0.0)  {
 		// update
-		double tau = current_loss / delta_phi.norm2();
+		double tau = current_loss / delta_phi_norm2;
 		if (tau > PA1_C) tau = PA1_C; // PA-I
 		LOG(DEBUG) << "tau=" << tau;
-		delta_phi *= tau;
-		w += delta_phi;
+		w_pos += delta_phi_pos * tau;
+		w_neg += delta_phi_neg * tau;
+		
+		// lazy averaging: the update made at example t is present in the
+		// remaining N-t+1 iterates, so only (t-1)*delta is kept here and the
+		// sum of all w_i is recovered in w_star_mean()
+		if (num_averaged_examples > 1) {
+			w_pos_sum += delta_phi_pos * tau * double(num_averaged_examples-1);
+			w_neg_sum += delta_phi_neg * tau * double(num_averaged_examples-1);
+		}
 		
-		//  std::cout << "w = " << w << std::endl;
 		w_changed = true;
 	}
 	else if (current_loss == 0.0) {
@@ -190,7 +279,9 @@ double Classifier::update( SpeechUtterance& x, VotLocation y, VotLocation &y_hat
 		w_changed = false;
 	}
 	else { // hing loss is less than zero, if we reach this point
-		if (fabs(y.voice-y.burst) <= min_vot_length) {
+		if (stale_y_hat) {
+			LOG(DEBUG) << "No update. Hinge loss of a prediction made with an older w is less than zero.";
+		} else if (fabs(y.voice-y.burst) <= min_vot_length) {
 			LOG(WARNING) << "Hinge loss is less than zero. This is due a short VOT in training data.";
 		} else {
 			LOG(ERROR) << "Hinge loss is less than zero. ";
@@ -199,17 +290,26 @@ double Classifier::update( SpeechUtterance& x, VotLocation y, VotLocation &y_hat
 		w_changed = false;
 	}
 	
-	// split w to w_pos and w_neg
-	w_pos = w.subvector(0, kernel_phi_pos_size);
-	w_neg = w.subvector(kernel_phi_pos_size, phi_neg_size);
-	
-	// add this w_i to sum of all w
-	w_pos_sum += w_pos;
-	w_neg_sum += w_neg;
-	
 	return current_loss;
 }
 
+/************************************************************************
+ Function:     Classifier::w_prod
+ 
+ Description:  Inner product of w=[w_pos w_neg] with a vector given by its
+               positive and negative parts
+ Inputs:       infra::vector_base &v_pos, infra::vector_base &v_neg
+ Output:       double - w*v
+ Comments:     The terms are accumulated in the same order as the product
+               with the concatenated vector.
+ ***********************************************************************/
+double Classifier::w_prod(const infra::vector_base &v_pos, const infra::vector_base &v_neg)
+{
+	double outcome = w_pos*v_pos;
+	infra::add_prod(w_neg, v_neg, outcome);
+	return outcome;
+}
+
 
 #if 0
 /************************************************************************
@@ -225,6 +325,7 @@ double Classifier::update_direct_loss(SpeechUtterance& x, VotLocation &y_hat_eps
 																			VotLocation &y_hat, VotLocation &y,
 																			double epsilon)
 {
+	ProfileScope profile(PROFILE_UPDATE);
 	infra::vector delta_phi(phi_size);
 	infra::vector_view phi_x_y_hat_eps = y_hat_eps.burst < y_hat_eps.voice ? phi_pos(x,y_hat_eps) : phi_neg(x,y_hat_eps);
 	infra::vector_view phi_x_y_hat = y_hat.burst < y_hat.voice ? phi_pos(x,y_hat) : phi_neg(x,y_hat);
@@ -368,12 +469,15 @@ infra::vector_view Classifier::phi(SpeechUtterance& x, VotLocation& y)
  Description:  calculate phi of x for positive update
  Inputs:       SpeechUtterance &x
  VotLocation &y
+ const PrefixStatistics *stats - NULL to compute the statistics from
+ the first frame here
  Output:       infra::vector_view
  Comments:     Verify that all necessary features are included in VotFrontEnd
  and check that the corresponding numbers are correct, since
  this was modified for the negative case
  ***********************************************************************/
-infra::vector_view Classifier::phi_pos(SpeechUtterance& x, VotLocation& y)
+infra::vector_view Classifier::phi_pos(SpeechUtterance& x, VotLocation& y,
+																			 const PrefixStatistics *stats)
 {
 	infra::vector v(phi_pos_size);
 	v.zeros();
@@ -396,20 +500,19 @@ infra::vector_view Classifier::phi_pos(SpeechUtterance& x, VotLocation& y)
 	int voice_indices[] = {1,2,3,4,5,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,33,34,35,60,61,62};
 	// thsi is 26: std::cout << "sizeof(voice_indices)= " << sizeof(voice_indices)/double(sizeof(int)) << std::endl;
 	
+	static const std::vector<int> burst_slots =
+		point_feature_slots(burst_indices, int(sizeof(burst_indices)/sizeof(int)));
+	static const std::vector<int> voice_slots =
+		point_feature_slots(voice_indices, int(sizeof(voice_indices)/sizeof(int)));
+	
 	int v_i = 0;
 
 	// v_i of this group is from 0 to 17
 	// v=[x(burstInds,on); x(voiceInds,off)];
-	for (int i = 0; i < int(sizeof(burst_indices)/sizeof(int)); i++) {
-		v[v_i] = x.scores(y.burst,burst_indices[i]);
-		v_i++;
-	}
+	gather_point_features(x, y.burst, burst_slots, v, v_i);
 	
 	// v_i of this group is from 18 to 43
-	for (int i = 0; i < int(sizeof(voice_indices)/sizeof(int)); i++) {
-		v[v_i] = x.scores(y.voice,voice_indices[i]);
-		v_i++;
-	}
+	gather_point_features(x, y.voice, voice_slots, v, v_i);
 	
 	// v_i is 44
 	// v(end+1)=mean(x(25,on:off));
@@ -481,10 +584,17 @@ infra::vector_view Classifier::phi_pos(SpeechUtterance& x, VotLocation& y)
 		mean_3_vot += x.scores(i,3);
 	mean_3_vot /= double(y.voice-y.burst+1);
 	
+	// the statistics from the first frame, if given for the frames read
+	if (stats && stats->size() <= _max(y.burst, _max(1, y.voice-5)))
+		stats = NULL;
+	
 	// mean(x(4,1:on)
 	double mean_3_pre_vot = 0.0;
-	for (int i = 0; i <= y.burst; i++)
-		mean_3_pre_vot += x.scores(i,3);
+	if (stats)
+		mean_3_pre_vot = stats->sum_3[y.burst];
+	else
+		for (int i = 0; i <= y.burst; i++)
+			mean_3_pre_vot += x.scores(i,3);
 	mean_3_pre_vot /= double(y.burst+1);
 	
 	// mean(x(5,on:off))
@@ -495,8 +605,11 @@ infra::vector_view Classifier::phi_pos(SpeechUtterance& x, VotLocation& y)
 	
 	// mean(x(5,1:on)
 	double mean_4_pre_vot = 0.0;
-	for (int i = 0; i <= y.burst; i++)
-		mean_4_pre_vot += x.scores(i,4);
+	if (stats)
+		mean_4_pre_vot = stats->sum_4[y.burst];
+	else
+		for (int i = 0; i <= y.burst; i++)
+			mean_4_pre_vot += x.scores(i,4);
 	mean_4_pre_vot /= double(y.burst+1);
 	
 	// v_i is 52
@@ -517,8 +630,11 @@ infra::vector_view Classifier::phi_pos(SpeechUtterance& x, VotLocation& y)
 	// initialize to -inf in case max is negative
 	v[v_i] = double(MISPAR_KATAN_MEOD);
 	max_i = _max(1,y.burst-5);
-	for (int i = 0; i <= max_i; i++)
-		v[v_i] = _max(x.scores(i,3), v[v_i]);
+	if (stats)
+		v[v_i] = stats->max_3[max_i];
+	else
+		for (int i = 0; i <= max_i; i++)
+			v[v_i] = _max(x.scores(i,3), v[v_i]);
 	v_i++;
 	
 	// v=[v; max(x(22,1:max(on-5,1)))];
@@ -526,30 +642,42 @@ infra::vector_view Classifier::phi_pos(SpeechUtterance& x, VotLocation& y)
 	// v_i is 55
 	// initialize to -inf in case max is negative
 	v[v_i] = double(MISPAR_KATAN_MEOD);
-	for (int i = 0; i <= max_i; i++)
-		v[v_i] = _max(x.scores(i,4), v[v_i]);
+	if (stats)
+		v[v_i] = stats->max_4[max_i];
+	else
+		for (int i = 0; i <= max_i; i++)
+			v[v_i] = _max(x.scores(i,4), v[v_i]);
 	v_i++;
 	
 	// v_i is 56
 	// % mean of high, WE from 1:burst-5
 	// v=[v; mean(x(4,1:max(on-5,1)))];
-	for (int i = 0; i <= max_i; i++)
-		v[v_i] += x.scores(i,3);
+	if (stats)
+		v[v_i] = stats->sum_3[max_i];
+	else
+		for (int i = 0; i <= max_i; i++)
+			v[v_i] += x.scores(i,3);
 	v[v_i] /= double(max_i+1);
 	v_i++;
 	
 	// v_i is 57
 	// v=[v; mean(x(5,1:max(on-5,1)))];
-	for (int i = 0; i <= max_i; i++)
-		v[v_i] += x.scores(i,4);
+	if (stats)
+		v[v_i] = stats->sum_4[max_i];
+	else
+		for (int i = 0; i <= max_i; i++)
+			v[v_i] += x.scores(i,4);
 	v[v_i] /= double(max_i+1);
 	v_i++;
 	
 	// v_i is 58
 	// v=[v; mean(x(8,1:max(off-5,1)))];
 	max_i = _max(1,y.voice-5);
-	for (int i = 0; i <= max_i; i++)
-		v[v_i] += x.scores(i,7);
+	if (stats)
+		v[v_i] = stats->sum_7[max_i];
+	else
+		for (int i = 0; i <= max_i; i++)
+			v[v_i] += x.scores(i,7);
 	v[v_i] /= double(max_i+1);
 	
 #if 0
@@ -595,10 +723,7 @@ infra::vector_view Classifier::phi_pos(SpeechUtterance& x, VotLocation& y)
 		v[ features_ignored[i] ] = 0.0;
 	
 	
-	infra::vector v2(kernel_phi_pos_size);
-	v2 = kernel.expand(v);
-
-	return v2;
+	return kernel.expand(v);
 }
 
 /************************************************************************
@@ -633,17 +758,16 @@ infra::vector_view Classifier::phi_neg(SpeechUtterance& x, VotLocation& y)
 	// diff_means(wiener_entropy, 5/10/15)
 	int burst_indices[] = {1,2,3,4,7,12,13,14,15,16,17,18,19,20,21,22,23}; //13 features
 	
+	static const std::vector<int> voice_slots =
+		point_feature_slots(voice_indices, int(sizeof(voice_indices)/sizeof(int)));
+	static const std::vector<int> burst_slots =
+		point_feature_slots(burst_indices, int(sizeof(burst_indices)/sizeof(int)));
+	
 	int v_i = 0;
 	
 	// v=[x(voiceInds,on); x(burstInds,off)];
-	for (int i = 0; i < int(sizeof(voice_indices)/sizeof(int)); i++) {
-		v[v_i] = x.scores(y.voice,voice_indices[i]);
-		v_i++;
-	}
-	for (int i = 0; i < int(sizeof(burst_indices)/sizeof(int)); i++) {
-		v[v_i] = x.scores(y.burst,burst_indices[i]);
-		v_i++;
-	}
+	gather_point_features(x, y.voice, voice_slots, v, v_i);
+	gather_point_features(x, y.burst, burst_slots, v, v_i);
 	
 	// average voicing voice to voice+10
 	for (int i = y.voice; i <= y.voice+10; i++)
@@ -972,44 +1096,51 @@ infra::vector_view Classifier::phi_neg(SpeechUtterance& x, VotLocation& y)
  ***********************************************************************/
 double Classifier::predict(SpeechUtterance& x, VotLocation &y_hat, bool pos_only)
 {
+	ProfileScope profile(PROFILE_PREDICT);
+	unsigned long num_candidates = 0;
 	double D_pos = MISPAR_KATAN_MEOD;
 	double D_neg = MISPAR_KATAN_MEOD;
 	double D;
 	
 	VotLocation y_hat_pos, y_hat_neg;
 	
-	int phi_span = 15;
+	PrefixStatistics stats;
+	stats.compute(x);
 	
-	int	max_onset = _min(max_onset_time, int(x.size()-min_vot_length-phi_span-1));
+	int	max_onset = _min(max_onset_time, int(x.size()-min_vot_length-PHI_SPAN));
 	
 	for (int onset = 0; onset < max_onset; onset++) {
-		int min_vot = _min(onset + min_vot_length, int(x.size()-phi_span-1));
-		int max_vot = _min(onset + max_vot_length, int(x.size()-phi_span-1));
+		int min_vot = _min(onset + min_vot_length, int(x.size()-PHI_SPAN));
+		int max_vot = _min(onset + max_vot_length, int(x.size()-PHI_SPAN));
+		if (max_vot >= min_vot) num_candidates += max_vot - min_vot + 1;
 		//std::cout << "onset= " << onset << " min_vot= " << min_vot << " max_vot= " << max_vot << " x.size= " << x.size() << std::endl;
 		for (int offset = min_vot; offset <= max_vot; offset++) {
 			VotLocation y_temp;
 			y_temp.burst = onset;
 			y_temp.voice = offset;
 
-			if (w_pos*phi_pos(x,y_temp) > D_pos) {
-				//std::cout << "burst= " << y_temp.burst << " voice= " << y_temp.voice << " wx=" << w_pos*phi_pos(x,y_temp) << std::endl;
+			// each score is computed once
+			double score_pos = w_pos*phi_pos(x,y_temp,&stats);
+			if (score_pos > D_pos) {
+				//std::cout << "burst= " << y_temp.burst << " voice= " << y_temp.voice << " wx=" << score_pos << std::endl;
 				y_hat_pos.burst = y_temp.burst;
 				y_hat_pos.voice = y_temp.voice;
-				D_pos = w_pos*phi_pos(x,y_temp);
+				D_pos = score_pos;
 			}
 			
 			if (!pos_only) {
 				y_temp.burst = offset;
 				y_temp.voice = onset;
-				if (w_neg*phi_neg(x,y_temp) > 1000 || w_neg*phi_neg(x,y_temp) < -1000) {
+				double score_neg = w_neg*phi_neg(x,y_temp);
+				if (score_neg > 1000 || score_neg < -1000) {
 				LOG(DEBUG) << "phi_neg(x,y_temp)=" << phi_neg(x,y_temp);
 				LOG(DEBUG) << "w_neg=" << w_neg;
-				LOG(DEBUG) << "w_neg*phi_neg(x,y_temp)=" << w_neg*phi_neg(x,y_temp);
+				LOG(DEBUG) << "w_neg*phi_neg(x,y_temp)=" << score_neg;
 				}
-				if (w_neg*phi_neg(x,y_temp) > D_neg) {
+				if (score_neg > D_neg) {
 					y_hat_neg.burst = y_temp.burst;
 					y_hat_neg.voice = y_temp.voice;
-					D_neg = w_neg*phi_neg(x,y_temp);
+					D_neg = score_neg;
 				}
 			}
 		}
@@ -1028,11 +1159,187 @@ double Classifier::predict(SpeechUtterance& x, VotLocation &y_hat, bool pos_only
 		LOG(DEBUG) << "Neg prediction: " << y_hat_neg.burst << " " << y_hat_neg.voice << " conf: " << D_neg;
 	}
 	LOG(DEBUG) << "Pos prediction: " << y_hat_pos.burst << " "	<< y_hat_pos.voice << " conf: " << D_pos;
+	Profiler::count(PROFILE_CANDIDATES, num_candidates);
 	
 	return ( D );
 	
 }
 
+/************************************************************************
+ Function:     Classifier::score
+ 
+ Description:  Score one candidate location
+ Inputs:       SpeechUtterance &x
+ VotLocation &y
+ bool neg - score y as a negative VOT
+ const PrefixStatistics *stats - see phi_pos
+ Output:       double
+ Comments:     Used to search the candidates incrementally, in another
+ order than predict().
+ ***********************************************************************/
+double Classifier::score(SpeechUtterance& x, VotLocation &y, bool neg,
+												 const PrefixStatistics *stats)
+{
+	if (neg)
+		return w_neg*phi_neg(x,y);
+	return w_pos*phi_pos(x,y,stats);
+}
+
+/************************************************************************
+ Function:     Classifier::same_candidates
+ 
+ Description:  Check if two classifiers search the same candidates with
+               the same features
+ Inputs:       Classifier &other
+ Output:       bool - true if phi of both is the same for every candidate
+ Comments:     none.
+ ***********************************************************************/
+bool Classifier::same_candidates(Classifier &other)
+{
+	return (min_vot_length == other.min_vot_length &&
+					max_vot_length == other.max_vot_length &&
+					max_onset_time == other.max_onset_time &&
+					kernel.get_kernel_name() == other.kernel.get_kernel_name() &&
+					kernel.get_sigma() == other.kernel.get_sigma() &&
+					features_ignored == other.features_ignored);
+}
+
+/************************************************************************
+ Function:     Classifier::predict_models
+ 
+ Description:  Predict label of instance x with several classifiers
+ Inputs:       vector<Classifier*> &models
+               vector<bool> &pos_only - of each model
+               SpeechUtterance &x
+               vector<VotLocation> &y_hat - the prediction of each model
+               vector<double> &confidence - of each model
+ Output:       none.
+ Comments:     The models are grouped by same_candidates(). The features
+               of a candidate are computed once per group and scored
+               against all the weights of the group. The predictions are
+               those of predict() of each model.
+ ***********************************************************************/
+void Classifier::predict_models(std::vector<Classifier*> &models, std::vector<bool> &pos_only,
+																SpeechUtterance& x, std::vector<VotLocation> &y_hat,
+																std::vector<double> &confidence)
+{
+	ProfileScope profile(PROFILE_PREDICT);
+	y_hat.resize(models.size());
+	confidence.resize(models.size());
+	std::vector<bool> done(models.size(), false);
+	for (unsigned int m = 0; m < models.size(); m++) {
+		if (done[m]) continue;
+		std::vector<unsigned int> group;
+		for (unsigned int k = m; k < models.size(); k++) {
+			if (!done[k] && models[m]->same_candidates(*models[k])) {
+				group.push_back(k);
+				done[k] = true;
+			}
+		}
+		models[m]->predict_group(models, group, pos_only, x, y_hat, confidence);
+	}
+}
+
+/************************************************************************
+ Function:     Classifier::predict_group
+ 
+ Description:  Predict label of instance x with a group of classifiers
+               that have the same candidates as this one
+ Inputs:       vector<Classifier*> &models
+               vector<unsigned int> &group - indices of the group in models
+               vector<bool> &pos_only, SpeechUtterance &x,
+               vector<VotLocation> &y_hat, vector<double> &confidence - as
+               in predict_models()
+ Output:       none.
+ Comments:     For each onset the features of all its offsets are stacked
+               in a matrix and multiplied by the stacked weights, so all
+               scores of the onset are one matrix product. The candidates
+               are visited in the order of predict().
+ ***********************************************************************/
+void Classifier::predict_group(std::vector<Classifier*> &models, std::vector<unsigned int> &group,
+															 std::vector<bool> &pos_only, SpeechUtterance& x,
+															 std::vector<VotLocation> &y_hat, std::vector<double> &confidence)
+{
+	unsigned int num_models = group.size();
+	
+	// one row of weights per model
+	bool any_neg = false;
+	infra::matrix W_pos(num_models, kernel_phi_pos_size);
+	infra::matrix W_neg(num_models, phi_neg_size);
+	for (unsigned int g = 0; g < num_models; g++) {
+		W_pos.row(g) = models[group[g]]->w_pos;
+		W_neg.row(g) = models[group[g]]->w_neg;
+		if (!pos_only[group[g]]) any_neg = true;
+	}
+	
+	std::vector<double> D_pos(num_models, MISPAR_KATAN_MEOD);
+	std::vector<double> D_neg(num_models, MISPAR_KATAN_MEOD);
+	std::vector<VotLocation> y_hat_pos(num_models), y_hat_neg(num_models);
+	
+	int	max_onset = _min(max_onset_time, int(x.size()-min_vot_length-PHI_SPAN));
+	
+	// features of the offsets of one onset, one row per offset
+	unsigned long max_offsets = _max(max_vot_length - min_vot_length + 1, 1);
+	infra::matrix phi_x_pos(max_offsets, kernel_phi_pos_size);
+	infra::matrix phi_x_neg(max_offsets, phi_neg_size);
+	infra::matrix scores_pos(max_offsets, num_models);
+	infra::matrix scores_neg(max_offsets, num_models);
+	
+	PrefixStatistics stats;
+	stats.compute(x);
+	
+	for (int onset = 0; onset < max_onset; onset++) {
+		int min_vot = _min(onset + min_vot_length, int(x.size()-PHI_SPAN));
+		int max_vot = _min(onset + max_vot_length, int(x.size()-PHI_SPAN));
+		if (max_vot < min_vot) continue;
+		unsigned long num_offsets = max_vot - min_vot + 1;
+		Profiler::count(PROFILE_CANDIDATES, num_offsets*num_models);
+		for (int offset = min_vot; offset <= max_vot; offset++) {
+			VotLocation y_temp;
+			y_temp.burst = onset;
+			y_temp.voice = offset;
+			phi_x_pos.row(offset - min_vot) = phi_pos(x,y_temp,&stats);
+			if (any_neg) {
+				y_temp.burst = offset;
+				y_temp.voice = onset;
+				phi_x_neg.row(offset - min_vot) = phi_neg(x,y_temp);
+			}
+		}
+		infra::matrix_base s_pos = scores_pos.submatrix(0, 0, num_offsets, num_models);
+		infra::prod_t(phi_x_pos.submatrix(0, 0, num_offsets, kernel_phi_pos_size), W_pos, s_pos);
+		infra::matrix_base s_neg = scores_neg.submatrix(0, 0, num_offsets, num_models);
+		if (any_neg)
+			infra::prod_t(phi_x_neg.submatrix(0, 0, num_offsets, phi_neg_size), W_neg, s_neg);
+		
+		for (unsigned long i = 0; i < num_offsets; i++) {
+			int offset = min_vot + i;
+			for (unsigned int g = 0; g < num_models; g++) {
+				if (s_pos(i,g) > D_pos[g]) {
+					y_hat_pos[g].burst = onset;
+					y_hat_pos[g].voice = offset;
+					D_pos[g] = s_pos(i,g);
+				}
+				if (!pos_only[group[g]] && s_neg(i,g) > D_neg[g]) {
+					y_hat_neg[g].burst = offset;
+					y_hat_neg[g].voice = onset;
+					D_neg[g] = s_neg(i,g);
+				}
+			}
+		}
+	}
+	
+	for (unsigned int g = 0; g < num_models; g++) {
+		unsigned int m = group[g];
+		if (pos_only[m] || D_neg[g] < D_pos[g]) {
+			confidence[m] = D_pos[g];
+			y_hat[m] = y_hat_pos[g];
+		} else {
+			confidence[m] = D_neg[g];
+			y_hat[m] = y_hat_neg[g];
+		}
+	}
+}
+
 /************************************************************************
  Function:     Classifier::predict_epsilon
  
@@ -1045,12 +1352,15 @@ double Classifier::predict(SpeechUtterance& x, VotLocation &y_hat, bool pos_only
 double Classifier::predict_epsilon(SpeechUtterance& x, VotLocation &y_hat,
 																	 VotLocation &y, double epsilon, bool vot_loss, bool pos_only)
 {
+	ProfileScope profile(PROFILE_PREDICT);
 	double D_pos = MISPAR_KATAN_MEOD;
 	double D_neg = MISPAR_KATAN_MEOD;
 	double D;
 	
 	VotLocation y_hat_pos, y_hat_neg;
 	
+	PrefixStatistics stats;
+	stats.compute(x);
 	
 	// changed 3/29/10 for (0,length-1) basis
 	int	max_onset = _min(max_onset_time, int(x.size()-1));
@@ -1059,6 +1369,7 @@ double Classifier::predict_epsilon(SpeechUtterance& x, VotLocation &y_hat,
 	for (int onset = 0; onset < max_onset; onset++) {
 		int min_vot = _min(onset + min_vot_length, int(x.size()-1));
 		int max_vot = _min(onset + max_vot_length, int(x.size()-1));
+		if (max_vot >= min_vot) Profiler::count(PROFILE_CANDIDATES, max_vot - min_vot + 1);
 		//    for (int offset = min_vot; offset < max_vot; offset++) {
 		for (int offset = min_vot; offset <= max_vot; offset++) {
 			VotLocation y_temp;
@@ -1069,11 +1380,12 @@ double Classifier::predict_epsilon(SpeechUtterance& x, VotLocation &y_hat,
 				my_loss = loss_vot(y_temp,y) ;
 			else
 				my_loss = loss(y_temp,y);
-			if (w_pos*phi_pos(x,y_temp) - epsilon*my_loss > D_pos) {
+			double score_pos = w_pos*phi_pos(x,y_temp,&stats) - epsilon*my_loss;
+			if (score_pos > D_pos) {
 				//std::cout << "wx=" << w*phi(x,y_temp) << " (-eps)=" << -epsilon*loss(y_temp,y) << std::endl;
 				y_hat_pos.burst = y_temp.burst;
 				y_hat_pos.voice = y_temp.voice;
-				D_pos = w_pos*phi_pos(x,y_temp) - epsilon*my_loss;
+				D_pos = score_pos;
 			}
 			
 			if (!pos_only) {
@@ -1084,10 +1396,11 @@ double Classifier::predict_epsilon(SpeechUtterance& x, VotLocation &y_hat,
 					my_loss = loss_vot(y_temp,y) ;
 				else
 					my_loss = loss(y_temp,y);
-				if (w_neg*phi_neg(x,y_temp) - epsilon*my_loss > D_neg) {
+				double score_neg = w_neg*phi_neg(x,y_temp) - epsilon*my_loss;
+				if (score_neg > D_neg) {
 					y_hat_neg.burst = y_temp.burst;
 					y_hat_neg.voice = y_temp.voice;
-					D_neg = w_neg*phi_neg(x,y_temp) - epsilon*my_loss;
+					D_neg = score_neg;
 				}
 			}
 		}
@@ -1105,6 +1418,140 @@ double Classifier::predict_epsilon(SpeechUtterance& x, VotLocation &y_hat,
 	return ( D );
 }
 
+/************************************************************************
+ Function:     Classifier::predict_epsilon
+ 
+ Description:  Predict label of instance x from its cached candidate features
+ Inputs:       CandidateFeatures &cf
+ VotLocation &y_hat
+ Output:       double
+ Comments:     Same as predict_epsilon() above, but w*phi is taken against
+               the feature rows stored by cache_candidates(). The candidates
+               are visited in the same order, so the outcome is identical.
+ ***********************************************************************/
+double Classifier::predict_epsilon(CandidateFeatures& cf, VotLocation &y_hat,
+																	 VotLocation &y, double epsilon, bool vot_loss, bool pos_only)
+{
+	ProfileScope profile(PROFILE_PREDICT);
+	double D_pos = MISPAR_KATAN_MEOD;
+	double D_neg = MISPAR_KATAN_MEOD;
+	double D;
+	
+	VotLocation y_hat_pos, y_hat_neg;
+	
+	const double *w_pos_ptr = w_pos.begin().ptr();
+	const double *w_neg_ptr = w_neg.begin().ptr();
+	Profiler::count(PROFILE_CANDIDATES, cf.size());
+	
+	for (unsigned long c = 0; c < cf.size(); c++) {
+		VotLocation y_temp = cf.candidates[c];
+		double my_loss = 0.0;
+		if (vot_loss)
+			my_loss = loss_vot(y_temp,y) ;
+		else
+			my_loss = loss(y_temp,y);
+		const double *phi_x_y = cf.pos_row(c);
+		double score = infra::simd::dot(w_pos_ptr, 1, phi_x_y, 1, kernel_phi_pos_size);
+		score -= epsilon*my_loss;
+		if (score > D_pos) {
+			y_hat_pos = y_temp;
+			D_pos = score;
+		}
+		
+		if (!pos_only) {
+			y_temp.burst = cf.candidates[c].voice;
+			y_temp.voice = cf.candidates[c].burst;
+			my_loss = 0.0;
+			if (vot_loss)
+				my_loss = loss_vot(y_temp,y) ;
+			else
+				my_loss = loss(y_temp,y);
+			phi_x_y = cf.neg_row(c);
+			score = infra::simd::dot(w_neg_ptr, 1, phi_x_y, 1, phi_neg_size);
+			score -= epsilon*my_loss;
+			if (score > D_neg) {
+				y_hat_neg = y_temp;
+				D_neg = score;
+			}
+		}
+	}
+	
+	if (pos_only || D_neg < D_pos) {
+		D = D_pos;
+		y_hat = y_hat_pos;
+	} else {
+		D = D_neg;
+		y_hat = y_hat_neg;
+	}
+	
+	LOG(DEBUG) << "D_neg=" << D_neg << " D_pos=" << D_pos;
+	return ( D );
+}
+
+/************************************************************************
+ Function:     Classifier::cache_candidates
+ 
+ Description:  Compute and store the features of all candidates of x
+ Inputs:       SpeechUtterance &x
+ unsigned long index - position of x in the training set
+ CandidateFeaturesCache &cache
+ bool pos_only
+ Output:       CandidateFeatures* - the cached features, or NULL if they
+               do not fit in the cache
+ Comments:     The candidates are enumerated as in predict_epsilon(). The
+               features depend only on x, so they are valid as long as
+               the kernel and the ignored features are unchanged.
+ ***********************************************************************/
+CandidateFeatures *Classifier::cache_candidates(SpeechUtterance& x, unsigned long index,
+																								CandidateFeaturesCache& cache, bool pos_only)
+{
+	int	max_onset = _min(max_onset_time, int(x.size()-1));
+	
+	unsigned long num_candidates = 0;
+	for (int onset = 0; onset < max_onset; onset++) {
+		int min_vot = _min(onset + min_vot_length, int(x.size()-1));
+		int max_vot = _min(onset + max_vot_length, int(x.size()-1));
+		if (max_vot >= min_vot)
+			num_candidates += max_vot - min_vot + 1;
+	}
+	
+	CandidateFeatures *cf = cache.add(index, num_candidates, kernel_phi_pos_size,
+																		pos_only ? 0 : phi_neg_size);
+	if (cf == NULL)
+		return NULL;
+	
+	PrefixStatistics stats;
+	stats.compute(x);
+	
+	for (int onset = 0; onset < max_onset; onset++) {
+		int min_vot = _min(onset + min_vot_length, int(x.size()-1));
+		int max_vot = _min(onset + max_vot_length, int(x.size()-1));
+		for (int offset = min_vot; offset <= max_vot; offset++) {
+			VotLocation y_temp;
+			y_temp.burst = onset;
+			y_temp.voice = offset;
+			unsigned long c = cf->size();
+			cf->candidates.push_back(y_temp);
+			
+			infra::vector_view v = phi_pos(x,y_temp,&stats);
+			double *row = cf->pos_row(c);
+			for (int k = 0; k < kernel_phi_pos_size; k++)
+				row[k] = v[k];
+			
+			if (!pos_only) {
+				y_temp.burst = offset;
+				y_temp.voice = onset;
+				infra::vector_view v_neg = phi_neg(x,y_temp);
+				row = cf->neg_row(c);
+				for (int k = 0; k < phi_neg_size; k++)
+					row[k] = v_neg[k];
+			}
+		}
+	}
+	
+	return cf;
+}
+
 /************************************************************************
  Function:     loss
  
@@ -1155,10 +1602,26 @@ double Classifier::loss_vot(const VotLocation &y, const VotLocation &y_hat)
  Description:  Loads a classifier
  Inputs:       string & filename
  Output:       none.
- Comments:     none.
+ Comments:     Either a binary model file or the text files
+               <filename>.pos and <filename>.neg.
  ***********************************************************************/
 void Classifier::load(std::string &filename)
 {
+	if (is_model_file(filename)) {
+		infra::vector pos, neg;
+		if (!read_model_file(filename, model_info, &pos, &neg))
+			exit(-1);
+		if (int(pos.size()) != kernel_phi_pos_size || int(neg.size()) != phi_neg_size) {
+			LOG(ERROR) << filename << " has weights of size " << pos.size() << "+" << neg.size()
+			<< " (kernel expansion \"" << model_info.kernel_expansion << "\"), the classifier expects "
+			<< kernel_phi_pos_size << "+" << phi_neg_size;
+			exit(-1);
+		}
+		w_pos = pos;
+		w_neg = neg;
+		return;
+	}
+
 	std::ifstream ifs;
 	
 	// pos
@@ -1189,10 +1652,18 @@ void Classifier::load(std::string &filename)
  Description:  Saves a classifier 
  Inputs:       string & filename
  Output:       none.
- Comments:     none.
+ Comments:     A binary model file if set_model_info() was called,
+               otherwise the text files
+               <filename>.pos and <filename>.neg.
  ***********************************************************************/
 void Classifier::save(std::string &filename)
 {
+	if (binary_model) {
+		if (!write_model_file(filename, model_info, w_pos, w_neg))
+			exit(-1);
+		return;
+	}
+
 	std::ofstream ifs;
 	
 	std::string filename_pos = filename + ".pos";
@@ -1219,17 +1690,84 @@ void Classifier::save(std::string &filename)
  Function:     Classifier::w_star_mean
  
  Description:  Set w to mean of all w_i, and print w
- Inputs:       string & filename
+ Inputs:       int &N - number of examples to average over
  Output:       none.
- Comments:     none.
+ Comments:     The sum of all w_i is num_averaged_examples*w minus the
+               accumulated time-weighted updates (see update()).
  ***********************************************************************/
 void Classifier::w_star_mean(int &N)
 {
-	w_pos = w_pos_sum/N; 
+	w_pos = (w_pos * double(num_averaged_examples) - w_pos_sum) / double(N);
 	LOG(DEBUG) << "w_pos_star = " << w_pos ;
 	
-	w_neg = w_neg_sum/N; 
+	w_neg = (w_neg * double(num_averaged_examples) - w_neg_sum) / double(N);
 	LOG(DEBUG) << "w_neg_star = " << w_neg ;
 }
 
+/************************************************************************
+ Function:     Classifier::get_w
+ 
+ Description:  Copy the current weights
+ Inputs:       infra::vector &pos, infra::vector &neg
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+void Classifier::get_w(infra::vector &pos, infra::vector &neg)
+{
+	pos.resize(w_pos.size());
+	pos = w_pos;
+	neg.resize(w_neg.size());
+	neg = w_neg;
+}
+
+/************************************************************************
+ Function:     Classifier::set_w
+ 
+ Description:  Replace the current weights
+ Inputs:       infra::vector_base &pos, infra::vector_base &neg
+ Output:       none.
+ Comments:     The averaging state is not changed (see reset_averaging).
+ ***********************************************************************/
+void Classifier::set_w(const infra::vector_base &pos, const infra::vector_base &neg)
+{
+	if (pos.size() != w_pos.size() || neg.size() != w_neg.size()) {
+		LOG(ERROR) << "Weights of size " << pos.size() << "+" << neg.size()
+		<< " do not match the classifier (" << w_pos.size() << "+" << w_neg.size() << ")";
+		exit(-1);
+	}
+	w_pos = pos;
+	w_neg = neg;
+}
+
+/************************************************************************
+ Function:     Classifier::get_w_sum
+ 
+ Description:  Sum of all w_i since the last reset_averaging()
+ Inputs:       infra::vector &pos, infra::vector &neg
+ Output:       none.
+ Comments:     see w_star_mean.
+ ***********************************************************************/
+void Classifier::get_w_sum(infra::vector &pos, infra::vector &neg)
+{
+	pos.resize(w_pos.size());
+	pos = w_pos * double(num_averaged_examples) - w_pos_sum;
+	neg.resize(w_neg.size());
+	neg = w_neg * double(num_averaged_examples) - w_neg_sum;
+}
+
+/************************************************************************
+ Function:     Classifier::reset_averaging
+ 
+ Description:  Start a new average of the w_i from the current w
+ Inputs:       none.
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+void Classifier::reset_averaging()
+{
+	w_pos_sum.zeros();
+	w_neg_sum.zeros();
+	num_averaged_examples = 0;
+}
+
 // --------------------- EOF ------------------------------------//
@@ -35,6 +35,37 @@ License along with Autovot.  If not, see
 #include "infra.h"
 #include "Dataset.h"
 #include "KernelExpansion.h"
+#include "CandidateFeatures.h"
+#include "ModelFile.h"
+
+// Frames from the voice onset of a candidate to the last frame phi_pos()
+// and phi_neg() read, the onset included: the local differences look 15
+// frames ahead. predict() scores no candidate in an utterance of
+// min_vot_length + PHI_SPAN frames or fewer.
+#define PHI_SPAN 16
+
+// Prefix sums and maxima of the rows phi_pos() reads from the first frame
+// of the utterance (3, 4 and 7), so those statistics cost the same for
+// every candidate. Element i covers frames 0..i, accumulated in the order
+// of the loops of phi_pos(), which give the same values.
+class PrefixStatistics
+  {
+  public:
+    PrefixStatistics() { }
+    void reset();
+    // add the frames size()..last of x, which must be final
+    void extend(SpeechUtterance& x, int last);
+    // the statistics of all the frames of x
+    void compute(SpeechUtterance& x) { reset(); extend(x, int(x.size())-1); }
+    int size() const { return int(sum_3.size()); }
+    
+  public:
+    std::vector<double> sum_3;
+    std::vector<double> sum_4;
+    std::vector<double> sum_7;
+    std::vector<double> max_3;
+    std::vector<double> max_4;
+  };
 
 class Classifier
   {
@@ -46,27 +77,57 @@ class Classifier
     void load(std::string &filename);
     void save(std::string &filename);
     bool was_changed() { return (w_changed); }
-		double update( SpeechUtterance& x, VotLocation y, VotLocation &y_hat, bool vot_loss) ;
+		double update( SpeechUtterance& x, VotLocation y, VotLocation &y_hat, bool vot_loss,
+		               bool stale_y_hat=false) ;
     double update_direct_loss(SpeechUtterance& x, VotLocation &y_hat_eps, 
                               VotLocation &y_hat, VotLocation &y,
                               double epsilon);
     double predict(SpeechUtterance& x, VotLocation &y_hat, bool pos_only=false);
+    // the score predict() gives to one candidate, with phi_neg if neg
+    double score(SpeechUtterance& x, VotLocation &y, bool neg,
+                 const PrefixStatistics *stats=NULL);
+    static void predict_models(std::vector<Classifier*> &models, std::vector<bool> &pos_only,
+                               SpeechUtterance& x, std::vector<VotLocation> &y_hat,
+                               std::vector<double> &confidence);
+    bool same_candidates(Classifier &other);
     double predict_epsilon(SpeechUtterance& x, VotLocation &y_hat,
                            VotLocation &y, double epsilon, bool vot_loss, bool pos_only=false);
+    double predict_epsilon(CandidateFeatures& cf, VotLocation &y_hat,
+                           VotLocation &y, double epsilon, bool vot_loss, bool pos_only=false);
+    CandidateFeatures *cache_candidates(SpeechUtterance& x, unsigned long index,
+                                        CandidateFeaturesCache& cache, bool pos_only=false);
     double mean_diff_feature_template(SpeechUtterance& x, int feature_index,
                                       int t, int shift, int window);
     infra::vector_view phi(SpeechUtterance& x, VotLocation& y);
-    infra::vector_view phi_pos(SpeechUtterance& x, VotLocation& y);
+    // stats, if not NULL, are those of the frames of x so far
+    infra::vector_view phi_pos(SpeechUtterance& x, VotLocation& y,
+                               const PrefixStatistics *stats=NULL);
     infra::vector_view phi_neg(SpeechUtterance& x, VotLocation& y);
     double loss(const VotLocation &y, const VotLocation &y_hat);
     double loss_vot(const VotLocation &y, const VotLocation &y_hat);
     int get_phi_size_pos() { return(phi_pos_size); }
     int get_phi_size_neg() { return(phi_neg_size); }
     void w_star_mean(int &N);
+    void get_w(infra::vector &pos, infra::vector &neg);
+    void set_w(const infra::vector_base &pos, const infra::vector_base &neg);
+    void get_w_sum(infra::vector &pos, infra::vector &neg);
+    void reset_averaging();
+    int get_kernel_phi_size_pos() { return(kernel_phi_pos_size); }
+    int get_min_vot_length() { return(min_vot_length); }
+    int get_max_vot_length() { return(max_vot_length); }
+    int get_max_onset_time() { return(max_onset_time); }
     void print_w() { std::cout << "w_pos=" << w_pos << " w_neg=" << w_neg << std::endl; }
     void ignore_features(std::string &ignore_features_str);
+    // save() writes a binary model file with this info (see ModelFile.h)
+    void set_model_info(const ModelInfo &info) { model_info = info; binary_model = true; }
+    const ModelInfo &get_model_info() { return(model_info); }
     
   protected:
+    double w_prod(const infra::vector_base &v_pos, const infra::vector_base &v_neg);
+    void predict_group(std::vector<Classifier*> &models, std::vector<unsigned int> &group,
+                       std::vector<bool> &pos_only, SpeechUtterance& x,
+                       std::vector<VotLocation> &y_hat, std::vector<double> &confidence);
+
     static int phi_pos_size;
     static int phi_neg_size;
     int phi_size;
@@ -81,12 +142,17 @@ class Classifier
     double min_loss_update;
     infra::vector w_pos;
     infra::vector w_neg;
+    // time-weighted sums of the updates, sum_t (t-1)*delta_t, used for
+    // lazy averaging of the w_i (see w_star_mean)
     infra::vector w_pos_sum;
     infra::vector w_neg_sum;
+    int num_averaged_examples;
     bool w_changed;
     std::vector<int> features_ignored;
 		KernelExpansion kernel;
 		int kernel_phi_pos_size;
+    ModelInfo model_info;
+    bool binary_model;
   };
 
 #endif // _CLASSIFIER_H
@@ -30,7 +30,9 @@ License along with Autovot.  If not, see
 #include <fstream>
 #include <stdio.h>
 #include <string.h>
+#include <sys/stat.h>
 #include "Dataset.h"
+#include "Profiler.h"
 #include "Logger.h"
 
 /************************************************************************
@@ -162,17 +164,26 @@ void NewInstances::read(std::string &filename, bool labels_given)
 void SpeechUtterance::read(std::string &filename)
 {
   // load score matrix
+  ProfileScope profile(PROFILE_FEATURE_PARSE);
   std::ifstream ifs(filename.c_str());
   if (ifs.good()) {
+    if (Profiler::enabled()) {
+      struct stat st;
+      if (stat(filename.c_str(), &st) == 0)
+        Profiler::count(PROFILE_BYTES_READ, st.st_size);
+    }
     infra::matrix tmp(ifs);
-    scores.resize(tmp.height(), tmp.width());
+    score_matrix.resize(tmp.height(), tmp.width());
     ///std::cout << "tmp_before=" << tmp << std::endl;
     //tmp.submatrix(0,43,tmp.height(),tmp.width()-43).zeros(); // works
     //tmp.submatrix(0,47,tmp.height(),tmp.width()-47).zeros(); // does not work
     //tmp.submatrix(0,43,tmp.height(),4).zeros(); // ??
     ///std::cout << "tmp_after=" << tmp << std::endl;
     //std::cout << "Debug: using only the first 43 features" << std::endl;
-    scores = tmp;
+    score_matrix = tmp;
+    pack();
+    Profiler::count(PROFILE_UTTERANCES, 1);
+    Profiler::count(PROFILE_FRAMES, size());
   }
   else {
     LOG(ERROR) << "Unable to read instance from " << filename;
@@ -180,6 +191,104 @@ void SpeechUtterance::read(std::string &filename)
 }
 
 
+// burst columns of phi_pos, the rest of its voice columns, and the column
+// phi_neg reads in addition
+const int point_feature_columns[NUM_POINT_FEATURES] = {
+  1,3,4,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,
+  2,5,33,34,35,60,61,62,
+  7
+};
+
+/************************************************************************
+ Function:     point_feature_slots
+
+ Description:  Find the columns of the scores in the point features
+ Inputs:       none.
+ Output:       std::vector<int> - the slot of each column, -1 if absent
+ Comments:     see point_feature_columns
+ ***********************************************************************/
+static std::vector<int> point_feature_slots()
+{
+  int num_columns = 0;
+  for (int k = 0; k < NUM_POINT_FEATURES; k++)
+    if (point_feature_columns[k] >= num_columns)
+      num_columns = point_feature_columns[k]+1;
+  std::vector<int> slots(num_columns, -1);
+  for (int k = 0; k < NUM_POINT_FEATURES; k++)
+    slots[point_feature_columns[k]] = k;
+  return slots;
+}
+
+/************************************************************************
+ Function:     point_feature_slot
+
+ Description:  Find a column of the scores in the point features
+ Inputs:       unsigned long feature - the column
+ Output:       int - its slot in PointFeatures, -1 if it is not packed
+ Comments:     none.
+ ***********************************************************************/
+int point_feature_slot(unsigned long feature)
+{
+  static const std::vector<int> slots = point_feature_slots();
+  return feature < slots.size() ? slots[feature] : -1;
+}
+
+/************************************************************************
+ Function:     SpeechUtterance::resize
+
+ Description:  Resize the scores and the point features, all zero
+ Inputs:       unsigned long frames, unsigned long features
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+void SpeechUtterance::resize(unsigned long frames, unsigned long features)
+{
+  score_matrix.resize(frames, features);
+  score_matrix.zeros();
+  packed.assign(frames, PointFeatures());
+}
+
+/************************************************************************
+ Function:     SpeechUtterance::set
+
+ Description:  Write the score of a feature at a frame
+ Inputs:       unsigned long frame, unsigned long feature, double value
+ Output:       none.
+ Comments:     Writes the point features too, so they never go stale.
+ ***********************************************************************/
+void SpeechUtterance::set(unsigned long frame, unsigned long feature,
+                          double value)
+{
+  score_matrix(frame, feature) = value;
+  int slot = point_feature_slot(feature);
+  if (slot >= 0)
+    packed[frame].value[slot] = value;
+}
+
+/************************************************************************
+ Function:     SpeechUtterance::pack
+
+ Description:  Copy the point features of all frames out of the scores
+ Inputs:       none.
+ Output:       none.
+ Comments:     Columns past the width of the scores are left zero.
+ ***********************************************************************/
+void SpeechUtterance::pack()
+{
+  unsigned long num_frames = size();
+  packed.assign(num_frames, PointFeatures());
+  if (num_frames == 0)
+    return;
+  // one contiguous column at a time
+  for (int k = 0; k < NUM_POINT_FEATURES; k++) {
+    if ((unsigned long)point_feature_columns[k] >= dim())
+      continue;
+    const double *column = &score_matrix(0, point_feature_columns[k]);
+    for (unsigned long f = 0; f < num_frames; f++)
+      packed[f].value[k] = column[f];
+  }
+}
+
 /************************************************************************
  Function:     operator << for VotLocation
  
@@ -69,15 +69,45 @@ typedef std::vector<double> DoubleVector;
 
 /***********************************************************************/
 
+// The point features of a frame, the columns of the scores that phi_pos()
+// and phi_neg() read at the burst or voice frame only, in the order of
+// point_feature_columns (the burst columns of phi_pos first). A frame is
+// 256 bytes, four cache lines, and starts on a cache line.
+#define NUM_POINT_FEATURES 27
+#define POINT_FEATURES_STRIDE 32
+
+extern const int point_feature_columns[NUM_POINT_FEATURES];
+int point_feature_slot(unsigned long feature);
+
+struct alignas(64) PointFeatures {
+  double value[POINT_FEATURES_STRIDE];
+};
+
 class SpeechUtterance
 {
 public:
   void read(std::string &filename);
-  unsigned long size() { return scores.height(); }  
-  unsigned long dim() { return scores.width(); } 
+  unsigned long size() const { return score_matrix.height(); }  
+  unsigned long dim() const { return score_matrix.width(); } 
+
+  // Resize to frames x features, all zero
+  void resize(unsigned long frames, unsigned long features);
+  // The score of a feature at a frame
+  double scores(unsigned long frame, unsigned long feature) const {
+    return score_matrix(frame, feature);
+  }
+  // Write a score; the point features are kept up to date
+  void set(unsigned long frame, unsigned long feature, double value);
+  // The point features of a frame, see point_feature_columns
+  const double* point_features(unsigned long frame) const {
+    return packed[frame].value;
+  }
   
-public:
-  infra::matrix scores;
+private:
+  void pack();
+
+  infra::matrix score_matrix;         // frames x features, column-major
+  std::vector<PointFeatures> packed;  // frames, in model order
 };
 
 /***********************************************************************/
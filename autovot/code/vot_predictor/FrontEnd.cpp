@@ -0,0 +1,760 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+/************************************************************************
+ Project:  VOT Detection front end
+ Module:   FrontEnd
+ Purpose:  Acoustic features of a window of speech
+ Date:     19 Oct., 2026
+
+ **************************** INCLUDE FILES *****************************/
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <functional>
+#include <memory>
+#include "FrontEnd.h"
+#include "Profiler.h"
+#include "Logger.h"
+#include "infra_dsp.h"
+#include "get_f0s.h"
+#include "WavFile.h"
+
+#define LOG_NATURAL(x) (((x) < 1.0E-20) ? -99.9900 : log(x))
+
+// get_f0s_main() keeps its state in static variables
+static std::mutex rapt_mutex;
+
+// threads of extract_features(), see set_front_end_threads()
+static std::atomic<unsigned int> num_front_end_threads(1);
+
+// temporaries of extract_features() in arenas, see set_front_end_arenas()
+static std::atomic<bool> use_front_end_arenas(true);
+
+// fewer frames are not worth a task of their own
+#define MIN_FRAMES_PER_TASK 64
+
+/************************************************************************
+ Function:     set_front_end_threads
+
+ Description:  Set the number of threads of extract_features()
+ Inputs:       unsigned int num_threads - 1 or less for none but the
+               calling thread
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+void set_front_end_threads(unsigned int num_threads)
+{
+	num_front_end_threads = (num_threads < 1) ? 1 : num_threads;
+}
+
+/************************************************************************
+ Function:     front_end_threads
+
+ Description:  The number of threads of extract_features()
+ Inputs:       none.
+ Output:       unsigned int
+ Comments:     none.
+ ***********************************************************************/
+unsigned int front_end_threads()
+{
+	return num_front_end_threads;
+}
+
+/************************************************************************
+ Function:     set_front_end_arenas
+
+ Description:  Take the temporary vectors and matrices of
+               extract_features() from arenas, or from the heap
+ Inputs:       bool use_arenas
+ Output:       none.
+ Comments:     The features are the same either way.
+ ***********************************************************************/
+void set_front_end_arenas(bool use_arenas)
+{
+	use_front_end_arenas = use_arenas;
+}
+
+/************************************************************************
+ Function:     front_end_arenas
+
+ Description:  The arenas of the threads of extract_features()
+ Inputs:       unsigned int num_threads
+ Output:       std::vector<infra::arena*> - one per thread, the calling
+               one first, or none if the temporaries are on the heap
+ Comments:     The arenas belong to the calling thread, which keeps them
+               from one window to the next, so that concurrent calls of
+               extract_features() from several threads have their own.
+ ***********************************************************************/
+static std::vector<infra::arena*> front_end_arenas(unsigned int num_threads)
+{
+	static thread_local std::vector< std::unique_ptr<infra::arena> > arenas;
+
+	std::vector<infra::arena*> in_use;
+	if (!use_front_end_arenas)
+		return in_use;
+	while (arenas.size() < num_threads)
+		arenas.push_back(std::unique_ptr<infra::arena>(new infra::arena));
+	for (unsigned int t = 0; t < num_threads; t++)
+		in_use.push_back(arenas[t].get());
+	return in_use;
+}
+
+/************************************************************************
+ Function:     run_tasks
+
+ Description:  Run independent tasks concurrently
+ Inputs:       std::vector<std::function<void()> > &tasks
+               unsigned int num_threads - threads running them, the
+               calling one included
+               std::vector<infra::arena*> &arenas - of each thread, the
+               calling one first, or empty for the heap
+ Output:       none.
+ Comments:     The tasks are taken in order by the first free thread, so
+               the longest should come first. With a single thread they
+               run in order on the calling one.
+ ***********************************************************************/
+static void run_tasks(std::vector< std::function<void()> > &tasks, unsigned int num_threads,
+											const std::vector<infra::arena*> &arenas)
+{
+	std::atomic<size_t> next_task(0);
+	auto worker = [&](size_t t) {
+		infra::arena::scope arena_scope(t < arenas.size() ? arenas[t] : NULL);
+		size_t i;
+		while ((i = next_task.fetch_add(1)) < tasks.size())
+			tasks[i]();
+	};
+
+	std::vector<std::thread> workers;
+	for (size_t t = 1; t < num_threads && t < tasks.size(); t++)
+		workers.push_back(std::thread(worker, t));
+	worker(0);
+	for (size_t t = 0; t < workers.size(); t++)
+		workers[t].join();
+}
+
+// The voicing decisions of a pitch tracker as intervals of samples:
+// frame j of the tracker covers RAPT_PITCH_FRAME_STEP from half a step
+// after j steps on, up to where frame j+1 starts, within the samples
+// it was run on. The voiced samples of any span are then the difference
+// of two running counts, without a decision per sample.
+class VoicingIntervals
+{
+public:
+	VoicingIntervals(const infra::vector &vuv, double sampling_rate, int num_samples);
+	// the sum of the decisions over the samples from first to last-1;
+	// first and last must not decrease from one call to the next
+	double voiced_samples(int first, int last);
+
+protected:
+	double voiced_before(int sample, size_t &cursor);
+
+protected:
+	int num_samples;
+	std::vector<int> begin;           // of each frame
+	std::vector<int> end;             // one past its last sample
+	std::vector<double> decision;
+	std::vector<double> cumulative;   // voiced samples before each frame
+	size_t first_cursor;              // the frames of the last spans
+	size_t last_cursor;
+};
+
+/************************************************************************
+ Function:     VoicingIntervals::VoicingIntervals
+
+ Description:  Constructor
+ Inputs:       infra::vector &vuv - one decision per tracker frame
+               double sampling_rate
+               int num_samples - the tracker was run on
+ Output:       none.
+ Comments:     The bounds of the frames are rounded as the per-sample
+               expansion they replace rounded them.
+ ***********************************************************************/
+VoicingIntervals::VoicingIntervals(const infra::vector &vuv, double sampling_rate, int _num_samples) :
+num_samples(_num_samples),
+begin(vuv.size()),
+end(vuv.size()),
+decision(vuv.size()),
+cumulative(vuv.size()),
+first_cursor(0),
+last_cursor(0)
+{
+	int offset = RAPT_PITCH_FRAME_STEP*sampling_rate/2.0;
+	for (int j=0; j < int(vuv.size()); j++) {
+		int frame_begin = offset + j*RAPT_PITCH_FRAME_STEP*sampling_rate;
+		int frame_end = frame_begin + RAPT_PITCH_FRAME_STEP*sampling_rate - 1;
+		begin[j] = _min(_max(frame_begin, 0), num_samples);
+		end[j] = _min(_max(frame_end + 1, begin[j]), num_samples);
+		// a frame ends where the next one starts
+		if (j > 0)
+			end[j-1] = _max(_min(end[j-1], begin[j]), begin[j-1]);
+		decision[j] = vuv[j];
+	}
+	double voiced = 0.0;
+	for (int j=0; j < int(vuv.size()); j++) {
+		cumulative[j] = voiced;
+		voiced += decision[j]*(end[j] - begin[j]);
+	}
+}
+
+/************************************************************************
+ Function:     VoicingIntervals::voiced_before
+
+ Description:  The sum of the decisions over the samples before one
+ Inputs:       int sample
+               size_t &cursor - the frame of the previous, not later
+                 sample, moved to that of this one
+ Output:       double - the sum
+ Comments:     none.
+ ***********************************************************************/
+double VoicingIntervals::voiced_before(int sample, size_t &cursor)
+{
+	while (cursor+1 < begin.size() && begin[cursor+1] <= sample)
+		cursor++;
+	if (begin.size() == 0 || begin[cursor] > sample)
+		return 0.0;
+	return cumulative[cursor] + decision[cursor]*(_min(sample, end[cursor]) - begin[cursor]);
+}
+
+/************************************************************************
+ Function:     VoicingIntervals::voiced_samples
+
+ Description:  The sum of the decisions over a span of samples
+ Inputs:       int first, last - the span is from first to last-1, and
+                 may reach outside of the samples
+ Output:       double - the sum
+ Comments:     none.
+ ***********************************************************************/
+double VoicingIntervals::voiced_samples(int first, int last)
+{
+	first = _max(first, 0);
+	last = _min(last, num_samples);
+	if (last <= first)
+		return 0.0;
+	return voiced_before(last, last_cursor) - voiced_before(first, first_cursor);
+}
+
+/************************************************************************
+ Function:     read_wav_samples
+
+ Description:  Read the samples of a wav file
+ Inputs:       std::string &filename - wav file name
+               infra::vector &samples - the samples scaled to [-1,1]
+               double &sampling_rate - sampling rate of the file
+ Output:       bool - true on success
+ Comments:     none.
+ ***********************************************************************/
+bool read_wav_samples(const std::string &filename, infra::vector &samples,
+											double &sampling_rate)
+{
+	ProfileScope profile(PROFILE_WAV_READ);
+	CWavFile wav_file;
+
+	if (wav_file.Open(filename.c_str()) == false)
+		return false;
+
+	unsigned long num_samples_to_read = wav_file.ReadHeader();
+	sampling_rate = wav_file.GetRate();
+	if (num_samples_to_read == 0 || sampling_rate <= 0) {
+		wav_file.Close();
+		return false;
+	}
+
+	short *pbuffer = new short[num_samples_to_read];
+	unsigned long num_samples_read = wav_file.LoadSamples(pbuffer, num_samples_to_read);
+	samples.resize(num_samples_read);
+	samples.zeros();
+	for (unsigned long i=0; i < num_samples_read; i++)
+		samples[i] = double(pbuffer[i]/32767.0);
+	delete [] pbuffer;
+	wav_file.Close();
+	Profiler::count(PROFILE_BYTES_READ, num_samples_read*sizeof(short));
+
+	return (num_samples_read > 0);
+}
+
+/************************************************************************
+ Function:     window_frames
+
+ Description:  Find the frames of a window of speech
+ Inputs:       unsigned long num_samples - length of the signal
+               double sampling_rate - its sampling rate
+               double word_start, word_end - the window in seconds
+               infra::vector &frame_times - centers of all signal frames
+               int &first_frame, &last_frame - frames of the window
+ Output:       bool - false if the window is outside of the signal
+ Comments:     The window has last_frame-first_frame+1 frames.
+ ***********************************************************************/
+bool window_frames(unsigned long num_samples, double sampling_rate,
+									 double word_start, double word_end, infra::vector &frame_times,
+									 int &first_frame, int &last_frame)
+{
+	int frame_length = sampling_rate*WIN_SIZE;
+	int overlap = sampling_rate*WIN_SIZE-sampling_rate*FRAME_SIZE;
+	if (frame_length <= overlap || num_samples < (unsigned long)frame_length)
+		return false;
+	if (word_start < 0 || word_end <= word_start)
+		return false;
+	int num_frames = floor((num_samples-frame_length)/(frame_length-overlap))+1;
+
+	// vector of frame times
+	infra::vector t(num_frames);
+	t[0]=WIN_SIZE/2;
+	for (int j=0; j < num_frames-1; j++)
+		t[j+1] = t[j] + FRAME_SIZE;
+	frame_times.resize(num_frames);
+	frame_times = t;
+
+	// word-begin frame
+	int ind1 = 0;
+	while (ind1 < num_frames && t[ind1] < word_start)
+		ind1++;
+
+	// word-end frame
+	int ind2 = t.size()-1;
+	while (ind2 >= 0 && t[ind2] > word_end)
+		ind2--;
+
+	if (ind2 < ind1)
+		return false;
+	first_frame = ind1;
+	last_frame = ind2;
+
+	return true;
+}
+
+/************************************************************************
+ Function:     extract_features
+
+ Description:  Compute the acoustic features of a window of speech
+ Inputs:       infra::vector &samples - the whole signal
+               double sampling_rate - its sampling rate
+               double word_start, word_end - the window in seconds
+               bool normalize - z-score all features except pitch
+               infra::matrix &features - NUM_FEATURES x frames output
+               infra::vector &frame_times - centers of all signal frames
+               int &first_frame - frame of the first column of features
+               VoicingTracker voicing_tracker - of row 7
+ Output:       bool - false if the window is outside of the signal or
+               too short to be analyzed
+ Comments:     Moved from VotFrontEnd2, the features are unchanged.
+ ***********************************************************************/
+bool extract_features(const infra::vector &samples, double sampling_rate,
+											double word_start, double word_end, bool normalize,
+											infra::matrix &features, infra::vector &frame_times,
+											int &first_frame, VoicingTracker voicing_tracker)
+{
+	// frames of the window
+	int ind1, ind2;
+	if (!window_frames(samples.size(), sampling_rate, word_start, word_end,
+										 frame_times, ind1, ind2))
+		return false;
+	first_frame = ind1;
+	infra::vector &t = frame_times;
+
+	int frame_length = sampling_rate*WIN_SIZE;
+	int overlap = sampling_rate*WIN_SIZE-sampling_rate*FRAME_SIZE;
+	int net_num_frames = ind2-ind1+1;
+	int word_first_sample = int(sampling_rate*word_start);
+	int word_num_samples = int(sampling_rate*(word_end-word_start));
+	// word_end may be up to half a millisecond past the last sample, as
+	// the callers round the duration of the signal
+	word_num_samples = _max(0, _min(word_num_samples, int(samples.size()) - word_first_sample));
+
+	// allocate feature matrix
+	{
+		ProfileScope profile(PROFILE_FRAMING);
+		features.resize(NUM_FEATURES, net_num_frames);
+		features.zeros();
+	}
+
+	// the temporaries of the window, but not features and frame_times
+	// allocated above, are taken from the arenas of this thread
+	unsigned int num_threads = front_end_threads();
+	std::vector<infra::arena*> arenas = front_end_arenas(num_threads);
+
+	// Rows 0-8 are computed by independent tasks, which may run
+	// concurrently: chunks of frames for the spectral and autocorrelation
+	// rows, and each pitch tracker. The infra reference counts are not
+	// atomic, so a task only reads samples through views that are not
+	// counted (vector_base::external), writes the elements of its own
+	// rows, and works on its own vectors otherwise.
+	std::vector< std::function<void()> > tasks;
+
+	// extract pitch: Fei Sha & Lawrence Saul's algortihm
+	tasks.push_back([&]() {
+		ProfileScope task_profile(PROFILE_FAST_PITCH);
+		const infra::vector_view word_samples = infra::vector_base::external(
+			word_num_samples > 0 ? &samples[word_first_sample] : NULL, word_num_samples);
+		infra::vector f0;
+		infra::vector cost;
+		fast_pitch(word_samples, FAST_PITCH_WIN_SIZE, 0.2, 0.0, sampling_rate, f0, cost);
+
+		//  no pitch above a thresh level
+		for (int j=0; j < int(f0.size()); j++)
+			if (f0[j] > 350) f0[j] = 0;
+
+		// average pitch values to have the same frame lengths
+		int offset = -overlap;
+		for (int j=0; j < net_num_frames; j++) {
+			double fast_pitch_detect = 0.0;
+			for (int k=0; k < frame_length; k++) {
+				if (offset+k < int(f0.size()) && offset+k >= 0)
+					fast_pitch_detect += f0[offset+k];
+			}
+			features(6,j) = fast_pitch_detect/double(frame_length);
+			offset += frame_length-overlap;
+		}
+	});
+
+	// voicing track from fxrapt pitch detector (voicebox version), or from
+	// the YIN-style detector, on the samples of the word read in place
+	tasks.push_back([&]() {
+		ProfileScope task_profile(voicing_tracker == VOICING_YIN ? PROFILE_YIN : PROFILE_RAPT);
+		infra::vector vuv;
+		voicing_decisions(word_num_samples > 0 ? &samples[word_first_sample] : NULL, word_num_samples,
+											sampling_rate, voicing_tracker, vuv);
+		VoicingIntervals intervals(vuv, sampling_rate, word_num_samples);
+
+		// average the voiced-unvoiced decisions over each frame
+		int offset = -overlap;
+		for (int j=0; j < net_num_frames; j++) {
+			double rapt_voicing = intervals.voiced_samples(offset, offset + frame_length);
+			features(7,j) = rapt_voicing/double(frame_length);
+			offset += frame_length-overlap;
+		}
+	});
+
+	// energies, wiener entropy, zero-crossings and autocorrelation
+	// features, in chunks of frames
+	int chunk_size = net_num_frames;
+	if (num_threads > 1)
+		chunk_size = _max(MIN_FRAMES_PER_TASK, (net_num_frames + 4*num_threads - 1)/(4*num_threads));
+	for (int first=0; first < net_num_frames; first += chunk_size) {
+		int last = _min(first + chunk_size, net_num_frames) - 1;
+		tasks.push_back([&, first, last]() {
+			ProfileScope task_profile(PROFILE_POWER_SPECTRUM);
+			for (int j=first; j <= last; j++) {
+				int offset = (j+ind1)*(frame_length-overlap);
+				frame_features(infra::vector_base::external(&samples[offset], frame_length),
+											 sampling_rate, features, j);
+			}
+
+			task_profile.next(PROFILE_AUTOCORRELATION);
+			for (int j=first; j <= last; j++) {
+				// index of the current time
+				int ind3 = ceil(t[j+ind1]*sampling_rate);
+
+				// index of ACORR_LEFT samples before
+				int ind4 = _max(ind3-ACORR_LEFT,2);
+				// index of ACORR_RIGHTT samples after
+				int ind5 = _min(ind3+ACORR_RIGHT, int(samples.size()));
+
+				/////// debug purposes
+				ind4 -= 2;
+				ind5 -= 2;
+				/////// debug purposes
+				features(5,j) = autocorrelation_features(infra::vector_base::external(&samples[ind4], ind5-ind4+1));
+			}
+		});
+	}
+
+	run_tasks(tasks, num_threads, arenas);
+
+	infra::arena::scope arena_scope(arenas.empty() ? NULL : arenas[0]);
+	ProfileScope profile(PROFILE_DERIVED_ROWS);
+	const infra::vector_view short_term_energy = features.row(0);
+	const infra::vector_view total_energy = features.row(1);
+	const infra::vector_view low_energy = features.row(2);
+	const infra::vector_view high_energy = features.row(3);
+	const infra::vector_view wiener_entropy = features.row(4);
+	const infra::vector_view alpha_autocorrelation = features.row(5);
+	const infra::vector_view fast_pitch_detect = features.row(6);
+	const infra::vector_view rapt_voicing = features.row(7);
+
+	// feats 10-30: 'local differences' using windows of 5, 10, 15 ms
+	// for energy features, wiener entropy, autocor feature, pitch feature,
+	// voicing feature, zero-crossing feature
+	features.row(9) = diff_means(short_term_energy, 5);
+	features.row(10) = diff_means(short_term_energy, 10);
+	features.row(11) = diff_means(short_term_energy, 15);
+	features.row(12) = diff_means(total_energy, 5);
+	features.row(13) = diff_means(total_energy, 10);
+	features.row(14) = diff_means(total_energy, 15);
+	features.row(15) = diff_means(low_energy, 5);
+	features.row(16) = diff_means(low_energy, 10);
+	features.row(17) = diff_means(low_energy, 15);
+	features.row(18) = diff_means(high_energy, 5);
+	features.row(19) = diff_means(high_energy, 10);
+	features.row(20) = diff_means(high_energy, 15);
+	features.row(21) = diff_means(wiener_entropy, 5);
+	features.row(22) = diff_means(wiener_entropy, 10);
+	features.row(23) = diff_means(wiener_entropy, 15);
+	features.row(24) = diff_means(alpha_autocorrelation, 5);
+	features.row(25) = diff_means(alpha_autocorrelation, 10);
+	features.row(26) = diff_means(alpha_autocorrelation, 15);
+	features.row(27) = diff_means(fast_pitch_detect, 5);
+	features.row(28) = diff_means(fast_pitch_detect, 10);
+	features.row(29) = diff_means(fast_pitch_detect, 15);
+	features.row(30) = diff_means(rapt_voicing, 5);
+	features.row(31) = diff_means(rapt_voicing, 10);
+	features.row(32) = diff_means(rapt_voicing, 15);
+	features.row(33) = rms_diff_means(features.submatrix(8,0,1,features.width()), 5);
+	features.row(34) = rms_diff_means(features.submatrix(8,0,1,features.width()), 10);
+	features.row(35) = rms_diff_means(features.submatrix(8,0,1,features.width()), 15);
+
+	// feats 37-40: mean/max of feature 11 (short-term energy local difference
+	// with 15 ms window) up to time t
+	features.row(36) = cummulative_features(features.row(1),"mean",0);
+	features.row(37) = cummulative_features(features.row(1),"max",0);
+	features.row(38) = cummulative_features(features.row(1),"mean",-5);
+	features.row(39) = cummulative_features(features.row(1),"max",-5);
+
+	// feats 41-48: similar to features 37-40, but for auto corr local difference
+	// with windows of 5 and 10
+	features.row(40) = cummulative_features(features.row(24),"mean",0);
+	features.row(41) = cummulative_features(features.row(24),"max",0);
+	features.row(42) = cummulative_features(features.row(24),"mean",-10);
+	features.row(43) = cummulative_features(features.row(24),"max",-10);
+
+	features.row(44) = cummulative_features(features.row(25),"mean",0);
+	features.row(45) = cummulative_features(features.row(25),"max",0);
+	features.row(46) = cummulative_features(features.row(25),"mean",-10);
+	features.row(47) = cummulative_features(features.row(25),"max",-10);
+
+	// feats 49-60 similar to feats 37-40, but for log high energy,
+	// wiener entropy, pitch
+	features.row(48) = cummulative_features(features.row(3),"mean",0);
+	features.row(49) = cummulative_features(features.row(3),"max",0);
+	features.row(50) = cummulative_features(features.row(3),"mean",-5);
+	features.row(51) = cummulative_features(features.row(3),"max",-5);
+
+	features.row(52) = cummulative_features(features.row(4),"mean",0);
+	features.row(53) = cummulative_features(features.row(4),"max",0);
+	features.row(54) = cummulative_features(features.row(4),"mean",-5);
+	features.row(55) = cummulative_features(features.row(4),"max",-5);
+
+	features.row(56) = cummulative_features(features.row(6),"mean",0);
+	features.row(57) = cummulative_features(features.row(6),"max",0);
+	features.row(58) = cummulative_features(features.row(6),"mean",-5);
+	features.row(59) = cummulative_features(features.row(6),"max",-5);
+
+	// feats 65-67 rms_diff_means of rapt_voicing using windows 5,10,15
+	features.row(60) = rms_diff_means(features.submatrix(7,0,1,features.width()), 5);
+	features.row(61) = rms_diff_means(features.submatrix(7,0,1,features.width()), 10);
+	features.row(62) = rms_diff_means(features.submatrix(7,0,1,features.width()), 15);
+
+
+	// z-score: all features *except pitch* - zsInds=[1:43 45:51];
+	profile.next(PROFILE_NORMALIZATION);
+	if (normalize) {
+		for (int j=0; j < int(features.height()); j++) {
+			if (j == 6) continue;
+			double mean = features.row(j).sum()/double(features.width());
+			double std = sqrt( features.row(j).norm2()/double(features.width()-1) -
+												double(features.width())*mean*mean/double(features.width()-1) );
+			if (std == 0) continue;
+			features.row(j) = (features.row(j) - mean) / std;
+		}
+	}
+	Profiler::count(PROFILE_UTTERANCES, 1);
+	Profiler::count(PROFILE_FRAMES, net_num_frames);
+
+	// all the temporaries are gone, the next window reuses their memory
+	for (size_t t = 0; t < arenas.size(); t++) {
+		if (!arenas[t]->reset()) {
+			LOG(WARNING) << "Front end arena " << t << " still has " << arenas[t]->live()
+			<< " allocations in use, its memory is not reused";
+		}
+	}
+
+	return true;
+}
+
+/************************************************************************
+ Function:     frame_features
+
+ Description:  Compute the spectral features of one frame
+ Inputs:       infra::vector_base &frame - the frame_length samples
+               double sampling_rate
+               infra::matrix &features, int column - rows 0-4 and 8 of
+               this column are set
+ Output:       none.
+ Comments:     The same computations as extract_features(), for callers
+               that get the frames one at a time.
+ ***********************************************************************/
+void frame_features(const infra::vector_base &frame, double sampling_rate,
+										infra::matrix &features, int column)
+{
+	int nfft = 256;
+	infra::vector windowed = hamming(frame);
+	infra::vector power = powerspectrum(windowed, nfft);
+
+	double low_energy = 0.0;
+	double high_energy = 0.0;
+	double acc1 = 0.0;
+	double acc2 = 0.0;
+	for (int k=0; k < nfft/2+1; k++) {
+		double f = sampling_rate/double(nfft)*k;
+		if (f > 50 && f < 1000)
+			low_energy += power[k];
+		if (f > 3000)
+			high_energy += power[k];
+		acc1 += power[k];
+		acc2 += LOG_NATURAL(power[k]);
+	}
+	features(0,column) = windowed.norm2();
+	features(1,column) = LOG_NATURAL(power.sum());
+	features(2,column) = LOG_NATURAL(low_energy);
+	features(3,column) = LOG_NATURAL(high_energy);
+	features(4,column) = acc2 - LOG_NATURAL(acc1);
+	features(8,column) = zero_crossing(windowed);
+}
+
+/************************************************************************
+ Function:     rapt_voicing_decisions
+
+ Description:  Run the RAPT pitch tracker for its voicing decisions
+ Inputs:       double *samples, int num_samples - read in place
+               double sampling_rate
+               infra::vector &vuv - one decision per RAPT frame
+ Output:       none.
+ Comments:     Frame j covers the samples from RAPT_PITCH_FRAME_STEP*
+               (j+1/2) on, as in extract_features().
+ ***********************************************************************/
+void rapt_voicing_decisions(const double *samples, int num_samples, double sampling_rate,
+														infra::vector &vuv)
+{
+	infra::vector f0, rms_speech, acpkp;
+	std::lock_guard<std::mutex> lock(rapt_mutex);
+	get_f0s_span(samples, num_samples, f0, vuv, rms_speech, acpkp, RAPT_PITCH_FRAME_STEP,
+							 RAPT_PITCH_WIN_DUR, sampling_rate);
+}
+
+void rapt_voicing_decisions(const infra::vector &samples, double sampling_rate,
+														infra::vector &vuv)
+{
+	rapt_voicing_decisions(samples.size() ? &samples[0] : NULL, samples.size(), sampling_rate, vuv);
+}
+
+/************************************************************************
+ Function:     voicing_decisions
+
+ Description:  The voicing decisions of the selected tracker
+ Inputs:       double *samples, int num_samples - read in place
+               double sampling_rate
+               VoicingTracker tracker
+               infra::vector &vuv - one decision per RAPT frame
+ Output:       none.
+ Comments:     yin_voicing() uses the frames of RAPT, so both map to
+               the samples the same way.
+ ***********************************************************************/
+void voicing_decisions(const double *samples, int num_samples, double sampling_rate,
+											 VoicingTracker tracker, infra::vector &vuv)
+{
+	if (tracker == VOICING_YIN)
+		yin_voicing(samples, num_samples, RAPT_PITCH_FRAME_STEP, sampling_rate, vuv);
+	else
+		rapt_voicing_decisions(samples, num_samples, sampling_rate, vuv);
+}
+
+void voicing_decisions(const infra::vector &samples, double sampling_rate,
+											 VoicingTracker tracker, infra::vector &vuv)
+{
+	voicing_decisions(samples.size() ? &samples[0] : NULL, samples.size(), sampling_rate, tracker, vuv);
+}
+
+/************************************************************************
+ Function:     parse_voicing_tracker
+
+ Description:  The voicing tracker of a name
+ Inputs:       string &name - "rapt" or "yin"
+               VoicingTracker &tracker - output
+ Output:       bool - false for an unknown name
+ Comments:     none.
+ ***********************************************************************/
+bool parse_voicing_tracker(const std::string &name, VoicingTracker &tracker)
+{
+	if (name == "rapt")
+		tracker = VOICING_RAPT;
+	else if (name == "yin")
+		tracker = VOICING_YIN;
+	else
+		return false;
+	return true;
+}
+
+/************************************************************************
+ Function:     voicing_tracker_name
+
+ Description:  The name of a voicing tracker
+ Inputs:       VoicingTracker tracker
+ Output:       string - as parse_voicing_tracker() reads it
+ Comments:     none.
+ ***********************************************************************/
+std::string voicing_tracker_name(VoicingTracker tracker)
+{
+	return (tracker == VOICING_YIN) ? "yin" : "rapt";
+}
+
+/************************************************************************
+ Function:     round_as_text
+
+ Description:  Round a feature value to the precision of a features file
+ Inputs:       double value
+ Output:       double - the value read back from its text form
+ Comments:     Features files are written with the default stream
+               precision (6 significant digits).
+ ***********************************************************************/
+double round_as_text(double value)
+{
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%g", value);
+	return strtod(buffer, NULL);
+}
+
+/************************************************************************
+ Function:     features_to_utterance
+
+ Description:  Copy a features matrix into a SpeechUtterance
+ Inputs:       infra::matrix &features - NUM_FEATURES x frames
+               bool text_precision - round as in a features file
+               SpeechUtterance &x - frames x NUM_FEATURES output
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+void features_to_utterance(const infra::matrix &features, bool text_precision,
+													 SpeechUtterance &x)
+{
+	x.resize(features.width(), features.height());
+	for (unsigned long j=0; j < features.width(); j++) {
+		for (unsigned long k=0; k < features.height(); k++) {
+			double value = features(k,j);
+			x.set(j, k, text_precision ? round_as_text(value) : value);
+		}
+	}
+}
+
+// ------------------------------- EOF -----------------------------//
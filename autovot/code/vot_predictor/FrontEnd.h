@@ -0,0 +1,123 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+#ifndef _FRONT_END_H
+#define _FRONT_END_H
+
+/************************************************************************
+ Project:  VOT Detection front end
+ Module:   FrontEnd
+ Purpose:  Acoustic features of a window of speech
+ Date:     19 Oct., 2026
+
+ *************************** INCLUDE FILES ******************************/
+#include <string>
+#include "infra.h"
+#include "Dataset.h"
+
+#define WIN_SIZE 0.005
+#define FRAME_SIZE 0.001
+#define FAST_PITCH_WIN_SIZE 0.025
+#define RAPT_PITCH_WIN_DUR 0.0075
+#define RAPT_PITCH_FRAME_STEP 0.01
+#define ACORR_LEFT 100
+#define ACORR_RIGHT 300
+#define SAMPLING_RATE 16000
+#define NUM_FEATURES 63
+#define ZC_THRESHOLD 0.001
+
+// Read the samples of a wav file, scaled to [-1,1]. Unlike
+// read_samples_from_file() it neither caches the last file nor exits on
+// failure, so it can be called from several threads.
+bool read_wav_samples(const std::string &filename, infra::vector &samples,
+                      double &sampling_rate);
+
+// Find the frames of the window between word_start and word_end (in
+// seconds) of a signal of num_samples samples. The features of the window
+// have last_frame-first_frame+1 columns.
+bool window_frames(unsigned long num_samples, double sampling_rate,
+                   double word_start, double word_end, infra::vector &frame_times,
+                   int &first_frame, int &last_frame);
+
+// The voicing tracker of feature row 7 (and the rows derived from it):
+// the RAPT pitch tracker, or the cheaper YIN-style detector of
+// yin_voicing(). A model is trained and decoded with the same one.
+enum VoicingTracker { VOICING_RAPT, VOICING_YIN };
+
+// "rapt" or "yin", false for any other name
+bool parse_voicing_tracker(const std::string &name, VoicingTracker &tracker);
+std::string voicing_tracker_name(VoicingTracker tracker);
+
+// Compute the NUM_FEATURES x frames feature matrix of the speech between
+// word_start and word_end (in seconds). frame_times holds the center of
+// every frame of the whole signal, and first_frame is the index in
+// frame_times of the first column of features. The RAPT pitch tracker is
+// not reentrant, so concurrent calls are serialized around it.
+bool extract_features(const infra::vector &samples, double sampling_rate,
+                      double word_start, double word_end, bool normalize,
+                      infra::matrix &features, infra::vector &frame_times,
+                      int &first_frame, VoicingTracker voicing_tracker=VOICING_RAPT);
+
+// Set the threads extract_features() uses within one window: the two
+// pitch trackers and chunks of frames run as concurrent tasks, which
+// makes a single long window faster. The default, 1, computes everything
+// on the calling thread; the features are the same either way.
+void set_front_end_threads(unsigned int num_threads);
+unsigned int front_end_threads();
+
+// Take the temporary vectors and matrices of extract_features() from
+// arenas (see infra_arena.h), one per thread, reset after each window,
+// instead of the heap. This is the default; the features are the same
+// either way.
+void set_front_end_arenas(bool use_arenas);
+
+// Compute the features of one frame that depend on its samples only:
+// rows 0-4 (energies and wiener entropy) and 8 (zero crossings) of column
+// of the features matrix, as extract_features() does.
+void frame_features(const infra::vector_base &frame, double sampling_rate,
+                    infra::matrix &features, int column);
+
+// The voiced/unvoiced decisions of the RAPT pitch tracker, one every
+// RAPT_PITCH_FRAME_STEP, serialized with extract_features(). The span
+// versions read the num_samples samples in place.
+void rapt_voicing_decisions(const infra::vector &samples, double sampling_rate,
+                            infra::vector &vuv);
+void rapt_voicing_decisions(const double *samples, int num_samples, double sampling_rate,
+                            infra::vector &vuv);
+
+// The voiced/unvoiced decisions of either tracker, on the same
+// RAPT_PITCH_FRAME_STEP grid
+void voicing_decisions(const infra::vector &samples, double sampling_rate,
+                       VoicingTracker tracker, infra::vector &vuv);
+void voicing_decisions(const double *samples, int num_samples, double sampling_rate,
+                       VoicingTracker tracker, infra::vector &vuv);
+
+// Copy a features matrix into an utterance the way VotDecode reads it from
+// a features file (one row per frame). If text_precision is set the values
+// are rounded to the 6 significant digits written by VotFrontEnd2, so the
+// predictions are the same as those of the file based pipeline.
+void features_to_utterance(const infra::matrix &features, bool text_precision,
+                           SpeechUtterance &x);
+
+// Round a feature value to the 6 significant digits of a features file
+double round_as_text(double value);
+
+#endif // _FRONT_END_H
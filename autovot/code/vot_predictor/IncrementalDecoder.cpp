@@ -0,0 +1,468 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   IncrementalDecoder
+ Purpose:  Decoding of a window of speech while its samples arrive
+ Date:     19 Oct., 2026
+
+ **************************** INCLUDE FILES *****************************/
+#include <cmath>
+#include "IncrementalDecoder.h"
+#include "FrontEnd.h"
+#include "infra_dsp.h"
+
+// the pitch trackers run on this much new audio at once (seconds)
+#define PITCH_HOP 0.05
+// samples before a hop given to fast_pitch, more than its filters and
+// window span, so its output is that of the whole signal
+#define FAST_PITCH_CONTEXT 0.064
+// audio before and after a hop given to RAPT
+#define RAPT_CONTEXT 0.2
+#define RAPT_LOOKAHEAD 0.05
+// frames after a frame used by its local differences
+#define DIFF_SPAN 15
+// frames after the later onset of a negative VOT used by phi_neg
+#define NEG_SPAN 50
+
+#define MISPAR_KATAN_MEOD (-1000000)
+
+// rows of the cumulative features and the rows they are computed from
+static const int cumulative_rows[] = {1, 24, 25, 3, 4, 6};
+static const int num_cumulative_rows = 6;
+
+/************************************************************************
+ Function:     IncrementalDecoder::IncrementalDecoder
+
+ Description:  Constructor
+ Inputs:       Classifier &_classifier
+               double _sampling_rate
+               bool _pos_only - assume only positive VOTs
+               bool _text_precision - round the features as in a
+               features file
+               bool _normalize - z-score the features
+               int _warmup_frames - frames whose z-score waits for the
+               statistics of this many frames
+ Output:       none.
+ Comments:     The horizon follows from the VOT lengths and the max.
+               onset of the classifier.
+ ***********************************************************************/
+IncrementalDecoder::IncrementalDecoder(Classifier &_classifier, double _sampling_rate,
+																			 bool _pos_only, bool _text_precision, bool _normalize,
+																			 int _warmup_frames) :
+classifier(_classifier),
+sampling_rate(_sampling_rate),
+pos_only(_pos_only),
+text_precision(_text_precision),
+normalize(_normalize)
+{
+	min_vot_length = classifier.get_min_vot_length();
+	max_vot_length = classifier.get_max_vot_length();
+	max_onset = classifier.get_max_onset_time();
+	horizon = max_onset + max_vot_length + PHI_SPAN;
+	warmup_frames = _min(_max(_warmup_frames, 2), horizon);
+	frame_length = int(sampling_rate*WIN_SIZE);
+	frame_step = int(sampling_rate*FRAME_SIZE);
+	int rapt_step = int(RAPT_PITCH_FRAME_STEP*sampling_rate);
+	hop_samples = int(PITCH_HOP/RAPT_PITCH_FRAME_STEP + 0.5)*rapt_step;
+	reset();
+}
+
+/************************************************************************
+ Function:     IncrementalDecoder::reset
+
+ Description:  Start a new window
+ Inputs:       none.
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+void IncrementalDecoder::reset()
+{
+	samples.clear();
+	f0.clear();
+	vuv.clear();
+	num_hops = 0;
+	frame_time = WIN_SIZE/2;
+	raw.resize(NUM_FEATURES, horizon);
+	raw.zeros();
+	cumulative_sum.assign(num_cumulative_rows, std::vector<double>(horizon+1, 0.0));
+	cumulative_max.assign(num_cumulative_rows, std::vector<double>(horizon+1, -HUGE_VAL));
+	sum.assign(NUM_FEATURES, 0.0);
+	sum2.assign(NUM_FEATURES, 0.0);
+	num_base = 0;
+	num_derived = 0;
+	num_normalized = 0;
+	num_scored = 0;
+	prefix.reset();
+	x.resize(horizon, NUM_FEATURES);
+	D_pos = MISPAR_KATAN_MEOD;
+	D_neg = MISPAR_KATAN_MEOD;
+	y_hat_pos.burst = y_hat_pos.voice = 0;
+	y_hat_neg.burst = y_hat_neg.voice = 0;
+}
+
+/************************************************************************
+ Function:     IncrementalDecoder::push
+
+ Description:  Add samples of the window
+ Inputs:       double *new_samples, unsigned long num_samples - scaled
+               to [-1,1]
+ Output:       unsigned long - the number of samples used
+ Comments:     The samples are taken a pitch hop at a time, so at most a
+               hop more than the decoding needs is used.
+ ***********************************************************************/
+unsigned long IncrementalDecoder::push(const double *new_samples, unsigned long num_samples)
+{
+	unsigned long used = 0;
+	while (used < num_samples && !final()) {
+		unsigned long n = _min(num_samples - used, (unsigned long)hop_samples);
+		samples.insert(samples.end(), new_samples + used, new_samples + used + n);
+		used += n;
+		process();
+	}
+	return used;
+}
+
+/************************************************************************
+ Function:     IncrementalDecoder::finish
+
+ Description:  End the window before the horizon
+ Inputs:       none.
+ Output:       none.
+ Comments:     The missing samples are zeros.
+ ***********************************************************************/
+void IncrementalDecoder::finish()
+{
+	std::vector<double> silence(hop_samples, 0.0);
+	while (!final())
+		push(&silence[0], silence.size());
+}
+
+/************************************************************************
+ Function:     IncrementalDecoder::best
+
+ Description:  The best candidate of the frames scored so far
+ Inputs:       VotLocation &y_hat, double &confidence
+ Output:       bool - false if no frame was scored
+ Comments:     Chosen between the best positive and negative VOTs as
+               predict() does.
+ ***********************************************************************/
+bool IncrementalDecoder::best(VotLocation &y_hat, double &confidence)
+{
+	if (num_scored == 0)
+		return false;
+	if (pos_only || D_neg < D_pos) {
+		y_hat = y_hat_pos;
+		confidence = D_pos;
+	}
+	else {
+		y_hat = y_hat_neg;
+		confidence = D_neg;
+	}
+	return true;
+}
+
+/************************************************************************
+ Function:     IncrementalDecoder::process
+
+ Description:  Compute and score what the samples allow
+ Inputs:       none.
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+void IncrementalDecoder::process()
+{
+	while (process_hop()) ;
+	while (base_frame()) ;
+	while (derived_frame()) ;
+}
+
+/************************************************************************
+ Function:     IncrementalDecoder::process_hop
+
+ Description:  Run the pitch trackers on the next hop of samples
+ Inputs:       none.
+ Output:       bool - false if the samples after the hop are missing
+ Comments:     fast_pitch is causal except for its last samples, so with
+               enough context its output is that of the whole signal.
+               The RAPT decisions come from its dynamic programming over
+               the context only. Both are kept per sample, as
+               extract_features() does.
+ ***********************************************************************/
+bool IncrementalDecoder::process_hop()
+{
+	unsigned long hop_start = (unsigned long)num_hops*hop_samples;
+	unsigned long hop_end = hop_start + hop_samples;
+	// the last frame averages the pitch of its samples shifted by the overlap
+	if (hop_start >= (unsigned long)((horizon-1)*frame_step + frame_step))
+		return false;
+	int rapt_step = int(RAPT_PITCH_FRAME_STEP*sampling_rate);
+	unsigned long rapt_lookahead = int(RAPT_LOOKAHEAD/RAPT_PITCH_FRAME_STEP + 0.5)*rapt_step;
+	if (samples.size() < hop_end + rapt_lookahead)
+		return false;
+
+	// fast pitch of the hop
+	unsigned long fast_pitch_context = (unsigned long)(FAST_PITCH_CONTEXT*sampling_rate);
+	unsigned long first = (hop_start > fast_pitch_context) ? hop_start - fast_pitch_context : 0;
+	infra::vector_view chunk = infra::vector_base::external(&samples[first], hop_end + 2 - first);
+	infra::vector chunk_f0, cost;
+	fast_pitch(chunk, FAST_PITCH_WIN_SIZE, 0.2, 0.0, sampling_rate, chunk_f0, cost);
+	f0.resize(hop_end, 0.0);
+	for (unsigned long i = hop_start; i < hop_end; i++)
+		f0[i] = (chunk_f0[i-first] > 350) ? 0.0 : chunk_f0[i-first];
+
+	// RAPT voicing of the hop, its frames on the grid of the whole window
+	unsigned long rapt_context = int(RAPT_CONTEXT/RAPT_PITCH_FRAME_STEP + 0.5)*rapt_step;
+	first = (hop_start > rapt_context) ? hop_start - rapt_context : 0;
+	infra::vector rapt_vuv;
+	rapt_voicing_decisions(&samples[first], hop_end + rapt_lookahead - first, sampling_rate, rapt_vuv);
+	vuv.resize(hop_end, 0.0);
+	for (int j = 0; j < int(rapt_vuv.size()); j++) {
+		unsigned long frame_begin = first + rapt_step/2 + j*rapt_step;
+		for (unsigned long k = _max(frame_begin, hop_start); k < _min(frame_begin + rapt_step, hop_end); k++)
+			vuv[k] = rapt_vuv[j];
+	}
+
+	num_hops++;
+	return true;
+}
+
+/************************************************************************
+ Function:     IncrementalDecoder::base_frame
+
+ Description:  Compute rows 0-8 of the next frame
+ Inputs:       none.
+ Output:       bool - false if its samples or pitch are missing
+ Comments:     As extract_features() on a window starting at the first
+               sample.
+ ***********************************************************************/
+bool IncrementalDecoder::base_frame()
+{
+	int frame = num_base;
+	if (frame == horizon)
+		return false;
+	unsigned long start = (unsigned long)frame*frame_step;
+	int center = int(ceil(frame_time*sampling_rate));
+	// the pitch rows average the samples from start-overlap on
+	unsigned long pitch_end = start + frame_step;
+	if (samples.size() < start + frame_length || samples.size() < (unsigned long)(center + ACORR_RIGHT) ||
+			f0.size() < pitch_end)
+		return false;
+
+	frame_features(infra::vector_base::external(&samples[start], frame_length), sampling_rate, raw, frame);
+
+	int first = _max(center-ACORR_LEFT,2) - 2;
+	int last = center + ACORR_RIGHT - 2;
+	raw(5,frame) = autocorrelation_features(infra::vector_base::external(&samples[first], last-first+1));
+
+	int overlap = frame_length - frame_step;
+	double pitch = 0.0;
+	double voicing = 0.0;
+	for (int k = 0; k < frame_length; k++) {
+		int i = int(start) - overlap + k;
+		if (i >= 0) {
+			pitch += f0[i];
+			voicing += vuv[i];
+		}
+	}
+	raw(6,frame) = pitch/double(frame_length);
+	raw(7,frame) = voicing/double(frame_length);
+
+	frame_time += FRAME_SIZE;
+	num_base++;
+	return true;
+}
+
+/************************************************************************
+ Function:     IncrementalDecoder::local_mean
+
+ Description:  Mean of a row over frames
+ Inputs:       int row, first, last
+ Output:       double
+ Comments:     none.
+ ***********************************************************************/
+double IncrementalDecoder::local_mean(int row, int first, int last)
+{
+	double mean = 0.0;
+	for (int k = first; k <= last; k++)
+		mean += raw(row,k);
+	return mean/double(last-first+1);
+}
+
+/************************************************************************
+ Function:     IncrementalDecoder::derived_frame
+
+ Description:  Compute rows 9-62 of the next frame, and normalize and
+               score the frames that are final
+ Inputs:       none.
+ Output:       bool - false if the frames it looks at are missing
+ Comments:     The local differences and cumulative features are those of
+               diff_means(), rms_diff_means() and cummulative_features()
+               on the rows of the whole window.
+ ***********************************************************************/
+bool IncrementalDecoder::derived_frame()
+{
+	int frame = num_derived;
+	if (frame == horizon)
+		return false;
+	int last_frame = horizon-1;
+	if (num_base <= _min(frame + DIFF_SPAN, last_frame))
+		return false;
+
+	// local differences of rows 0-7 (9-32), rms differences of rows 8 and 7
+	int windows[] = {5, 10, 15};
+	for (int w = 0; w < 3; w++) {
+		int first = _max(frame-windows[w],0);
+		int before = _max(frame-1,0);
+		int after = _min(frame+1,last_frame);
+		int last = _min(frame+windows[w],last_frame);
+		for (int row = 0; row <= 7; row++)
+			raw(9+3*row+w,frame) = local_mean(row, after, last) - local_mean(row, first, before);
+		double diff = local_mean(8, first, before) - local_mean(8, after, last);
+		raw(33+w,frame) = sqrt(diff*diff);
+		diff = local_mean(7, first, before) - local_mean(7, after, last);
+		raw(60+w,frame) = sqrt(diff*diff);
+	}
+
+	// cumulative mean and max, up to the frame or 5/10 frames before it
+	for (int c = 0; c < num_cumulative_rows; c++) {
+		double value = raw(cumulative_rows[c],frame);
+		cumulative_sum[c][frame+1] = cumulative_sum[c][frame] + value;
+		cumulative_max[c][frame+1] = _max(cumulative_max[c][frame], value);
+		int offset = (cumulative_rows[c] == 24 || cumulative_rows[c] == 25) ? -10 : -5;
+		int len = _min(frame+1, horizon-1);
+		int len_offset = _min(_max(frame+1+offset,1), horizon-1);
+		raw(36+4*c,frame) = cumulative_sum[c][len]/double(len);
+		raw(37+4*c,frame) = cumulative_max[c][len];
+		raw(38+4*c,frame) = cumulative_sum[c][len_offset]/double(len_offset);
+		raw(39+4*c,frame) = cumulative_max[c][len_offset];
+	}
+
+	for (int row = 0; row < NUM_FEATURES; row++) {
+		sum[row] += raw(row,frame);
+		sum2[row] += raw(row,frame)*raw(row,frame);
+	}
+	num_derived++;
+
+	// the first frames wait for the statistics of the warm-up
+	if (normalize && num_derived < warmup_frames)
+		return true;
+	normalize_frames(num_normalized, frame);
+	for (int f = num_scored; f <= frame; f++)
+		score_frame(f);
+	return true;
+}
+
+/************************************************************************
+ Function:     IncrementalDecoder::normalize_frames
+
+ Description:  Z-score frames with the statistics of the frames so far
+ Inputs:       int first, last
+ Output:       none.
+ Comments:     All rows except the pitch, as extract_features().
+ ***********************************************************************/
+void IncrementalDecoder::normalize_frames(int first, int last)
+{
+	double n = double(num_derived);
+	for (int row = 0; row < NUM_FEATURES; row++) {
+		double mean = 0.0;
+		double std = 0.0;
+		if (normalize && row != 6 && n > 1) {
+			mean = sum[row]/n;
+			std = sqrt(sum2[row]/(n-1) - n*mean*mean/(n-1));
+		}
+		for (int f = first; f <= last; f++) {
+			double value = raw(row,f);
+			if (std > 0)
+				value = (value - mean)/std;
+			x.set(f, row, text_precision ? round_as_text(value) : value);
+		}
+	}
+	prefix.extend(x, last);
+	num_normalized = last+1;
+}
+
+/************************************************************************
+ Function:     IncrementalDecoder::score_frame
+
+ Description:  Score the candidates completed by a frame
+ Inputs:       int frame
+ Output:       none.
+ Comments:     These are the candidates of predict() on the window: a
+               positive VOT is complete at its voice onset, a negative
+               one NEG_SPAN frames after its burst (or at the horizon).
+ ***********************************************************************/
+void IncrementalDecoder::score_frame(int frame)
+{
+	int last_voice = horizon - PHI_SPAN;
+	int onsets = _min(max_onset, horizon - min_vot_length - PHI_SPAN);
+
+	// positive VOTs with the voice onset at the frame
+	if (frame <= last_voice) {
+		for (int onset = _max(0, frame - max_vot_length);
+				 onset <= _min(onsets - 1, frame - min_vot_length); onset++)
+			score_candidate(onset, frame);
+	}
+
+	// negative VOTs with their later onset NEG_SPAN frames before
+	if (!pos_only) {
+		int first_offset = frame - NEG_SPAN;
+		int last_offset = (frame == horizon-1) ? last_voice : first_offset;
+		for (int offset = _max(first_offset, 0); offset <= _min(last_offset, last_voice); offset++) {
+			for (int onset = _max(0, offset - max_vot_length);
+					 onset <= _min(onsets - 1, offset - min_vot_length); onset++)
+				score_candidate(offset, onset);
+		}
+	}
+	num_scored = frame+1;
+}
+
+/************************************************************************
+ Function:     IncrementalDecoder::score_candidate
+
+ Description:  Score a candidate and keep it if it is the best so far
+ Inputs:       int burst, voice - a negative VOT if burst > voice
+ Output:       none.
+ Comments:     Of equal scores the candidate predict() meets first wins,
+               the one of the smallest onset and then offset.
+ ***********************************************************************/
+void IncrementalDecoder::score_candidate(int burst, int voice)
+{
+	VotLocation y;
+	y.burst = burst;
+	y.voice = voice;
+	bool neg = (burst > voice);
+	double D = classifier.score(x, y, neg, &prefix);
+	double &D_best = neg ? D_neg : D_pos;
+	VotLocation &y_best = neg ? y_hat_neg : y_hat_pos;
+	int onset = _min(burst, voice);
+	int offset = _max(burst, voice);
+	int best_onset = _min(y_best.burst, y_best.voice);
+	int best_offset = _max(y_best.burst, y_best.voice);
+	if (D > D_best || (D == D_best && (onset < best_onset ||
+																		 (onset == best_onset && offset < best_offset)))) {
+		D_best = D;
+		y_best = y;
+	}
+}
+
+// ------------------------------- EOF -----------------------------//
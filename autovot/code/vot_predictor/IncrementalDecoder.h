@@ -0,0 +1,130 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+#ifndef _INCREMENTAL_DECODER_H
+#define _INCREMENTAL_DECODER_H
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   IncrementalDecoder
+ Purpose:  Decoding of a window of speech while its samples arrive
+ Date:     19 Oct., 2026
+
+ The window starts at the first sample pushed after reset() and has a
+ fixed number of frames, the horizon: max_onset + max_vot_length plus
+ the feature span of Classifier::predict. Each frame is computed as
+ soon as the samples it depends on have arrived:
+   - the spectral rows need the samples of the frame, the
+     autocorrelation row ACORR_RIGHT samples more
+   - the two pitch trackers run every PITCH_HOP on the new samples and
+     a bounded context before them, RAPT also a little after them
+   - the local differences look 15 frames ahead (diff_means), the
+     cumulative rows are running means and maxima
+   - the z-score of a frame uses the means and deviations of the frames
+     seen so far (after a warm-up), since those of the whole window are
+     not known yet
+ Once a frame is final the candidates it completes are scored and the
+ best one is kept, so a provisional answer is available at every frame
+ and the decoding is final when the last frame of the horizon is. The
+ result is the one predict() gives on the features of the window.
+
+ Memory is bounded by the horizon. The statistics phi_pos() takes from
+ the first frame of the window are kept as prefix sums and maxima while
+ frames are normalized, so the work per frame is bounded by the candidates
+ it completes (at most max_vot_length - min_vot_length + 1 per onset) times
+ max_vot_length, and does not grow with the number of frames before it.
+
+ *************************** INCLUDE FILES ******************************/
+#include <vector>
+#include "infra.h"
+#include "Dataset.h"
+#include "Classifier.h"
+
+class IncrementalDecoder
+{
+public:
+  // the classifier must be one of RAPT features, the only ones computed here
+  IncrementalDecoder(Classifier &_classifier, double _sampling_rate, bool _pos_only=false,
+                     bool _text_precision=true, bool _normalize=true, int _warmup_frames=100);
+  // start a new window at the next sample
+  void reset();
+  // add samples, returns how many were used: fewer than num_samples
+  // once the decoding is final
+  unsigned long push(const double *samples, unsigned long num_samples);
+  // the audio ended, decode as if it was followed by silence
+  void finish();
+  bool final() { return (num_scored == horizon); }
+  // the best candidate so far, false if none was scored yet
+  bool best(VotLocation &y_hat, double &confidence);
+  int num_frames() { return horizon; }
+  // frames whose candidates are scored
+  int frames_scored() { return num_scored; }
+  unsigned long samples_pushed() { return samples.size(); }
+  // the features of the window, final for the first frames_scored() frames
+  SpeechUtterance &features() { return x; }
+
+protected:
+  void process();
+  bool process_hop();
+  bool base_frame();
+  bool derived_frame();
+  void normalize_frames(int first, int last);
+  void score_frame(int frame);
+  void score_candidate(int burst, int voice);
+  double local_mean(int row, int first, int last);
+
+protected:
+  Classifier &classifier;
+  double sampling_rate;
+  bool pos_only;
+  bool text_precision;
+  bool normalize;
+  int warmup_frames;
+  int min_vot_length;
+  int max_vot_length;
+  int max_onset;
+  int horizon;                   // frames of the window
+  int frame_length;
+  int frame_step;
+  int hop_samples;               // samples per pitch tracker run
+  std::vector<double> samples;   // of the window
+  std::vector<double> f0;        // fast pitch, per sample
+  std::vector<double> vuv;       // RAPT voicing, per sample
+  int num_hops;
+  double frame_time;             // center of the next base frame
+  infra::matrix raw;             // NUM_FEATURES x horizon, as extract_features()
+  std::vector< std::vector<double> > cumulative_sum;  // prefix sums of the
+  std::vector< std::vector<double> > cumulative_max;  // rows of the cumulative features
+  std::vector<double> sum;       // sums of the rows over the derived frames
+  std::vector<double> sum2;      // and of their squares
+  int num_base;
+  int num_derived;
+  int num_normalized;
+  int num_scored;
+  SpeechUtterance x;             // horizon x NUM_FEATURES
+  PrefixStatistics prefix;       // of the normalized frames of x
+  double D_pos;
+  double D_neg;
+  VotLocation y_hat_pos;
+  VotLocation y_hat_neg;
+};
+
+#endif // _INCREMENTAL_DECODER_H
@@ -49,8 +49,12 @@ int KernelExpansion::features_dim()
   return D;
 }
 
-infra::vector_view KernelExpansion::expand(infra::vector_base x)
+infra::vector_view KernelExpansion::expand(const infra::vector_base &x)
 {
+  // the linear kernel is the identity: a view of x, nothing is copied
+  if (kernel_name == "" || kernel_name == "none")
+    return x;
+
   infra::vector x_expanded(features_dim());
   
   if (kernel_name == "poly2") {
@@ -162,9 +166,6 @@ infra::vector_view KernelExpansion::expand(infra::vector_base x)
       }
     }
   }
-	else {
-		x_expanded = x;
-	}
   
   return x_expanded;
 }
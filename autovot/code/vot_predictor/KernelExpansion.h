@@ -28,8 +28,11 @@ class KernelExpansion
 public:
   KernelExpansion(std::string _kernel_name, int _d, double _sigma = 1.0);
   int features_dim();
-  infra::vector_view expand(infra::vector_base x);
+  // for the linear kernel, the result is a view of x itself
+  infra::vector_view expand(const infra::vector_base &x);
   bool is_linear_kernel() { return (kernel_name == ""); }
+  const std::string &get_kernel_name() { return (kernel_name); }
+  double get_sigma() { return (sigma); }
 
 private: 
   std::string kernel_name;
@@ -0,0 +1,281 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   Logger
+ Purpose:  Asynchronous log sink
+ Date:     19 Oct., 2026
+
+ When Log::Asynchronous() is set, messages below ERROR are pushed to a
+ bounded lock-free queue (multiple producers, one consumer) and written
+ to stderr by a background thread, so logging threads never wait for
+ the terminal or for each other. An ERROR first writes everything queued
+ and is then written directly, since it is usually followed by exit().
+ The queue is also written at exit and by Log::Flush().
+
+ **************************** INCLUDE FILES *****************************/
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <stdint.h>
+#include <pthread.h>
+#include "Logger.h"
+
+// number of queued messages, a power of 2
+#define LOG_QUEUE_SIZE 4096
+
+struct LogSlot
+{
+	// equals the position of the slot when it is free, and the position
+	// plus one when it holds a message
+	std::atomic<uint64_t> sequence;
+	std::string message;
+};
+
+class LogQueue
+{
+public:
+	LogQueue();
+	bool push(std::string &message);
+	bool drain(bool write=true);
+
+public:
+	// held by the thread that pops messages
+	std::mutex consumer_mutex;
+
+private:
+	bool pop(std::string &message);
+	void run();
+
+	LogSlot slots[LOG_QUEUE_SIZE];
+	std::atomic<uint64_t> tail;
+	uint64_t head;
+};
+
+static std::atomic<LogQueue*> log_queue(NULL);
+
+/************************************************************************
+ Function:     at_fork_prepare, at_fork_parent, at_fork_child
+
+ Description:  Keep the queue consistent across fork()
+ Inputs:       none.
+ Output:       none.
+ Comments:     The child has no writer thread, and may leave with
+               _exit(), so it logs synchronously. The messages queued
+               before the fork are written by the parent only.
+ ***********************************************************************/
+static void at_fork_prepare()
+{
+	log_queue.load()->consumer_mutex.lock();
+	log_queue.load()->drain();
+}
+
+static void at_fork_parent()
+{
+	log_queue.load()->consumer_mutex.unlock();
+}
+
+static void at_fork_child()
+{
+	log_queue.load()->drain(false);
+	log_queue.load()->consumer_mutex.unlock();
+	Log::Asynchronous() = false;
+}
+
+/************************************************************************
+ Function:     flush_at_exit
+
+ Description:  Write the queued messages when the program ends
+ Inputs:       none.
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+static void flush_at_exit()
+{
+	Log::Flush();
+}
+
+/************************************************************************
+ Function:     LogQueue::LogQueue
+
+ Description:  Constructor, starts the writer thread
+ Inputs:       none.
+ Output:       none.
+ Comments:     The queue is never destroyed, the detached thread may
+               still use it while the program exits.
+ ***********************************************************************/
+LogQueue::LogQueue() : tail(0), head(0)
+{
+	for (uint64_t i = 0; i < LOG_QUEUE_SIZE; i++)
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+	std::thread(&LogQueue::run, this).detach();
+}
+
+/************************************************************************
+ Function:     LogQueue::push
+
+ Description:  Queue a message, from any thread
+ Inputs:       string &message - swapped into the queue
+ Output:       bool - false if the queue is full
+ Comments:     Lock free: a producer claims a slot by advancing the tail
+               and publishes its message through the slot sequence.
+ ***********************************************************************/
+bool LogQueue::push(std::string &message)
+{
+	uint64_t pos = tail.load(std::memory_order_relaxed);
+	for (;;) {
+		LogSlot &slot = slots[pos & (LOG_QUEUE_SIZE-1)];
+		uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+		int64_t diff = int64_t(sequence) - int64_t(pos);
+		if (diff == 0) {
+			if (tail.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed)) {
+				slot.message.swap(message);
+				slot.sequence.store(pos+1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0) {
+			return false;
+		}
+		else {
+			pos = tail.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+/************************************************************************
+ Function:     LogQueue::pop
+
+ Description:  Take the oldest message
+ Inputs:       string &message
+ Output:       bool - false if there is no published message
+ Comments:     Called with consumer_mutex held.
+ ***********************************************************************/
+bool LogQueue::pop(std::string &message)
+{
+	LogSlot &slot = slots[head & (LOG_QUEUE_SIZE-1)];
+	if (slot.sequence.load(std::memory_order_acquire) != head+1)
+		return false;
+	message.swap(slot.message);
+	slot.message.clear();
+	slot.sequence.store(head + LOG_QUEUE_SIZE, std::memory_order_release);
+	head++;
+	return true;
+}
+
+/************************************************************************
+ Function:     LogQueue::drain
+
+ Description:  Write all the queued messages to stderr
+ Inputs:       bool write - false to discard them
+ Output:       bool - true if there were messages
+ Comments:     Called with consumer_mutex held.
+ ***********************************************************************/
+bool LogQueue::drain(bool write)
+{
+	std::string buffer;
+	std::string message;
+	while (pop(message))
+		if (write) buffer += message;
+	if (buffer.empty())
+		return false;
+	fwrite(buffer.data(), 1, buffer.size(), stderr);
+	fflush(stderr);
+	return true;
+}
+
+/************************************************************************
+ Function:     LogQueue::run
+
+ Description:  The writer thread
+ Inputs:       none.
+ Output:       none.
+ Comments:     Producers do not signal it, it polls the queue every few
+               msec while it is empty.
+ ***********************************************************************/
+void LogQueue::run()
+{
+	for (;;) {
+		bool written;
+		{
+			std::lock_guard<std::mutex> lock(consumer_mutex);
+			written = drain();
+		}
+		if (!written)
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+}
+
+/************************************************************************
+ Function:     Log::Write
+
+ Description:  Write a formatted message
+ Inputs:       LogLevel level, string &message
+ Output:       none.
+ Comments:     If the queue is full the message is written directly, and
+               may come before some of the queued ones.
+ ***********************************************************************/
+void Log::Write(LogLevel level, const std::string& message)
+{
+	if (Asynchronous() && level > ERROR) {
+		// created on the first asynchronous message
+		static LogQueue *queue = NULL;
+		static std::once_flag once;
+		std::call_once(once, []() {
+			queue = new LogQueue();
+			log_queue = queue;
+			pthread_atfork(at_fork_prepare, at_fork_parent, at_fork_child);
+			atexit(flush_at_exit);
+		});
+		std::string queued(message);
+		if (queue->push(queued))
+			return;
+	}
+	else {
+		Flush();
+	}
+	fprintf(stderr, "%s", message.c_str());
+	fflush(stderr);
+}
+
+/************************************************************************
+ Function:     Log::Flush
+
+ Description:  Write the queued messages
+ Inputs:       none.
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+void Log::Flush()
+{
+	LogQueue *queue = log_queue.load();
+	if (queue == NULL)
+		return;
+	std::lock_guard<std::mutex> lock(queue->consumer_mutex);
+	queue->drain();
+}
+
+// ------------------------------- EOF -----------------------------//
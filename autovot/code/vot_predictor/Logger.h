@@ -43,23 +43,35 @@ inline std::string basename( std::string const& pathname )
 	return std::string(std::find_if(pathname.rbegin(), pathname.rend(), MatchPathSeparator()).base(), pathname.end());
 }
 
+// The local time as hh:mm:ss.mmm. The hh:mm:ss part is formatted once a
+// second per thread.
 inline std::string NowTime()
 {
-	char buffer[11];
-	time_t t;
-	time(&t);
-	tm r = {0};
-	strftime(buffer, sizeof(buffer), "%X", localtime_r(&t, &r));
 	struct timeval tv;
 	gettimeofday(&tv, 0);
+	static thread_local time_t cached_seconds = -1;
+	static thread_local char cached_buffer[11];
+	if (tv.tv_sec != cached_seconds) {
+		tm r = {0};
+		time_t t = tv.tv_sec;
+		strftime(cached_buffer, sizeof(cached_buffer), "%X", localtime_r(&t, &r));
+		cached_seconds = tv.tv_sec;
+	}
 	char result[100] = {0};
-	std::sprintf(result, "%s.%03ld", buffer, (long)tv.tv_usec / 1000);
+	std::snprintf(result, sizeof(result), "%s.%03ld", cached_buffer, (long)tv.tv_usec / 1000);
 	return result;
 }
 
 
 enum LogLevel {ERROR, WARNING, INFO, DEBUG};
 
+// The most verbose level compiled in. Messages above it are removed by the
+// compiler together with their arguments, whatever the reporting level.
+// The release build sets it to INFO.
+#ifndef LOG_MAX_LEVEL
+#define LOG_MAX_LEVEL DEBUG
+#endif
+
 class Log
 {
 public:
@@ -71,24 +83,31 @@ public:
 	static std::string& ExecutableName();
 	static std::string ToString(LogLevel level);
 	static LogLevel FromString(const std::string& level);
+	// queue the messages below ERROR for a background thread to write
+	static bool& Asynchronous();
+	// write the queued messages
+	static void Flush();
 protected:
+	static void Write(LogLevel level, const std::string& message);
 	std::ostringstream os;
+	LogLevel message_level;
 private:
 	Log(const Log&);
 	Log& operator =(const Log&);
 };
 
 #define LOG(level) \
-if (level > Log::ReportingLevel()) ; \
+if (level > LOG_MAX_LEVEL || level > Log::ReportingLevel()) ; \
 else Log().Get(level)
 
 
-inline Log::Log()
+inline Log::Log() : message_level(INFO)
 {
 }
 
 inline std::ostringstream& Log::Get(LogLevel level)
 {
+	message_level = level;
 	os << NowTime();
 	os << " [" << Log::ExecutableName() << "] ";
 	os << ToString(level) << ": ";
@@ -99,8 +118,7 @@ inline std::ostringstream& Log::Get(LogLevel level)
 inline Log::~Log()
 {
 	os << std::endl;
-	fprintf(stderr, "%s", os.str().c_str());
-	fflush(stderr);
+	Write(message_level, os.str());
 }
 
 inline LogLevel& Log::ReportingLevel()
@@ -109,6 +127,12 @@ inline LogLevel& Log::ReportingLevel()
 	return reportingLevel;
 }
 
+inline bool& Log::Asynchronous()
+{
+	static bool asynchronous = false;
+	return asynchronous;
+}
+
 inline std::string& Log::ExecutableName()
 {
 	static std::string executableName = "";
@@ -123,8 +147,11 @@ inline std::string Log::ToString(LogLevel level)
 
 inline LogLevel Log::FromString(const std::string& level)
 {
-	if (level == "DEBUG")
+	if (level == "DEBUG") {
+		if (DEBUG > LOG_MAX_LEVEL)
+			Log().Get(WARNING) << "DEBUG messages are not compiled in, rebuild with LOG_MAX_LEVEL=DEBUG to see them.";
 		return DEBUG;
+	}
 	if (level == "INFO")
 		return INFO;
 	if (level == "WARNING")
@@ -0,0 +1,323 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   ModelFile
+ Purpose:  Binary model file: the weights together with the options
+           they were trained with
+ Date:     19 Oct., 2026
+
+ **************************** INCLUDE FILES *****************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ModelFile.h"
+#include "Logger.h"
+
+#define MODEL_FILE_MAGIC "AVOTMODL"
+#define MODEL_FILE_BYTE_ORDER 0x01020304
+
+// the first MODEL_FILE_ALIGNMENT bytes of a model file
+struct ModelFileHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;
+	uint64_t manifest_offset;
+	uint64_t manifest_size;
+	uint64_t pos_offset;
+	uint64_t pos_size;    // number of doubles
+	uint64_t neg_offset;
+	uint64_t neg_size;
+};
+
+/************************************************************************
+ Function:     ModelInfo::ModelInfo
+
+ Description:  Constructor, the defaults of VotDecode
+ Inputs:       none.
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+ModelInfo::ModelInfo() :
+kernel_expansion(""),
+sigma(1.0),
+pos_only(false),
+ignore_features(""),
+voicing_tracker("rapt"),
+min_vot_length(15),
+max_vot_length(200),
+max_onset(150),
+num_features(63),
+phi_pos_size(0),
+phi_neg_size(0),
+version(MODEL_FILE_VERSION)
+{
+}
+
+/************************************************************************
+ Function:     align
+
+ Description:  Round an offset up to the block alignment
+ Inputs:       uint64_t offset
+ Output:       uint64_t - the aligned offset
+ Comments:     none.
+ ***********************************************************************/
+static uint64_t align(uint64_t offset)
+{
+	return (offset + MODEL_FILE_ALIGNMENT - 1) / MODEL_FILE_ALIGNMENT * MODEL_FILE_ALIGNMENT;
+}
+
+/************************************************************************
+ Function:     is_model_file
+
+ Description:  Check if a file is a binary model
+ Inputs:       string &filename
+ Output:       bool - true if the file starts with the model file magic
+ Comments:     none.
+ ***********************************************************************/
+bool is_model_file(const std::string &filename)
+{
+	FILE *fp = fopen(filename.c_str(), "rb");
+	if (fp == NULL)
+		return false;
+	char magic[8];
+	bool is_model = (fread(magic, 1, sizeof(magic), fp) == sizeof(magic) &&
+									 memcmp(magic, MODEL_FILE_MAGIC, sizeof(magic)) == 0);
+	fclose(fp);
+	return is_model;
+}
+
+/************************************************************************
+ Function:     parse_manifest
+
+ Description:  Fill a ModelInfo from the manifest lines
+ Inputs:       const char *text, size_t size - the manifest
+               ModelInfo &info
+ Output:       none.
+ Comments:     Unknown keys are kept as training metadata.
+ ***********************************************************************/
+static void parse_manifest(const char *text, size_t size, ModelInfo &info)
+{
+	std::istringstream is(std::string(text, strnlen(text, size)));
+	std::string line;
+	while (std::getline(is, line)) {
+		size_t eq = line.find('=');
+		if (eq == std::string::npos)
+			continue;
+		std::string key = line.substr(0, eq);
+		std::string value = line.substr(eq+1);
+		if (key == "kernel_expansion") info.kernel_expansion = value;
+		else if (key == "sigma") info.sigma = strtod(value.c_str(), NULL);
+		else if (key == "pos_only") info.pos_only = (value == "1");
+		else if (key == "ignore_features") info.ignore_features = value;
+		else if (key == "voicing_tracker") info.voicing_tracker = value;
+		else if (key == "min_vot_length") info.min_vot_length = atoi(value.c_str());
+		else if (key == "max_vot_length") info.max_vot_length = atoi(value.c_str());
+		else if (key == "max_onset") info.max_onset = atoi(value.c_str());
+		else if (key == "num_features") info.num_features = atoi(value.c_str());
+		else if (key == "phi_pos_size") info.phi_pos_size = atoi(value.c_str());
+		else if (key == "phi_neg_size") info.phi_neg_size = atoi(value.c_str());
+		else info.metadata[key] = value;
+	}
+}
+
+/************************************************************************
+ Function:     read_model_file
+
+ Description:  Read a binary model
+ Inputs:       string &filename
+               ModelInfo &info - the options stored in the file
+               infra::vector *w_pos, *w_neg - the weights, or NULL to
+               read only the options
+ Output:       bool - true on success
+ Comments:     The file is mapped into memory and the weight blocks are
+               copied out of it.
+ ***********************************************************************/
+bool read_model_file(const std::string &filename, ModelInfo &info,
+										 infra::vector *w_pos, infra::vector *w_neg)
+{
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		LOG(ERROR) << "Unable to open " << filename;
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < MODEL_FILE_ALIGNMENT) {
+		LOG(ERROR) << filename << " is not a model file";
+		close(fd);
+		return false;
+	}
+	uint64_t file_size = st.st_size;
+	void *p = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED) {
+		LOG(ERROR) << "Unable to map " << filename;
+		return false;
+	}
+	const char *data = (const char*)p;
+
+	ModelFileHeader header;
+	memcpy(&header, data, sizeof(header));
+	bool ok = true;
+	if (memcmp(header.magic, MODEL_FILE_MAGIC, sizeof(header.magic)) != 0) {
+		LOG(ERROR) << filename << " is not a model file";
+		ok = false;
+	}
+	else if (header.byte_order != MODEL_FILE_BYTE_ORDER) {
+		LOG(ERROR) << filename << " was written on a machine with a different byte order";
+		ok = false;
+	}
+	else if (header.version > MODEL_FILE_VERSION) {
+		LOG(ERROR) << filename << " has format version " << header.version
+		<< ", this program reads up to version " << MODEL_FILE_VERSION;
+		ok = false;
+	}
+	else if (header.manifest_offset + header.manifest_size > file_size ||
+					 header.pos_offset + header.pos_size*sizeof(double) > file_size ||
+					 header.neg_offset + header.neg_size*sizeof(double) > file_size) {
+		LOG(ERROR) << filename << " is truncated";
+		ok = false;
+	}
+
+	if (ok) {
+		info = ModelInfo();
+		info.version = header.version;
+		parse_manifest(data + header.manifest_offset, header.manifest_size, info);
+		if (uint64_t(info.phi_pos_size) != header.pos_size ||
+				uint64_t(info.phi_neg_size) != header.neg_size) {
+			LOG(ERROR) << "The weights of " << filename << " do not match its manifest";
+			ok = false;
+		}
+	}
+
+	if (ok && w_pos != NULL) {
+		w_pos->resize(header.pos_size);
+		if (header.pos_size > 0)
+			memcpy(w_pos->begin().ptr(), data + header.pos_offset, header.pos_size*sizeof(double));
+	}
+	if (ok && w_neg != NULL) {
+		w_neg->resize(header.neg_size);
+		if (header.neg_size > 0)
+			memcpy(w_neg->begin().ptr(), data + header.neg_offset, header.neg_size*sizeof(double));
+	}
+
+	munmap(p, file_size);
+	return ok;
+}
+
+/************************************************************************
+ Function:     write_block
+
+ Description:  Write a weight vector at an aligned offset
+ Inputs:       FILE *fp, uint64_t offset, infra::vector_base &w
+ Output:       none.
+ Comments:     The gap up to the offset is filled with zeros.
+ ***********************************************************************/
+static void write_block(FILE *fp, uint64_t offset, const infra::vector_base &w)
+{
+	static const char zeros[MODEL_FILE_ALIGNMENT] = {0};
+	long gap = offset - ftell(fp);
+	if (gap > 0)
+		fwrite(zeros, 1, gap, fp);
+	for (unsigned long i = 0; i < w.size(); i++) {
+		double value = w[i];
+		fwrite(&value, sizeof(value), 1, fp);
+	}
+}
+
+/************************************************************************
+ Function:     write_model_file
+
+ Description:  Save a binary model, atomically
+ Inputs:       string &filename
+               ModelInfo &info - the options to store
+               infra::vector_base &w_pos, &w_neg - the weights
+ Output:       bool - true on success
+ Comments:     The phi sizes of the manifest are those of the weights.
+ ***********************************************************************/
+bool write_model_file(const std::string &filename, const ModelInfo &info,
+											const infra::vector_base &w_pos, const infra::vector_base &w_neg)
+{
+	std::ostringstream os;
+	os.precision(17);
+	os << "kernel_expansion=" << info.kernel_expansion << "\n";
+	os << "sigma=" << info.sigma << "\n";
+	os << "pos_only=" << (info.pos_only ? 1 : 0) << "\n";
+	os << "ignore_features=" << info.ignore_features << "\n";
+	os << "voicing_tracker=" << info.voicing_tracker << "\n";
+	os << "min_vot_length=" << info.min_vot_length << "\n";
+	os << "max_vot_length=" << info.max_vot_length << "\n";
+	os << "max_onset=" << info.max_onset << "\n";
+	os << "num_features=" << info.num_features << "\n";
+	os << "phi_pos_size=" << w_pos.size() << "\n";
+	os << "phi_neg_size=" << w_neg.size() << "\n";
+	std::map<std::string, std::string>::const_iterator it;
+	for (it = info.metadata.begin(); it != info.metadata.end(); it++) {
+		std::string value = it->second;
+		for (size_t i = 0; i < value.size(); i++)
+			if (value[i] == '\n') value[i] = ' ';
+		os << it->first << "=" << value << "\n";
+	}
+	std::string manifest = os.str();
+
+	ModelFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, MODEL_FILE_MAGIC, sizeof(header.magic));
+	header.version = MODEL_FILE_VERSION;
+	header.byte_order = MODEL_FILE_BYTE_ORDER;
+	header.manifest_offset = MODEL_FILE_ALIGNMENT;
+	header.manifest_size = manifest.size();
+	header.pos_offset = align(header.manifest_offset + header.manifest_size);
+	header.pos_size = w_pos.size();
+	header.neg_offset = align(header.pos_offset + header.pos_size*sizeof(double));
+	header.neg_size = w_neg.size();
+
+	std::string tmp_filename = filename + ".tmp";
+	FILE *fp = fopen(tmp_filename.c_str(), "wb");
+	if (fp == NULL) {
+		LOG(ERROR) << "Unable to open " << tmp_filename << " for writing";
+		return false;
+	}
+	char header_block[MODEL_FILE_ALIGNMENT] = {0};
+	memcpy(header_block, &header, sizeof(header));
+	fwrite(header_block, 1, sizeof(header_block), fp);
+	fwrite(manifest.data(), 1, manifest.size(), fp);
+	write_block(fp, header.pos_offset, w_pos);
+	write_block(fp, header.neg_offset, w_neg);
+	bool ok = (ferror(fp) == 0);
+	ok = (fclose(fp) == 0) && ok;
+	if (!ok || rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+		LOG(ERROR) << "Unable to write " << filename;
+		unlink(tmp_filename.c_str());
+		return false;
+	}
+	return true;
+}
+
+// ------------------------------- EOF -----------------------------//
@@ -0,0 +1,78 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+#ifndef _MODEL_FILE_H
+#define _MODEL_FILE_H
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   ModelFile
+ Purpose:  Binary model file: the weights together with the options
+           they were trained with
+ Date:     19 Oct., 2026
+
+ Layout (native byte order, checked when loading):
+
+   0    header: magic "AVOTMODL", format version, byte order mark,
+        offset and size of the manifest and of the two weight blocks
+   64   manifest: "key=value" lines (the options below, then the
+        training metadata)
+   ...  w_pos, then w_neg, as doubles, each starting at a multiple of
+        MODEL_FILE_ALIGNMENT bytes
+
+ *************************** INCLUDE FILES ******************************/
+#include <string>
+#include <map>
+#include "infra.h"
+
+#define MODEL_FILE_VERSION 1
+#define MODEL_FILE_ALIGNMENT 64
+
+// The options a model was trained with. VotDecode uses them as defaults.
+class ModelInfo
+{
+public:
+  ModelInfo();
+
+public:
+  std::string kernel_expansion;
+  double sigma;
+  bool pos_only;
+  std::string ignore_features;
+  std::string voicing_tracker;  // of the features, "rapt" or "yin"
+  int min_vot_length;
+  int max_vot_length;
+  int max_onset;
+  int num_features;   // front end features per frame
+  int phi_pos_size;   // size of w_pos, after kernel expansion
+  int phi_neg_size;   // size of w_neg
+  int version;        // format version of the file it was read from
+  // training metadata, e.g. "epochs" or "C"
+  std::map<std::string, std::string> metadata;
+};
+
+bool is_model_file(const std::string &filename);
+bool read_model_file(const std::string &filename, ModelInfo &info,
+                     infra::vector *w_pos=NULL, infra::vector *w_neg=NULL);
+bool write_model_file(const std::string &filename, const ModelInfo &info,
+                      const infra::vector_base &w_pos, const infra::vector_base &w_neg);
+
+#endif // _MODEL_FILE_H
@@ -0,0 +1,190 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   Profiler
+ Purpose:  Per-stage wall and CPU time and counters, reported as JSON
+ Date:     19 Oct., 2026
+
+ **************************** INCLUDE FILES *****************************/
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <time.h>
+#include <sys/resource.h>
+#include "Profiler.h"
+#include "Logger.h"
+
+static const char *stage_names[PROFILE_NUM_STAGES] = {
+	"wav_read", "framing", "power_spectrum", "autocorrelation", "fast_pitch", "rapt", "yin",
+	"derived_rows", "normalization", "write", "feature_parse", "predict", "update"
+};
+
+static const char *counter_names[PROFILE_NUM_COUNTERS] = {
+	"utterances", "frames", "candidates_scored", "bytes_read", "bytes_written"
+};
+
+// accumulated over all threads
+static std::atomic<uint64_t> stage_calls[PROFILE_NUM_STAGES];
+static std::atomic<uint64_t> stage_wall_ns[PROFILE_NUM_STAGES];
+static std::atomic<uint64_t> stage_cpu_ns[PROFILE_NUM_STAGES];
+static std::atomic<uint64_t> counters[PROFILE_NUM_COUNTERS];
+
+static std::string profile_program;
+static std::string profile_filename;
+static uint64_t profile_start_ns = 0;
+
+bool Profiler::is_enabled = false;
+
+/************************************************************************
+ Function:     write_profile_at_exit
+
+ Description:  atexit() handler writing the report
+ Inputs:       none.
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+static void write_profile_at_exit()
+{
+	Profiler::write_json(profile_filename);
+}
+
+/************************************************************************
+ Function:     Profiler::enable
+
+ Description:  Start profiling
+ Inputs:       string &program - name of the program in the report
+               string &json_filename - where the report is written at exit
+ Output:       none.
+ Comments:     Called from main() before any thread is started.
+ ***********************************************************************/
+void Profiler::enable(const std::string &program, const std::string &json_filename)
+{
+#ifdef AUTOVOT_NO_PROFILE
+	LOG(WARNING) << "Built with AUTOVOT_NO_PROFILE, no profile is written.";
+#else
+	if (is_enabled)
+		return;
+	profile_program = program;
+	profile_filename = json_filename;
+	profile_start_ns = wall_ns();
+	is_enabled = true;
+	atexit(write_profile_at_exit);
+#endif
+}
+
+/************************************************************************
+ Function:     Profiler::wall_ns, Profiler::thread_cpu_ns
+
+ Description:  Monotonic wall clock and CPU time of the calling thread
+ Inputs:       none.
+ Output:       uint64_t - nanoseconds
+ Comments:     none.
+ ***********************************************************************/
+uint64_t Profiler::wall_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return uint64_t(ts.tv_sec)*1000000000ULL + ts.tv_nsec;
+}
+
+uint64_t Profiler::thread_cpu_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return uint64_t(ts.tv_sec)*1000000000ULL + ts.tv_nsec;
+}
+
+/************************************************************************
+ Function:     Profiler::add
+
+ Description:  Add one call of a stage
+ Inputs:       ProfileStage stage, uint64_t wall_ns, uint64_t cpu_ns
+ Output:       none.
+ Comments:     Thread safe.
+ ***********************************************************************/
+void Profiler::add(ProfileStage stage, uint64_t wall_ns, uint64_t cpu_ns)
+{
+	stage_calls[stage].fetch_add(1, std::memory_order_relaxed);
+	stage_wall_ns[stage].fetch_add(wall_ns, std::memory_order_relaxed);
+	stage_cpu_ns[stage].fetch_add(cpu_ns, std::memory_order_relaxed);
+}
+
+void Profiler::add_count(ProfileCounter counter, uint64_t n)
+{
+	counters[counter].fetch_add(n, std::memory_order_relaxed);
+}
+
+/************************************************************************
+ Function:     Profiler::write_json
+
+ Description:  Write the report
+ Inputs:       string &filename - "-" for the standard error
+ Output:       bool - true on success
+ Comments:     The times of a stage are summed over the threads that ran
+               it, so with several threads they can exceed wall_sec.
+ ***********************************************************************/
+bool Profiler::write_json(const std::string &filename)
+{
+	std::ofstream ofs;
+	if (filename != "-") {
+		ofs.open(filename.c_str());
+		if (!ofs.good()) {
+			LOG(ERROR) << "Unable to open " << filename << " for writing";
+			return false;
+		}
+	}
+	std::ostream &os = (filename == "-") ? std::cerr : ofs;
+
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	double cpu_sec = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec*1e-6 +
+		usage.ru_stime.tv_sec + usage.ru_stime.tv_usec*1e-6;
+
+	os.precision(6);
+	os << std::fixed;
+	os << "{\n";
+	os << "  \"program\": \"" << profile_program << "\",\n";
+	os << "  \"wall_sec\": " << (wall_ns() - profile_start_ns)*1e-9 << ",\n";
+	os << "  \"cpu_sec\": " << cpu_sec << ",\n";
+	os << "  \"max_rss_kb\": " << usage.ru_maxrss << ",\n";
+	os << "  \"stages\": {\n";
+	for (int i = 0; i < PROFILE_NUM_STAGES; i++) {
+		os << "    \"" << stage_names[i] << "\": {\"calls\": " << stage_calls[i].load()
+		<< ", \"wall_sec\": " << stage_wall_ns[i].load()*1e-9
+		<< ", \"cpu_sec\": " << stage_cpu_ns[i].load()*1e-9 << "}"
+		<< (i+1 < PROFILE_NUM_STAGES ? ",\n" : "\n");
+	}
+	os << "  },\n";
+	os << "  \"counters\": {\n";
+	for (int i = 0; i < PROFILE_NUM_COUNTERS; i++) {
+		os << "    \"" << counter_names[i] << "\": " << counters[i].load()
+		<< (i+1 < PROFILE_NUM_COUNTERS ? ",\n" : "\n");
+	}
+	os << "  }\n";
+	os << "}\n";
+
+	return os.good();
+}
+
+// ------------------------------- EOF -----------------------------//
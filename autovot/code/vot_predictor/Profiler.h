@@ -0,0 +1,118 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+#ifndef _PROFILER_H
+#define _PROFILER_H
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   Profiler
+ Purpose:  Per-stage wall and CPU time and counters, reported as JSON
+ Date:     19 Oct., 2026
+
+ A stage is timed by a ProfileScope, which checks a flag once when it
+ is created and does nothing else when profiling is off. Building with
+ -DAUTOVOT_NO_PROFILE removes the instrumentation altogether.
+
+ *************************** INCLUDE FILES ******************************/
+#include <string>
+#include <stdint.h>
+
+enum ProfileStage {
+  PROFILE_WAV_READ,
+  PROFILE_FRAMING,
+  PROFILE_POWER_SPECTRUM,
+  PROFILE_AUTOCORRELATION,
+  PROFILE_FAST_PITCH,
+  PROFILE_RAPT,
+  PROFILE_YIN,
+  PROFILE_DERIVED_ROWS,
+  PROFILE_NORMALIZATION,
+  PROFILE_WRITE,
+  PROFILE_FEATURE_PARSE,
+  PROFILE_PREDICT,
+  PROFILE_UPDATE,
+  PROFILE_NUM_STAGES
+};
+
+enum ProfileCounter {
+  PROFILE_UTTERANCES,
+  PROFILE_FRAMES,
+  PROFILE_CANDIDATES,
+  PROFILE_BYTES_READ,
+  PROFILE_BYTES_WRITTEN,
+  PROFILE_NUM_COUNTERS
+};
+
+class Profiler
+{
+public:
+  // start profiling, the report is written to json_filename at exit
+  static void enable(const std::string &program, const std::string &json_filename);
+#ifdef AUTOVOT_NO_PROFILE
+  static bool enabled() { return false; }
+#else
+  static bool enabled() { return is_enabled; }
+#endif
+  static void add(ProfileStage stage, uint64_t wall_ns, uint64_t cpu_ns);
+  static void count(ProfileCounter counter, uint64_t n) { if (enabled()) add_count(counter, n); }
+  static bool write_json(const std::string &filename);
+  static uint64_t wall_ns();
+  static uint64_t thread_cpu_ns();
+
+private:
+  static void add_count(ProfileCounter counter, uint64_t n);
+  static bool is_enabled;
+};
+
+// Times a stage from its construction to its destruction or to next()
+class ProfileScope
+{
+public:
+#ifdef AUTOVOT_NO_PROFILE
+  explicit ProfileScope(ProfileStage) {}
+  void next(ProfileStage) {}
+#else
+  explicit ProfileScope(ProfileStage _stage) :
+  stage(_stage), active(Profiler::enabled()), wall_start(0), cpu_start(0) {
+    if (active) start();
+  }
+  ~ProfileScope() { if (active) stop(); }
+  // end the current stage and start another one
+  void next(ProfileStage _stage) {
+    if (!active) return;
+    stop();
+    stage = _stage;
+    start();
+  }
+
+private:
+  void start() { wall_start = Profiler::wall_ns(); cpu_start = Profiler::thread_cpu_ns(); }
+  void stop() { Profiler::add(stage, Profiler::wall_ns()-wall_start, Profiler::thread_cpu_ns()-cpu_start); }
+
+  ProfileStage stage;
+  bool active;
+  uint64_t wall_start;
+  uint64_t cpu_start;
+#endif
+};
+
+#endif // _PROFILER_H
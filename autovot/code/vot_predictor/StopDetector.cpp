@@ -0,0 +1,338 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   StopDetector
+ Purpose:  VOT detection over unsegmented long recordings
+ Date:     19 Oct., 2026
+
+ **************************** INCLUDE FILES *****************************/
+#include <cmath>
+#include <algorithm>
+#include "StopDetector.h"
+#include "FrontEnd.h"
+#include "infra_dsp.h"
+#include "Logger.h"
+
+// signal passed to extract_features() around a window, in seconds
+#define FEATURE_MARGIN 0.1
+
+/************************************************************************
+ Function:     StopDetectorOptions::StopDetectorOptions
+
+ Description:  Constructor, the defaults of VotDetect
+ Inputs:       none.
+ Output:       none.
+ Comments:     The window starts before a burst as those of
+               auto_vot_decode.py, and is long enough for the default
+               max. onset and VOT length.
+ ***********************************************************************/
+StopDetectorOptions::StopDetectorOptions() :
+block_size(10.0),
+window_before(0.05),
+window_after(0.4),
+burst_rise(18.0),
+closure(0.02),
+min_gap(0.1),
+voicing_distance(0.2),
+min_confidence(-HUGE_VAL),
+voicing_tracker(VOICING_RAPT),
+pos_only(false),
+text_precision(true)
+{
+}
+
+/************************************************************************
+ Function:     StopDetector::StopDetector
+
+ Description:  Constructor
+ Inputs:       Classifier &_classifier - decodes the proposed windows
+               StopDetectorOptions &_options
+               double _sampling_rate
+ Output:       none.
+ Comments:     All the sample counts are multiples of the frame step, so
+               the frames of a window fall on the frames of the whole
+               recording.
+ ***********************************************************************/
+StopDetector::StopDetector(Classifier &_classifier, const StopDetectorOptions &_options,
+													 double _sampling_rate) :
+classifier(_classifier),
+options(_options),
+sampling_rate(_sampling_rate),
+frame_step(int(_sampling_rate*FRAME_SIZE)),
+buffer_start(0),
+block_start(0),
+proposals(0)
+{
+	unsigned long block_frames = (unsigned long)(ceil(options.block_size/FRAME_SIZE));
+	block_samples = _max(block_frames, 1UL)*frame_step;
+	double track_margin = options.closure + options.voicing_distance;
+	lookahead = (unsigned long)(ceil(_max(track_margin, options.window_after + FEATURE_MARGIN)/FRAME_SIZE))*frame_step;
+	lookbehind = (unsigned long)(ceil(_max(track_margin, options.window_before + FEATURE_MARGIN)/FRAME_SIZE))*frame_step;
+}
+
+/************************************************************************
+ Function:     StopDetector::push
+
+ Description:  Add samples of the recording
+ Inputs:       double *samples, unsigned long num_samples
+               vector<VotDetection> &detections - the final detections
+               are appended
+ Output:       none.
+ Comments:     A block is processed once the context of its windows has
+               arrived.
+ ***********************************************************************/
+void StopDetector::push(const double *samples, unsigned long num_samples,
+												std::vector<VotDetection> &detections)
+{
+	buffer.insert(buffer.end(), samples, samples + num_samples);
+	while (buffer_end() >= block_start + block_samples + lookahead)
+		process_block(detections);
+}
+
+/************************************************************************
+ Function:     StopDetector::finish
+
+ Description:  Process the end of the recording
+ Inputs:       vector<VotDetection> &detections
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+void StopDetector::finish(std::vector<VotDetection> &detections)
+{
+	while (block_start < buffer_end())
+		process_block(detections);
+	emit(HUGE_VAL, detections);
+}
+
+/************************************************************************
+ Function:     StopDetector::process_block
+
+ Description:  Propose bursts in the next block and decode their windows
+ Inputs:       vector<VotDetection> &detections
+ Output:       none.
+ Comments:     Detections are released once no later window can overlap
+               them, and the samples no later window needs are dropped.
+ ***********************************************************************/
+void StopDetector::process_block(std::vector<VotDetection> &detections)
+{
+	unsigned long block_end = _min(block_start + block_samples, buffer_end());
+	std::vector<unsigned long> bursts;
+	propose(block_start, block_end, bursts);
+	proposals += bursts.size();
+	for (unsigned int i = 0; i < bursts.size(); i++) {
+		VotDetection detection;
+		if (detect(bursts[i], detection))
+			add_pending(detection);
+	}
+	LOG(DEBUG) << "Block " << block_start/sampling_rate << "-" << block_end/sampling_rate
+	<< " sec: " << bursts.size() << " proposals";
+
+	block_start = block_end;
+	emit(block_start/sampling_rate - options.window_before, detections);
+
+	unsigned long keep_from = (block_start > lookbehind) ? block_start - lookbehind : 0;
+	if (keep_from > buffer_start) {
+		buffer.erase(buffer.begin(), buffer.begin() + (keep_from - buffer_start));
+		buffer_start = keep_from;
+	}
+}
+
+/************************************************************************
+ Function:     StopDetector::propose
+
+ Description:  Propose stop bursts
+ Inputs:       unsigned long first, last - the samples of the block
+               vector<unsigned long> &bursts - the sample of each burst
+ Output:       none.
+ Comments:     A burst is a frame whose high frequency energy (above
+               3 kHz, as in the front end) is burst_rise dB above its
+               minimum over the preceding closure, with voicing
+               within voicing_distance. Of proposals closer than min_gap
+               the one of the largest rise is kept.
+ ***********************************************************************/
+void StopDetector::propose(unsigned long first, unsigned long last, std::vector<unsigned long> &bursts)
+{
+	unsigned long track_margin = (unsigned long)(ceil((options.closure + options.voicing_distance)/FRAME_SIZE))*frame_step;
+	unsigned long track_first = (first > buffer_start + track_margin) ? first - track_margin : buffer_start;
+	unsigned long track_last = _min(last + track_margin, buffer_end());
+	int frame_length = int(sampling_rate*WIN_SIZE);
+	if (track_last < track_first + frame_length)
+		return;
+	int num_frames = (track_last - track_first - frame_length)/frame_step + 1;
+
+	// high frequency energy
+	int nfft = 256;
+	int first_bin = int(ceil(3000.0*nfft/sampling_rate));
+	std::vector<double> high_energy(num_frames);
+	for (int k = 0; k < num_frames; k++) {
+		unsigned long offset = track_first - buffer_start + k*frame_step;
+		infra::vector power = powerspectrum(hamming(infra::vector_base::external(&buffer[offset], frame_length)), nfft);
+		double sum = 0.0;
+		for (int i = first_bin; i < nfft/2+1; i++)
+			sum += power[i];
+		high_energy[k] = 10.0*log10(sum + 1e-12);
+	}
+
+	// voicing, as a running count of the voiced frames
+	infra::vector vuv;
+	voicing_decisions(&buffer[track_first - buffer_start], track_last - track_first, sampling_rate,
+										options.voicing_tracker, vuv);
+	int rapt_step = int(RAPT_PITCH_FRAME_STEP*sampling_rate);
+	std::vector<int> voiced(num_frames+1, 0);
+	for (int k = 0; k < num_frames; k++) {
+		int j = (k*frame_step + frame_length/2 - rapt_step/2)/rapt_step;
+		bool is_voiced = (j >= 0 && j < int(vuv.size()) && vuv[j] > 0.5);
+		voiced[k+1] = voiced[k] + (is_voiced ? 1 : 0);
+	}
+
+	int closure_frames = _max(int(options.closure/FRAME_SIZE), 1);
+	int voicing_frames = int(options.voicing_distance/FRAME_SIZE);
+	std::vector< std::pair<double, int> > candidates;
+	for (int k = closure_frames; k < num_frames; k++) {
+		unsigned long center = track_first + k*frame_step + frame_length/2;
+		if (center < first || center >= last)
+			continue;
+		double closure_min = high_energy[k-closure_frames];
+		for (int i = k-closure_frames+1; i < k; i++)
+			closure_min = _min(closure_min, high_energy[i]);
+		double rise = high_energy[k] - closure_min;
+		if (rise < options.burst_rise)
+			continue;
+		int v_first = _max(k - voicing_frames, 0);
+		int v_last = _min(k + voicing_frames + 1, num_frames);
+		if (voiced[v_last] - voiced[v_first] == 0)
+			continue;
+		candidates.push_back(std::make_pair(-rise, k));
+	}
+
+	// the largest rises first, without others within min_gap
+	std::sort(candidates.begin(), candidates.end());
+	int gap_frames = int(options.min_gap/FRAME_SIZE);
+	std::vector<int> accepted;
+	for (unsigned int c = 0; c < candidates.size(); c++) {
+		bool too_close = false;
+		for (unsigned int a = 0; a < accepted.size() && !too_close; a++)
+			too_close = (abs(accepted[a] - candidates[c].second) < gap_frames);
+		if (!too_close)
+			accepted.push_back(candidates[c].second);
+	}
+	std::sort(accepted.begin(), accepted.end());
+	for (unsigned int a = 0; a < accepted.size(); a++)
+		bursts.push_back(track_first + accepted[a]*frame_step + frame_length/2);
+}
+
+/************************************************************************
+ Function:     StopDetector::detect
+
+ Description:  Decode the window of a proposed burst
+ Inputs:       unsigned long burst - sample of the burst
+               VotDetection &detection
+ Output:       bool - true if a VOT was detected
+ Comments:     The window is clipped to the recording.
+ ***********************************************************************/
+bool StopDetector::detect(unsigned long burst, VotDetection &detection)
+{
+	double burst_time = burst/sampling_rate;
+	double window_start = _max(burst_time - options.window_before, 0.0);
+	double window_end = _min(burst_time + options.window_after, (buffer_end()-1)/sampling_rate);
+
+	// the window and its context, starting on a frame of the recording
+	unsigned long margin = (unsigned long)(ceil(FEATURE_MARGIN/FRAME_SIZE))*frame_step;
+	unsigned long window_first = (unsigned long)(window_start*sampling_rate)/frame_step*frame_step;
+	unsigned long segment_first = (window_first > buffer_start + margin) ? window_first - margin : buffer_start;
+	unsigned long segment_last = _min((unsigned long)(window_end*sampling_rate) + margin, buffer_end());
+	infra::vector samples(segment_last - segment_first);
+	for (unsigned long i = 0; i < samples.size(); i++)
+		samples[i] = buffer[segment_first - buffer_start + i];
+	double offset = segment_first/sampling_rate;
+
+	infra::matrix features;
+	infra::vector frame_times;
+	int first_frame;
+	if (!extract_features(samples, sampling_rate, window_start - offset, window_end - offset, true,
+												features, frame_times, first_frame, options.voicing_tracker)) {
+		LOG(DEBUG) << "Unable to extract the features of the window at " << window_start << " sec";
+		return false;
+	}
+	SpeechUtterance x;
+	features_to_utterance(features, options.text_precision, x);
+	// Classifier::predict needs room for the shortest VOT and the feature span
+	if (int(x.size()) <= classifier.get_min_vot_length() + PHI_SPAN)
+		return false;
+
+	VotLocation y_hat;
+	double confidence = classifier.predict(x, y_hat, options.pos_only);
+	if (confidence < options.min_confidence)
+		return false;
+	detection.negative = y_hat.is_neg();
+	detection.start = window_start + _min(y_hat.burst, y_hat.voice)*FRAME_SIZE;
+	detection.end = window_start + _max(y_hat.burst, y_hat.voice)*FRAME_SIZE;
+	detection.confidence = confidence;
+	return true;
+}
+
+/************************************************************************
+ Function:     StopDetector::add_pending
+
+ Description:  Add a detection, resolving overlaps
+ Inputs:       VotDetection &detection
+ Output:       none.
+ Comments:     Of overlapping detections (the windows of nearby
+               proposals often find the same VOT) the most confident one
+               is kept.
+ ***********************************************************************/
+void StopDetector::add_pending(const VotDetection &detection)
+{
+	std::vector<VotDetection> kept;
+	for (unsigned int i = 0; i < pending.size(); i++) {
+		bool overlaps = (pending[i].start <= detection.end && detection.start <= pending[i].end);
+		if (!overlaps)
+			kept.push_back(pending[i]);
+		else if (pending[i].confidence >= detection.confidence)
+			return;
+	}
+	unsigned int i = 0;
+	while (i < kept.size() && kept[i].start < detection.start)
+		i++;
+	kept.insert(kept.begin() + i, detection);
+	pending.swap(kept);
+}
+
+/************************************************************************
+ Function:     StopDetector::emit
+
+ Description:  Release the detections that end before a time
+ Inputs:       double before - in seconds
+               vector<VotDetection> &detections
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+void StopDetector::emit(double before, std::vector<VotDetection> &detections)
+{
+	unsigned int i = 0;
+	while (i < pending.size() && pending[i].end < before)
+		detections.push_back(pending[i++]);
+	pending.erase(pending.begin(), pending.begin() + i);
+}
+
+// ------------------------------- EOF -----------------------------//
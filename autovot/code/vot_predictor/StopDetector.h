@@ -0,0 +1,111 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+#ifndef _STOP_DETECTOR_H
+#define _STOP_DETECTOR_H
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   StopDetector
+ Purpose:  VOT detection over unsegmented long recordings
+ Date:     19 Oct., 2026
+
+ The samples are pushed in pieces of any size and processed in blocks.
+ In each block, stop bursts are proposed where the high frequency
+ energy rises sharply after a closure, near voicing (the decisions of
+ the voicing tracker of the model). Every proposal gets a window as the ones of
+ auto_vot_decode.py, whose features are extracted and decoded by the
+ classifier. Only a block and the context of its windows are kept in
+ memory.
+
+ *************************** INCLUDE FILES ******************************/
+#include <vector>
+#include "infra.h"
+#include "Classifier.h"
+#include "FrontEnd.h"
+
+class StopDetectorOptions
+{
+public:
+  StopDetectorOptions();
+
+public:
+  double block_size;        // seconds of audio processed at once
+  double window_before;     // window start before the proposed burst
+  double window_after;      // window end after the proposed burst
+  double burst_rise;        // dB of high frequency energy rise of a burst
+  double closure;           // the rise is over the minimum of this long
+  double min_gap;           // seconds between two proposals
+  double voicing_distance;  // voicing must be this close to a burst
+  double min_confidence;    // detections below it are dropped
+  VoicingTracker voicing_tracker;  // of the features and the proposals
+  bool pos_only;
+  bool text_precision;      // round the features as in a features file
+};
+
+// a detected VOT, in seconds from the start of the recording
+class VotDetection
+{
+public:
+  double start;
+  double end;
+  double confidence;
+  bool negative;            // prevoiced: the voicing starts before the burst
+};
+
+class StopDetector
+{
+public:
+  StopDetector(Classifier &_classifier, const StopDetectorOptions &_options,
+               double _sampling_rate);
+  // add samples, the detections that cannot change anymore are appended
+  void push(const double *samples, unsigned long num_samples,
+            std::vector<VotDetection> &detections);
+  // process the rest of the recording
+  void finish(std::vector<VotDetection> &detections);
+  unsigned long num_proposals() { return proposals; }
+  // samples held, at most a block and the context of its windows
+  unsigned long buffer_size() { return buffer.size(); }
+
+protected:
+  void process_block(std::vector<VotDetection> &detections);
+  void propose(unsigned long first, unsigned long last, std::vector<unsigned long> &bursts);
+  bool detect(unsigned long burst, VotDetection &detection);
+  void add_pending(const VotDetection &detection);
+  void emit(double before, std::vector<VotDetection> &detections);
+  unsigned long buffer_end() { return buffer_start + buffer.size(); }
+
+protected:
+  Classifier &classifier;
+  StopDetectorOptions options;
+  double sampling_rate;
+  int frame_step;               // samples per front end frame
+  unsigned long block_samples;
+  unsigned long lookahead;      // samples needed after a block
+  unsigned long lookbehind;     // samples kept before a block
+  std::vector<double> buffer;   // samples from buffer_start on
+  unsigned long buffer_start;
+  unsigned long block_start;
+  std::vector<VotDetection> pending;   // may still be replaced
+  unsigned long proposals;
+};
+
+#endif // _STOP_DETECTOR_H
@@ -0,0 +1,687 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   Main entry point
+ Purpose:  Microbenchmarks of the front end and of the classifier
+ Date:     19 Oct., 2026
+
+ Every benchmark runs on windows of several lengths, either of a
+ synthetic utterance (silence, burst, aspiration, then a voiced vowel)
+ or of a wav file repeated up to the length. The time per operation is
+ reported with the throughput in frames per second and, for each
+ benchmark, the exponent of its time as a function of the window length.
+ The whole suite runs several times, and the time of a benchmark is its
+ median over the rounds, so a slow period of the machine, which lasts
+ longer than one benchmark, does not show as a regression. The results
+ can be saved and later compared against, to find regressions.
+
+ **************************** INCLUDE FILES *****************************/
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cmdline/cmd_line.h>
+#include "Classifier.h"
+#include "Dataset.h"
+#include "FrontEnd.h"
+#include "IncrementalDecoder.h"
+#include "Profiler.h"
+#include "infra_dsp.h"
+#include "get_f0s.h"
+#include "Logger.h"
+
+using namespace std;
+
+// silence before and after the window, in seconds
+#define BENCH_PADDING 0.05
+// the incremental decoder scores no frame before its z-score warm-up of
+// 100 frames and the look-ahead of the features, so it decodes at least
+// this many msec
+#define INCREMENTAL_MIN_MS 200
+
+// one measurement
+struct BenchResult
+{
+	string name;
+	string source;      // "synthetic" or "wav"
+	string param;       // kernel or variant, "-" if none
+	int length_ms;      // window length, 0 if it does not apply
+	double ns_per_op;
+	double frames;      // frames processed by one operation
+};
+
+// keeps the compiler from dropping the benchmarked calls
+static volatile double bench_sink = 0.0;
+
+/************************************************************************
+ Function:     synthetic_samples
+
+ Description:  A deterministic synthetic stop-vowel utterance
+ Inputs:       double length - duration of the window in seconds
+               double sampling_rate
+ Output:       infra::vector - the window with BENCH_PADDING of
+               silence on both sides
+ Comments:     The burst is at 30% of the window and the voicing starts
+               40 msec later, or at 45% of short windows.
+ ***********************************************************************/
+static infra::vector synthetic_samples(double length, double sampling_rate)
+{
+	int padding = int(BENCH_PADDING*sampling_rate);
+	int n = int(length*sampling_rate);
+	int burst = int(0.3*n);
+	int voice = _min(burst + int(0.04*sampling_rate), int(0.45*n));
+	infra::vector x(n + 2*padding);
+
+	unsigned long seed = 12345;
+	for (int i = 0; i < int(x.size()); i++) {
+		// linear congruential noise in [-1,1]
+		seed = (seed*1103515245 + 12345) & 0x7fffffff;
+		double noise = 2.0*seed/double(0x7fffffff) - 1.0;
+		int j = i - padding;
+		double value = 0.001*noise;
+		if (j >= burst && j < voice) {
+			double t = (j-burst)/sampling_rate;
+			value += noise*(0.05 + 0.5*exp(-t/0.003));
+		}
+		else if (j >= voice && j < n) {
+			double t = j/sampling_rate;
+			for (int k = 1; k <= 5; k++)
+				value += 0.3/k*sin(2*M_PI*120*k*t);
+			value += 0.01*noise;
+		}
+		x[i] = value;
+	}
+	return x;
+}
+
+/************************************************************************
+ Function:     tiled_samples
+
+ Description:  A wav file repeated up to a given duration
+ Inputs:       infra::vector &wav, double length, double sampling_rate
+ Output:       infra::vector - the window with BENCH_PADDING on both
+               sides
+ Comments:     none.
+ ***********************************************************************/
+static infra::vector tiled_samples(const infra::vector &wav, double length, double sampling_rate)
+{
+	int n = int((length + 2*BENCH_PADDING)*sampling_rate);
+	infra::vector x(n);
+	for (int i = 0; i < n; i++)
+		x[i] = wav[i % wav.size()];
+	return x;
+}
+
+/************************************************************************
+ Function:     time_op
+
+ Description:  Time an operation
+ Inputs:       function<void()> op, double min_time - in seconds
+ Output:       double - nanoseconds per call of op
+ Comments:     After a warm-up call the number of calls is doubled until
+               they take at least min_time.
+ ***********************************************************************/
+static double time_op(const function<void()> &op, double min_time)
+{
+	op();
+	uint64_t min_ns = uint64_t(min_time*1e9);
+	for (uint64_t iterations = 1; ; iterations *= 2) {
+		uint64_t start = Profiler::wall_ns();
+		for (uint64_t i = 0; i < iterations; i++)
+			op();
+		uint64_t elapsed = Profiler::wall_ns() - start;
+		if (elapsed >= min_ns || iterations >= (uint64_t(1) << 40))
+			return elapsed/double(iterations);
+	}
+}
+
+/************************************************************************
+ Function:     split
+
+ Description:  Split a comma separated list
+ Inputs:       string &list
+ Output:       vector<string> - the items, empty items included
+ Comments:     none.
+ ***********************************************************************/
+static vector<string> split(const string &list)
+{
+	vector<string> items;
+	istringstream is(list);
+	string item;
+	while (getline(is, item, ','))
+		items.push_back(item);
+	if (list.size() > 0 && list[list.size()-1] == ',')
+		items.push_back("");
+	return items;
+}
+
+/************************************************************************
+ Function:     result_key
+
+ Description:  The key that matches a result with its baseline
+ Inputs:       BenchResult &r
+ Output:       string
+ Comments:     none.
+ ***********************************************************************/
+static string result_key(const BenchResult &r)
+{
+	ostringstream os;
+	os << r.name << "\t" << r.source << "\t" << r.param << "\t" << r.length_ms;
+	return os.str();
+}
+
+// Runs the benchmarks that pass the filter, collecting the time of each
+// in every round of the suite
+class Bench
+{
+public:
+	Bench(const string &_filter, double _min_time) : filter(_filter), min_time(_min_time) {}
+	void run(const string &name, const string &source, const string &param,
+					 int length_ms, double frames, const function<void()> &op)
+	{
+		if (filter != "" && name.find(filter) == string::npos)
+			return;
+		BenchResult r;
+		r.name = name;
+		r.source = source;
+		r.param = (param == "" ? "-" : param);
+		r.length_ms = length_ms;
+		r.frames = frames;
+		r.ns_per_op = time_op(op, min_time);
+		string key = result_key(r);
+		map<string, int>::iterator it = index.find(key);
+		if (it == index.end()) {
+			index[key] = results.size();
+			results.push_back(r);
+			times.push_back(vector<double>());
+			it = index.find(key);
+		}
+		times[it->second].push_back(r.ns_per_op);
+	}
+	// Set the time of each result to its median over the rounds, and print
+	// the results
+	void finish()
+	{
+		for (unsigned int i = 0; i < results.size(); i++) {
+			vector<double> &t = times[i];
+			nth_element(t.begin(), t.begin() + t.size()/2, t.end());
+			BenchResult &r = results[i];
+			r.ns_per_op = t[t.size()/2];
+			cout << setw(26) << left << r.name << setw(10) << r.source << setw(8) << r.param
+			<< setw(8) << right << r.length_ms << setw(16) << fixed << setprecision(0) << r.ns_per_op
+			<< setw(16) << setprecision(0) << r.frames*1e9/r.ns_per_op << endl;
+		}
+	}
+
+public:
+	vector<BenchResult> results;
+
+private:
+	string filter;
+	double min_time;
+	map<string, int> index;           // of the results, by result_key()
+	vector<vector<double> > times;    // ns/op of each result in each round
+};
+
+/************************************************************************
+ Function:     bench_front_end
+
+ Description:  Benchmark the front end functions on a window
+ Inputs:       Bench &bench, string &source, int length_ms
+               infra::vector &samples - the window with its padding
+               double sampling_rate
+ Output:       none.
+ Comments:     The calls are made on the same data, and with the same
+               parameters, as in extract_features().
+ ***********************************************************************/
+static void bench_front_end(Bench &bench, const string &source, int length_ms,
+														const infra::vector &samples, double sampling_rate)
+{
+	int frame_length = int(sampling_rate*WIN_SIZE);
+	int frame_step = int(sampling_rate*FRAME_SIZE);
+	int padding = int(BENCH_PADDING*sampling_rate);
+	int num_frames = length_ms;
+	infra::vector word_samples = samples.subvector(padding, int(length_ms/1000.0*sampling_rate));
+
+	// hamming windowed frames
+	infra::matrix frames(frame_length, num_frames);
+	for (int j = 0; j < num_frames; j++) {
+		infra::vector frame(frame_length);
+		for (int k = 0; k < frame_length; k++)
+			frame[k] = samples[padding + j*frame_step + k];
+		frames.column(j) = hamming(frame);
+	}
+
+	bench.run("powerspectrum", source, "", length_ms, num_frames, [&]() {
+		for (int j = 0; j < num_frames; j++)
+			bench_sink = bench_sink + powerspectrum(frames.column(j), 256)[1];
+	});
+
+	bench.run("autocorrelation_features", source, "", length_ms, num_frames, [&]() {
+		for (int j = 0; j < num_frames; j++) {
+			int center = padding + j*frame_step + frame_length/2;
+			int first = _max(center-ACORR_LEFT, 0);
+			int last = _min(center+ACORR_RIGHT, int(samples.size()));
+			bench_sink = bench_sink + autocorrelation_features(samples.subvector(first, last-first));
+		}
+	});
+
+	bench.run("fast_pitch", source, "", length_ms, num_frames, [&]() {
+		infra::vector f0, cost;
+		fast_pitch(word_samples, FAST_PITCH_WIN_SIZE, 0.2, 0.0, sampling_rate, f0, cost);
+		bench_sink = bench_sink + f0.size();
+	});
+
+	bench.run("get_f0s_main", source, "", length_ms, num_frames, [&]() {
+		infra::vector f0, vuv, rms_speech, acpkp;
+		get_f0s_main(word_samples, f0, vuv, rms_speech, acpkp,
+								 RAPT_PITCH_FRAME_STEP, RAPT_PITCH_WIN_DUR, sampling_rate);
+		bench_sink = bench_sink + f0.size();
+	});
+
+	// a per-frame track like the short-term energy
+	infra::vector energy(num_frames);
+	for (int j = 0; j < num_frames; j++)
+		energy[j] = frames.column(j).norm2();
+
+	bench.run("diff_means", source, "", length_ms, num_frames, [&]() {
+		bench_sink = bench_sink + diff_means(energy, 10)[0];
+	});
+
+	bench.run("cummulative_features", source, "mean", length_ms, num_frames, [&]() {
+		bench_sink = bench_sink + cummulative_features(energy, "mean", -5)[0];
+	});
+
+	bench.run("cummulative_features", source, "max", length_ms, num_frames, [&]() {
+		bench_sink = bench_sink + cummulative_features(energy, "max", -5)[0];
+	});
+}
+
+/************************************************************************
+ Function:     bench_classifier
+
+ Description:  Benchmark phi and the prediction on a window
+ Inputs:       Bench &bench, string &source, int length_ms
+               infra::vector &samples - the window with its padding
+               infra::vector &incremental_samples - the same, of at least
+               INCREMENTAL_MIN_MS
+               double sampling_rate, vector<string> &kernels
+ Output:       none.
+ Comments:     The weights are pseudo random, the time of a prediction
+               does not depend on them.
+ ***********************************************************************/
+static void bench_classifier(Bench &bench, const string &source, int length_ms,
+														 const infra::vector &samples,
+														 const infra::vector &incremental_samples, double sampling_rate,
+														 const vector<string> &kernels)
+{
+	infra::matrix features;
+	infra::vector frame_times;
+	int first_frame;
+	if (!extract_features(samples, sampling_rate, BENCH_PADDING, BENCH_PADDING + length_ms/1000.0,
+												true, features, frame_times, first_frame)) {
+		LOG(ERROR) << "Unable to extract the features of a window of " << length_ms << " msec";
+		exit(-1);
+	}
+	SpeechUtterance x;
+	features_to_utterance(features, false, x);
+	int num_frames = x.size();
+
+	for (unsigned int i = 0; i < kernels.size(); i++) {
+		Classifier classifier(15, 200, 150, 0, 0, 0, 0, kernels[i], 1.0);
+		infra::vector w_pos(classifier.get_kernel_phi_size_pos());
+		infra::vector w_neg(classifier.get_phi_size_neg());
+		unsigned long seed = 54321;
+		for (unsigned long k = 0; k < w_pos.size() + w_neg.size(); k++) {
+			seed = (seed*1103515245 + 12345) & 0x7fffffff;
+			double value = seed/double(0x7fffffff) - 0.5;
+			if (k < w_pos.size()) w_pos[k] = value;
+			else w_neg[k-w_pos.size()] = value;
+		}
+		classifier.set_w(w_pos, w_neg);
+
+		if (i == 0) {
+			VotLocation y_pos;
+			y_pos.burst = num_frames*3/10;
+			y_pos.voice = _min(y_pos.burst + 40, num_frames-1);
+			VotLocation y_neg;
+			y_neg.burst = y_pos.voice;
+			y_neg.voice = y_pos.burst;
+			bench.run("phi_pos", source, "", length_ms, 1, [&]() {
+				bench_sink = bench_sink + classifier.phi_pos(x, y_pos)[0];
+			});
+			bench.run("phi_neg", source, "", length_ms, 1, [&]() {
+				bench_sink = bench_sink + classifier.phi_neg(x, y_neg)[0];
+			});
+		}
+
+		bench.run("Classifier::predict", source, kernels[i] == "" ? "linear" : kernels[i],
+							length_ms, num_frames, [&]() {
+			VotLocation y_hat;
+			bench_sink = bench_sink + classifier.predict(x, y_hat);
+		});
+
+		// the same window decoded while its samples arrive, up to the horizon,
+		// extended past the warm-up of the decoder
+		IncrementalDecoder decoder(classifier, sampling_rate);
+		int padding = int(BENCH_PADDING*sampling_rate);
+		unsigned long num_samples = incremental_samples.size() - 2*padding;
+		decoder.push(&incremental_samples[padding], num_samples);
+		bench.run("IncrementalDecoder::push", source, kernels[i] == "" ? "linear" : kernels[i],
+							length_ms, decoder.frames_scored(), [&]() {
+			decoder.reset();
+			decoder.push(&incremental_samples[padding], num_samples);
+			bench_sink = bench_sink + decoder.frames_scored();
+		});
+	}
+}
+
+/************************************************************************
+ Function:     bench_kernels
+
+ Description:  Benchmark the kernel expansion of a phi vector
+ Inputs:       Bench &bench, vector<string> &kernels
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+static void bench_kernels(Bench &bench, const vector<string> &kernels)
+{
+	Classifier linear(15, 200, 150, 0, 0, 0, 0, "", 1.0);
+	infra::vector phi(linear.get_phi_size_pos());
+	for (int k = 0; k < int(phi.size()); k++)
+		phi[k] = sin(0.1*k);
+	for (unsigned int i = 0; i < kernels.size(); i++) {
+		KernelExpansion kernel(kernels[i], phi.size(), 1.0);
+		bench.run("KernelExpansion::expand", "synthetic", kernels[i] == "" ? "linear" : kernels[i],
+							0, 1, [&]() {
+			bench_sink = bench_sink + kernel.expand(phi)[0];
+		});
+	}
+}
+
+/************************************************************************
+ Function:     print_scaling
+
+ Description:  Print how the time of each benchmark grows with the
+               window length
+ Inputs:       vector<BenchResult> &results
+ Output:       none.
+ Comments:     The exponent is the least squares slope of log(ns/op)
+               against log(length): 1 is linear, 2 quadratic.
+ ***********************************************************************/
+static void print_scaling(const vector<BenchResult> &results)
+{
+	map<string, vector<const BenchResult*> > curves;
+	vector<string> order;
+	for (unsigned int i = 0; i < results.size(); i++) {
+		if (results[i].length_ms <= 0)
+			continue;
+		string key = results[i].name + "\t" + results[i].source + "\t" + results[i].param;
+		if (curves.find(key) == curves.end())
+			order.push_back(key);
+		curves[key].push_back(&results[i]);
+	}
+
+	cout << endl << "scaling exponent of ns/op in the window length" << endl;
+	for (unsigned int i = 0; i < order.size(); i++) {
+		const vector<const BenchResult*> &curve = curves[order[i]];
+		if (curve.size() < 2)
+			continue;
+		double sx = 0, sy = 0, sxx = 0, sxy = 0;
+		int n = curve.size();
+		for (int k = 0; k < n; k++) {
+			double lx = log(double(curve[k]->length_ms));
+			double ly = log(curve[k]->ns_per_op);
+			sx += lx; sy += ly; sxx += lx*lx; sxy += lx*ly;
+		}
+		double denominator = n*sxx - sx*sx;
+		if (denominator <= 0)
+			continue;
+		cout << setw(26) << left << curve[0]->name << setw(10) << curve[0]->source
+		<< setw(8) << curve[0]->param << setw(8) << right << setprecision(2)
+		<< (n*sxy - sx*sy)/denominator << endl;
+	}
+}
+
+/************************************************************************
+ Function:     save_results
+
+ Description:  Save the results as a baseline
+ Inputs:       string &filename, vector<BenchResult> &results
+ Output:       bool - true on success
+ Comments:     One tab separated line per result.
+ ***********************************************************************/
+static bool save_results(const string &filename, const vector<BenchResult> &results)
+{
+	ofstream ofs(filename.c_str());
+	if (!ofs.good()) {
+		LOG(ERROR) << "Unable to open " << filename << " for writing";
+		return false;
+	}
+	ofs << "# name\tsource\tparam\tlength_ms\tns_per_op" << endl;
+	for (unsigned int i = 0; i < results.size(); i++)
+		ofs << result_key(results[i]) << "\t" << fixed << setprecision(1) << results[i].ns_per_op << endl;
+	return ofs.good();
+}
+
+/************************************************************************
+ Function:     compare_results
+
+ Description:  Compare the results against a saved baseline
+ Inputs:       string &filename, vector<BenchResult> &results
+               double tolerance - allowed relative slowdown
+ Output:       int - the number of regressions, or -1 if the baseline
+               cannot be read
+ Comments:     Results missing from the baseline are not compared. The
+               change of each result is taken relative to the median
+               change of all of them, which is printed: the speed of the
+               machine drifts between runs by more than the tolerance.
+ ***********************************************************************/
+static int compare_results(const string &filename, const vector<BenchResult> &results,
+													 double tolerance)
+{
+	ifstream ifs(filename.c_str());
+	if (!ifs.good()) {
+		LOG(ERROR) << "Unable to open " << filename;
+		return -1;
+	}
+	map<string, double> baseline;
+	string line;
+	while (getline(ifs, line)) {
+		if (line.size() == 0 || line[0] == '#')
+			continue;
+		size_t tab = line.rfind('\t');
+		if (tab == string::npos)
+			continue;
+		baseline[line.substr(0, tab)] = strtod(line.c_str() + tab + 1, NULL);
+	}
+
+	vector<double> ratios(results.size(), 0.0);
+	vector<double> compared;
+	for (unsigned int i = 0; i < results.size(); i++) {
+		map<string, double>::iterator it = baseline.find(result_key(results[i]));
+		if (it == baseline.end() || it->second <= 0)
+			continue;
+		ratios[i] = results[i].ns_per_op/it->second;
+		compared.push_back(ratios[i]);
+	}
+	if (compared.size() == 0)
+		return 0;
+	nth_element(compared.begin(), compared.begin() + compared.size()/2, compared.end());
+	double median_ratio = compared[compared.size()/2];
+
+	cout << endl << "comparison with " << filename << " (tolerance "
+	<< setprecision(0) << tolerance*100 << "%, relative to the median change "
+	<< showpos << setprecision(1) << (median_ratio - 1.0)*100 << "%" << noshowpos << ")" << endl;
+	int regressions = 0;
+	for (unsigned int i = 0; i < results.size(); i++) {
+		if (ratios[i] <= 0)
+			continue;
+		double change = ratios[i]/median_ratio - 1.0;
+		bool regression = (change > tolerance);
+		if (regression)
+			regressions++;
+		cout << setw(26) << left << results[i].name << setw(10) << results[i].source
+		<< setw(8) << results[i].param << setw(8) << right << results[i].length_ms
+		<< setw(9) << showpos << setprecision(1) << change*100 << "%" << noshowpos
+		<< (regression ? "  REGRESSION" : "") << endl;
+	}
+	return regressions;
+}
+
+/************************************************************************
+ Function:     main
+
+ Description:  Main entry point
+ Inputs:       int argc, char *argv[] - main input params
+ Output:       int - EXIT_SUCCESS, or EXIT_FAILURE if a benchmark is
+               slower than its baseline
+ Comments:     none.
+ ***********************************************************************/
+int main(int argc, char **argv)
+{
+	// Parse command line
+	string lengths_list;
+	string kernels_list;
+	string wav_filename;
+	string filter;
+	double min_time;
+	int rounds;
+	string output_filename;
+	string baseline_filename;
+	double tolerance;
+	string verbose;
+
+	learning::cmd_line cmdline;
+	cmdline.info("Microbenchmarks of the VOT front end and classifier");
+	cmdline.add("-lengths", "window lengths in msec (comma separated)", &lengths_list, "100,200,500,1000");
+	cmdline.add("-kernels", "kernel expansions (comma separated, empty for linear)", &kernels_list, ",poly2,rbf2");
+	cmdline.add("-wav", "also benchmark windows of this wav file", &wav_filename, "");
+	cmdline.add("-filter", "run only the benchmarks whose name contains this string", &filter, "");
+	cmdline.add("-min_time", "minimal time of each benchmark in each round in seconds", &min_time, 0.1);
+	cmdline.add("-rounds", "runs of the suite, the median time of each benchmark is reported", &rounds, 5);
+	cmdline.add("-output", "save the results to this file", &output_filename, "");
+	cmdline.add("-baseline", "compare the results with those saved in this file", &baseline_filename, "");
+	cmdline.add("-tolerance", "relative slowdown reported as a regression", &tolerance, 0.10);
+	cmdline.add("-verbose", "log reporting level [ERROR, WARNING, INFO, or DEBUG]", &verbose, "WARNING");
+	int rc = cmdline.parse(argc, argv);
+	if (rc < 0) {
+		cmdline.print_help();
+		return EXIT_FAILURE;
+	}
+
+	Log::ReportingLevel() = Log::FromString(verbose);
+	Log::ExecutableName() = basename(argv[0]);
+	Log::Asynchronous() = true;
+
+	vector<int> lengths;
+	vector<string> length_items = split(lengths_list);
+	for (unsigned int i = 0; i < length_items.size(); i++) {
+		int length = atoi(length_items[i].c_str());
+		if (length < 20) {
+			LOG(ERROR) << "Window lengths must be at least 20 msec: " << length_items[i];
+			return EXIT_FAILURE;
+		}
+		lengths.push_back(length);
+	}
+	vector<string> kernels = split(kernels_list);
+	for (unsigned int i = 0; i < kernels.size(); i++)
+		if (kernels[i] == "linear" || kernels[i] == "none")
+			kernels[i] = "";
+
+	vector<string> sources;
+	sources.push_back("synthetic");
+	infra::vector wav;
+	if (wav_filename != "") {
+		double wav_sampling_rate;
+		if (!read_wav_samples(wav_filename, wav, wav_sampling_rate) || wav.size() == 0) {
+			LOG(ERROR) << "Unable to read " << wav_filename;
+			return EXIT_FAILURE;
+		}
+		if (wav_sampling_rate != SAMPLING_RATE) {
+			LOG(ERROR) << wav_filename << " is sampled at " << wav_sampling_rate
+			<< " Hz, expecting " << SAMPLING_RATE << " Hz";
+			return EXIT_FAILURE;
+		}
+		sources.push_back("wav");
+	}
+
+	if (rounds < 1) {
+		LOG(ERROR) << "At least one round is needed: " << rounds;
+		return EXIT_FAILURE;
+	}
+
+	Bench bench(filter, min_time);
+	for (int round = 0; round < rounds; round++) {
+		LOG(INFO) << "Round " << round+1 << " of " << rounds;
+		for (unsigned int s = 0; s < sources.size(); s++) {
+			for (unsigned int i = 0; i < lengths.size(); i++) {
+				double length = lengths[i]/1000.0;
+				double incremental_length = _max(lengths[i], INCREMENTAL_MIN_MS)/1000.0;
+				infra::vector samples = (sources[s] == "wav" ?
+																 tiled_samples(wav, length, SAMPLING_RATE) :
+																 synthetic_samples(length, SAMPLING_RATE));
+				infra::vector incremental_samples = (sources[s] == "wav" ?
+																						 tiled_samples(wav, incremental_length, SAMPLING_RATE) :
+																						 synthetic_samples(incremental_length, SAMPLING_RATE));
+				bench_front_end(bench, sources[s], lengths[i], samples, SAMPLING_RATE);
+				bench_classifier(bench, sources[s], lengths[i], samples, incremental_samples,
+												 SAMPLING_RATE, kernels);
+			}
+		}
+		bench_kernels(bench, kernels);
+	}
+
+	cout << setw(26) << left << "benchmark" << setw(10) << "source" << setw(8) << "param"
+	<< setw(8) << right << "msec" << setw(16) << "ns/op" << setw(16) << "frames/s" << endl;
+	bench.finish();
+
+	print_scaling(bench.results);
+
+	if (output_filename != "") {
+		if (!save_results(output_filename, bench.results))
+			return EXIT_FAILURE;
+		cout << endl << "results saved to " << output_filename << endl;
+	}
+
+	if (baseline_filename != "") {
+		int regressions = compare_results(baseline_filename, bench.results, tolerance);
+		if (regressions < 0)
+			return EXIT_FAILURE;
+		if (regressions > 0) {
+			LOG(ERROR) << regressions << " benchmarks are slower than " << baseline_filename;
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+// ------------------------------- EOF -----------------------------//
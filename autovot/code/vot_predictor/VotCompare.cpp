@@ -0,0 +1,319 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   Main entry point
+ Purpose:  Compare features or predictions with stored references
+ Date:     19 Oct., 2026
+
+ Used by the golden output regression check (make check). A feature
+ value passes if it is within abs + rel*|reference| of the reference,
+ where the tolerances can be set per feature (row of the front end
+ features matrix). A prediction passes if its burst and voice onsets are
+ within a number of frames of the reference.
+
+ **************************** INCLUDE FILES *****************************/
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <cmdline/cmd_line.h>
+#include "Dataset.h"
+#include "FrontEnd.h"
+#include "infra_dsp.h"
+#include "Logger.h"
+
+using namespace std;
+
+// tolerances of one feature
+struct FeatureTolerance
+{
+	double abs;
+	double rel;
+};
+
+/************************************************************************
+ Function:     read_tolerances
+
+ Description:  Read per-feature tolerances
+ Inputs:       string &filename
+               vector<FeatureTolerance> &tolerances - holds the defaults
+               on input
+ Output:       bool - true on success
+ Comments:     Each line is "first_feature last_feature abs rel". Later
+               lines override earlier ones, and # starts a comment.
+ ***********************************************************************/
+static bool read_tolerances(const string &filename, vector<FeatureTolerance> &tolerances)
+{
+	ifstream ifs(filename.c_str());
+	if (!ifs.good()) {
+		LOG(ERROR) << "Unable to open " << filename;
+		return false;
+	}
+	string line;
+	int line_number = 0;
+	while (getline(ifs, line)) {
+		line_number++;
+		size_t comment = line.find('#');
+		if (comment != string::npos)
+			line.erase(comment);
+		istringstream is(line);
+		int first, last;
+		FeatureTolerance tolerance;
+		if (!(is >> first))
+			continue;
+		if (!(is >> last >> tolerance.abs >> tolerance.rel) ||
+				first < 0 || last < first || last >= int(tolerances.size())) {
+			LOG(ERROR) << filename << ":" << line_number << ": expecting \"first_feature last_feature abs rel\""
+			<< " with features between 0 and " << tolerances.size()-1;
+			return false;
+		}
+		for (int i = first; i <= last; i++)
+			tolerances[i] = tolerance;
+	}
+	return true;
+}
+
+/************************************************************************
+ Function:     compare_features
+
+ Description:  Compare feature files with their references
+ Inputs:       StringVector &reference_files, &output_files
+               vector<FeatureTolerance> &tolerances
+ Output:       int - number of values out of tolerance
+ Comments:     The largest difference of every feature is reported.
+ ***********************************************************************/
+static int compare_features(StringVector &reference_files, StringVector &output_files,
+														const vector<FeatureTolerance> &tolerances)
+{
+	int num_features = tolerances.size();
+	vector<double> max_diff(num_features, 0.0);
+	vector<int> failures(num_features, 0);
+	int total_failures = 0;
+	unsigned long num_values = 0;
+
+	for (unsigned int i = 0; i < reference_files.size(); i++) {
+		SpeechUtterance reference, output;
+		reference.read(reference_files[i]);
+		output.read(output_files[i]);
+		if (reference.size() != output.size() || reference.dim() != output.dim()) {
+			LOG(ERROR) << output_files[i] << " has " << output.size() << "x" << output.dim()
+			<< " features, the reference " << reference_files[i] << " has "
+			<< reference.size() << "x" << reference.dim();
+			total_failures++;
+			continue;
+		}
+		if (int(reference.dim()) != num_features) {
+			LOG(ERROR) << reference_files[i] << " has " << reference.dim() << " features, expecting "
+			<< num_features;
+			total_failures++;
+			continue;
+		}
+		for (unsigned long t = 0; t < reference.size(); t++) {
+			for (int k = 0; k < num_features; k++) {
+				double r = reference.scores(t,k);
+				double diff = fabs(output.scores(t,k) - r);
+				if (!(diff == diff)) diff = HUGE_VAL;
+				if (diff > max_diff[k])
+					max_diff[k] = diff;
+				if (diff > tolerances[k].abs + tolerances[k].rel*fabs(r)) {
+					if (failures[k] == 0) {
+						LOG(ERROR) << output_files[i] << ": feature " << k << " of frame " << t << " is "
+						<< output.scores(t,k) << ", the reference is " << r;
+					}
+					failures[k]++;
+					total_failures++;
+				}
+			}
+		}
+		num_values += reference.size()*reference.dim();
+	}
+
+	cout << "feature   max abs diff      abs tol      rel tol   failures" << endl;
+	for (int k = 0; k < num_features; k++) {
+		cout << setw(7) << k << setw(15) << scientific << setprecision(3) << max_diff[k]
+		<< setw(13) << tolerances[k].abs << setw(13) << tolerances[k].rel
+		<< setw(11) << failures[k] << (failures[k] > 0 ? "  FAIL" : "") << endl;
+	}
+	cout << reference_files.size() << " files, " << num_values << " values, "
+	<< total_failures << " out of tolerance" << endl;
+	return total_failures;
+}
+
+/************************************************************************
+ Function:     read_predictions
+
+ Description:  Read a predictions file of VotDecode
+ Inputs:       string &filename, vector< vector<double> > &lines
+ Output:       bool - true on success
+ Comments:     Each line has "confidence burst voice" for each model.
+ ***********************************************************************/
+static bool read_predictions(const string &filename, vector< vector<double> > &lines)
+{
+	ifstream ifs(filename.c_str());
+	if (!ifs.good()) {
+		LOG(ERROR) << "Unable to open " << filename;
+		return false;
+	}
+	string line;
+	while (getline(ifs, line)) {
+		istringstream is(line);
+		vector<double> values;
+		double value;
+		while (is >> value)
+			values.push_back(value);
+		if (values.size() > 0)
+			lines.push_back(values);
+	}
+	return true;
+}
+
+/************************************************************************
+ Function:     compare_predictions
+
+ Description:  Compare a predictions file with its reference
+ Inputs:       string &reference_file, &output_file
+               int frame_tolerance - allowed difference of the onsets
+ Output:       int - number of predictions out of tolerance
+ Comments:     The confidence is reported but not checked.
+ ***********************************************************************/
+static int compare_predictions(const string &reference_file, const string &output_file,
+															 int frame_tolerance)
+{
+	vector< vector<double> > reference, output;
+	if (!read_predictions(reference_file, reference) || !read_predictions(output_file, output))
+		return 1;
+	if (reference.size() != output.size()) {
+		LOG(ERROR) << output_file << " has " << output.size() << " predictions, the reference "
+		<< reference_file << " has " << reference.size();
+		return 1;
+	}
+
+	int failures = 0;
+	int exact = 0;
+	int max_frame_diff = 0;
+	double max_confidence_diff = 0.0;
+	for (unsigned int i = 0; i < reference.size(); i++) {
+		if (reference[i].size() != output[i].size() || reference[i].size() % 3 != 0) {
+			LOG(ERROR) << output_file << ":" << i+1 << ": expecting " << reference[i].size() << " values";
+			failures++;
+			continue;
+		}
+		int frame_diff = 0;
+		for (unsigned int m = 0; m < reference[i].size(); m += 3) {
+			double confidence_diff = fabs(output[i][m] - reference[i][m]);
+			if (confidence_diff > max_confidence_diff)
+				max_confidence_diff = confidence_diff;
+			frame_diff = _max(frame_diff, int(fabs(output[i][m+1] - reference[i][m+1])));
+			frame_diff = _max(frame_diff, int(fabs(output[i][m+2] - reference[i][m+2])));
+		}
+		if (frame_diff == 0)
+			exact++;
+		if (frame_diff > max_frame_diff)
+			max_frame_diff = frame_diff;
+		if (frame_diff > frame_tolerance) {
+			LOG(ERROR) << output_file << ":" << i+1 << ": predicted";
+			for (unsigned int m = 0; m < reference[i].size(); m += 3)
+				LOG(ERROR) << "  burst " << output[i][m+1] << " voice " << output[i][m+2]
+				<< ", the reference is burst " << reference[i][m+1] << " voice " << reference[i][m+2];
+			failures++;
+		}
+	}
+
+	cout << reference.size() << " predictions, " << exact << " exact, max onset difference "
+	<< max_frame_diff << " frames (tolerance " << frame_tolerance << "), max confidence difference "
+	<< scientific << setprecision(3) << max_confidence_diff << ", " << failures
+	<< " out of tolerance" << endl;
+	return failures;
+}
+
+/************************************************************************
+ Function:     main
+
+ Description:  Main entry point
+ Inputs:       int argc, char *argv[] - main input params
+ Output:       int - EXIT_SUCCESS if everything is within tolerance,
+               otherwise EXIT_FAILURE
+ Comments:     none.
+ ***********************************************************************/
+int main(int argc, char **argv)
+{
+	// Parse command line
+	bool predictions;
+	string tolerances_filename;
+	double abs_tolerance;
+	double rel_tolerance;
+	int frame_tolerance;
+	string reference;
+	string output;
+	string verbose;
+
+	learning::cmd_line cmdline;
+	cmdline.info("Compare features or predictions with stored references");
+	cmdline.add("-predictions", "compare predictions files of VotDecode instead of feature file lists", &predictions, false);
+	cmdline.add("-tolerances", "per-feature tolerances (lines of \"first last abs rel\")", &tolerances_filename, "");
+	cmdline.add("-abs_tolerance", "default absolute tolerance of a feature value", &abs_tolerance, 1e-4);
+	cmdline.add("-rel_tolerance", "default relative tolerance of a feature value", &rel_tolerance, 1e-4);
+	cmdline.add("-frame_tolerance", "allowed difference of the predicted onsets in frames", &frame_tolerance, 0);
+	cmdline.add("-verbose", "log reporting level [ERROR, WARNING, INFO, or DEBUG]", &verbose, "INFO");
+	cmdline.add_master_option("reference (features filelist, or predictions with -predictions)", &reference);
+	cmdline.add_master_option("output (features filelist, or predictions with -predictions)", &output);
+	int rc = cmdline.parse(argc, argv);
+	if (rc < 2) {
+		cmdline.print_help();
+		return EXIT_FAILURE;
+	}
+
+	Log::ReportingLevel() = Log::FromString(verbose);
+	Log::ExecutableName() = basename(argv[0]);
+	Log::Asynchronous() = true;
+
+	int failures;
+	if (predictions) {
+		failures = compare_predictions(reference, output, frame_tolerance);
+	}
+	else {
+		FeatureTolerance tolerance;
+		tolerance.abs = abs_tolerance;
+		tolerance.rel = rel_tolerance;
+		vector<FeatureTolerance> tolerances(NUM_FEATURES, tolerance);
+		if (tolerances_filename != "" && !read_tolerances(tolerances_filename, tolerances))
+			return EXIT_FAILURE;
+
+		StringVector reference_files, output_files;
+		reference_files.read(reference);
+		output_files.read(output);
+		if (reference_files.size() != output_files.size()) {
+			LOG(ERROR) << "The file lists " << reference << " and " << output << " have different lengths";
+			return EXIT_FAILURE;
+		}
+		failures = compare_features(reference_files, output_files, tolerances);
+	}
+
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+// ------------------------------- EOF -----------------------------//
@@ -31,14 +31,172 @@ License along with Autovot.  If not, see
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <sstream>
+#include <vector>
 #include <cmdline/cmd_line.h>
 #include "Classifier.h"
 #include "Dataset.h"
+#include "Profiler.h"
 #include "Logger.h"
 
 using namespace std;
 
 static int loss_resolutions[] = {2,5,10,15,20,25,50};
+#define NUM_LOSS_RESOLUTIONS (sizeof(loss_resolutions)/sizeof(int))
+
+// Error statistics of the predictions of one model
+struct DecodeStats
+{
+	DecodeStats();
+	void add(const VotLocation &y, const VotLocation &y_hat, double confidence);
+	void report(LogLevel level);
+	
+	int num_boundaries;
+	int num_vots;
+	int num_pos;
+	int num_neg;
+	int neg_mislabeled_pos;
+	int pos_mislabeled_neg;
+	int cumulative_loss;
+	int cum_loss_less_than[NUM_LOSS_RESOLUTIONS];
+	int cumulative_vot_loss;
+	int cum_vot_loss_less_than[NUM_LOSS_RESOLUTIONS];
+	int cumulative_corr_loss;
+	int cum_corr_loss_less_than[NUM_LOSS_RESOLUTIONS];
+	double rms_onset_loss;
+};
+
+/************************************************************************
+ Function:     DecodeStats::DecodeStats
+ 
+ Description:  Constructor
+ Inputs:       none.
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+DecodeStats::DecodeStats() :
+num_boundaries(0),
+num_vots(0),
+num_pos(0),
+num_neg(0),
+neg_mislabeled_pos(0),
+pos_mislabeled_neg(0),
+cumulative_loss(0),
+cumulative_vot_loss(0),
+cumulative_corr_loss(0),
+rms_onset_loss(0)
+{
+	for (uint j=0; j < NUM_LOSS_RESOLUTIONS; j++) {
+		cum_loss_less_than[j] = 0;
+		cum_vot_loss_less_than[j] = 0;
+		cum_corr_loss_less_than[j] = 0;
+	}
+}
+
+/************************************************************************
+ Function:     DecodeStats::add
+ 
+ Description:  Add the error of one prediction
+ Inputs:       VotLocation &y - the label
+               VotLocation &y_hat - the prediction
+               double confidence
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+void DecodeStats::add(const VotLocation &y, const VotLocation &y_hat, double confidence)
+{
+	int onset_loss = abs(y.burst - y_hat.burst);
+	for (uint j=0; j < NUM_LOSS_RESOLUTIONS; j++)
+		if ( onset_loss <= loss_resolutions[j] ) cum_loss_less_than[j]++;
+	
+	
+	rms_onset_loss += onset_loss*onset_loss;
+	
+	int offset_loss = abs(y.voice - y_hat.voice);
+	for (uint j=0; j < NUM_LOSS_RESOLUTIONS; j++)
+		if ( offset_loss <= loss_resolutions[j] ) cum_loss_less_than[j]++;
+	
+	LOG(DEBUG) << "burst onset err: " << y_hat.burst - y.burst;
+	LOG(DEBUG) << "voice onset err: " << y_hat.voice - y.voice;
+	
+	int vot_loss = abs(y.voice-y.burst-(y_hat.voice-y_hat.burst));
+	for (uint j=0; j < NUM_LOSS_RESOLUTIONS; j++)
+		if ( vot_loss <= loss_resolutions[j] ) cum_vot_loss_less_than[j]++;
+	
+	cumulative_loss += onset_loss + offset_loss;
+	num_boundaries += 2;
+	
+	cumulative_vot_loss += vot_loss;
+	num_vots += 1;
+	
+	if(y.burst < y.voice) { //positive VOT example
+		num_pos++;
+		if(y_hat.burst < y_hat.voice) { //correctly predicited pos
+			for (uint j=0; j < NUM_LOSS_RESOLUTIONS; j++)
+				if ( vot_loss <= loss_resolutions[j] ) cum_corr_loss_less_than[j]++;
+			cumulative_corr_loss += vot_loss;
+		} else { //incorrectly predicted neg
+			pos_mislabeled_neg++;
+		}
+	} else { //negative VOT example
+		num_neg++;
+		if(y_hat.burst > y_hat.voice) { //correctly predicted neg
+			for (uint j=0; j < NUM_LOSS_RESOLUTIONS; j++)
+				if ( vot_loss <= loss_resolutions[j] ) cum_corr_loss_less_than[j]++;
+			cumulative_corr_loss += vot_loss;
+		} else { //incorrectly predicted pos
+			neg_mislabeled_pos++;
+		}
+	}
+	
+	// labeled and predicted VOT
+	LOG(DEBUG) << "Labeled VOT: " << y.burst << " " << y.voice;
+	LOG(DEBUG) << "Predicted VOT: " << y_hat.burst << " " << y_hat.voice << " conf: " << confidence;
+	
+	// boundaries t<= table
+	LOG(DEBUG) << "Cum loss = " << cumulative_loss/double(num_boundaries);
+	for (uint j=0; j < NUM_LOSS_RESOLUTIONS; j++) {
+		LOG(DEBUG) << "% Boundaries (t <= " << loss_resolutions[j] << "ms) = "
+		<< 100.0*cum_loss_less_than[j]/double(num_boundaries) ;
+	}
+
+	// VOT t<= table
+	LOG(DEBUG) << "Cum VOT loss = " << cumulative_vot_loss/double(num_vots);
+	for (uint j=0; j < NUM_LOSS_RESOLUTIONS; j++) {
+		LOG(DEBUG) << "% VOT error (t <= " << loss_resolutions[j] << "ms) = "
+		<< 100.0*cum_vot_loss_less_than[j]/double(num_vots);
+	}
+}
+
+/************************************************************************
+ Function:     DecodeStats::report
+ 
+ Description:  Log the final results
+ Inputs:       LogLevel level - INFO for -final_results, DEBUG otherwise
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+void DecodeStats::report(LogLevel level)
+{
+	// percent misclassified
+	int num_misclassified = neg_mislabeled_pos + pos_mislabeled_neg;
+	int num_corr = num_vots - num_misclassified;
+	LOG(level) << "Total num misclassified = " << double(num_misclassified)/double(num_vots);
+	LOG(level) << "Num pos misclassified as neg = " << double(pos_mislabeled_neg)/double(num_pos);
+	LOG(level) << "Num neg misclassified as pos = " << double(neg_mislabeled_pos)/double(num_neg);
+	
+	// VOT t<= table for correctly classified data only
+	LOG(level) << "Cumulative VOT loss on correctly classified data = " << cumulative_corr_loss/double(num_corr);
+	for (uint j=0; j < NUM_LOSS_RESOLUTIONS; j++) {
+		LOG(level) << "% corr VOT error (t <= " << loss_resolutions[j] << "ms) = "
+		<< 100.0*cum_corr_loss_less_than[j]/double(num_corr);
+	}
+	
+	rms_onset_loss /= double(num_vots);
+	rms_onset_loss = sqrt(num_vots);
+	
+	LOG(level) << "RMS onset loss: " << rms_onset_loss;
+}
 
 /************************************************************************
  Function:     main
@@ -46,7 +204,8 @@ static int loss_resolutions[] = {2,5,10,15,20,25,50};
  Description:  Main entry point
  Inputs:       int argc, char *argv[] - main input params
  Output:       int - EXIT_SUCCESS or EXIT_FAILURE
- Comments:     none.
+ Comments:     Several comma separated classifiers are decoded together,
+               with one prediction column per classifier in the output.
  ***********************************************************************/
 int main(int argc, char **argv)
 {
@@ -56,12 +215,13 @@ int main(int argc, char **argv)
 	int max_onset_time;
 	string instances_filelist;
 	string labels_filename;
-	string classifier_filename;
+	string classifier_filenames;
 	string output_predictions_filename;
 	string ignore_features_str;
 	bool pos_only;
 	string kernel_expansion_name;
 	double sigma;
+	string profile_filename;
 	string verbose;
 	bool print_final_results;
 	
@@ -76,11 +236,12 @@ int main(int argc, char **argv)
 	cmdline.add("-pos_only", "Assume only positive VOTs", &pos_only, false);
   cmdline.add("-kernel_expansion", "use kernel expansion of type 'poly2' or 'rbf2'", &kernel_expansion_name, "");
   cmdline.add("-sigma", "if kernel is rbf2 or rbf3 this is the sigma", &sigma, 1.0);
+	cmdline.add("-profile", "write the time spent in each stage as JSON to the given file (- for stderr)", &profile_filename, "");
 	cmdline.add("-verbose", "log reporting level [ERROR, WARNING, INFO, or DEBUG]", &verbose, "INFO");
 	cmdline.add("-final_results", "print final results in INFO logging", &print_final_results, false);
 	cmdline.add_master_option("instances_filelist", &instances_filelist);
 	cmdline.add_master_option("labels_filename[can be `null` for no labels]", &labels_filename);
-	cmdline.add_master_option("classifier_filename", &classifier_filename);
+	cmdline.add_master_option("classifier_filenames (comma separated)", &classifier_filenames);
 	int rc = cmdline.parse(argc, argv);
 	if (rc < 3) {
 		cmdline.print_help();
@@ -89,41 +250,61 @@ int main(int argc, char **argv)
 	
 	Log::ReportingLevel() = Log::FromString(verbose);
 	Log::ExecutableName() = basename(argv[0]);
+	Log::Asynchronous() = true;
+	if (profile_filename != "")
+		Profiler::enable(basename(argv[0]), profile_filename);
 
-	// Initiate classifier
-	Classifier classifier(min_vot_length, max_vot_length, max_onset_time, 0.0, 0.0, 0.0, 0.0, kernel_expansion_name, sigma);
-	classifier.load(classifier_filename);
-	if (ignore_features_str != "") {
-		LOG(INFO) << "Ignoring features " << ignore_features_str << ".";
-		classifier.ignore_features(ignore_features_str);
+	// Initiate classifiers
+	vector<Classifier*> classifiers;
+	vector<string> model_names;
+	vector<bool> model_pos_only;
+	istringstream filenames(classifier_filenames);
+	string classifier_filename;
+	while (getline(filenames, classifier_filename, ',')) {
+		if (classifier_filename == "")
+			continue;
+		ModelInfo info;
+		info.min_vot_length = min_vot_length;
+		info.max_vot_length = max_vot_length;
+		info.max_onset = max_onset_time;
+		info.ignore_features = ignore_features_str;
+		info.pos_only = pos_only;
+		info.kernel_expansion = kernel_expansion_name;
+		info.sigma = sigma;
+		// a binary model carries the options it was trained with, which are
+		// the defaults of the options not given on the command line
+		if (is_model_file(classifier_filename)) {
+			ModelInfo stored;
+			if (!read_model_file(classifier_filename, stored))
+				return EXIT_FAILURE;
+			if (!cmdline.given("-min_vot_length")) info.min_vot_length = stored.min_vot_length;
+			if (!cmdline.given("-max_vot_length")) info.max_vot_length = stored.max_vot_length;
+			if (!cmdline.given("-max_onset")) info.max_onset = stored.max_onset;
+			if (!cmdline.given("-ignore_features")) info.ignore_features = stored.ignore_features;
+			if (!cmdline.given("-pos_only")) info.pos_only = stored.pos_only;
+			if (!cmdline.given("-kernel_expansion")) info.kernel_expansion = stored.kernel_expansion;
+			if (!cmdline.given("-sigma")) info.sigma = stored.sigma;
+		}
+		Classifier *classifier = new Classifier(info.min_vot_length, info.max_vot_length, info.max_onset,
+																						0.0, 0.0, 0.0, 0.0, info.kernel_expansion, info.sigma);
+		classifier->load(classifier_filename);
+		if (info.ignore_features != "") {
+			LOG(INFO) << "Ignoring features " << info.ignore_features << ".";
+			classifier->ignore_features(info.ignore_features);
+		}
+		classifiers.push_back(classifier);
+		model_names.push_back(classifier_filename);
+		model_pos_only.push_back(info.pos_only);
+	}
+	if (classifiers.size() == 0) {
+		LOG(ERROR) << "No classifier was given.";
+		return EXIT_FAILURE;
 	}
 	
 	// begining of the training set
 	Dataset test_dataset(instances_filelist, labels_filename);
 	
-	int num_boundaries = 0;
-	int num_vots = 0;
-	int num_pos = 0;
-	int num_neg = 0;
-	int neg_mislabeled_pos = 0;
-	int pos_mislabeled_neg = 0;
-	
-	int cumulative_loss = 0;
-	int *cum_loss_less_than = new int[sizeof(loss_resolutions)/sizeof(int)];
-	
-	int *cum_vot_loss_less_than = new int[sizeof(loss_resolutions)/sizeof(int)];
-	int cumulative_vot_loss = 0;
-	
-	int *cum_corr_loss_less_than = new int[sizeof(loss_resolutions)/sizeof(int)];
-	int cumulative_corr_loss = 0;
-	
-	for (uint j=0; j < sizeof(loss_resolutions)/sizeof(int); j++) {
-		cum_loss_less_than[j] = 0;
-		cum_vot_loss_less_than[j] = 0;
-		cum_corr_loss_less_than[j] = 0;
-	}
-	
-	double rms_onset_loss = 0;
+	vector<DecodeStats> stats(classifiers.size());
 	
 	ofstream output_predictions_ofs;
 	if (output_predictions_filename != "") {
@@ -138,128 +319,48 @@ int main(int argc, char **argv)
 		
 		SpeechUtterance x;
 		VotLocation y;
-		VotLocation y_hat;
+		vector<VotLocation> y_hat;
+		vector<double> confidence;
 		
 		LOG(DEBUG) << "===========================================================";
 		
 		// read next example for dataset
 		test_dataset.read(x, y);
 		
-		// predict label
-		double confidence = classifier.predict(x, y_hat, pos_only);
+		// predict label, with all models at once
+		Classifier::predict_models(classifiers, model_pos_only, x, y_hat, confidence);
 		
-		if (output_predictions_filename != "" && output_predictions_ofs.good())
-			output_predictions_ofs << confidence << " " << y_hat.burst << " " << y_hat.voice << std::endl;
+		if (output_predictions_filename != "" && output_predictions_ofs.good()) {
+			for (uint m=0; m < classifiers.size(); m++) {
+				if (m > 0) output_predictions_ofs << " ";
+				output_predictions_ofs << confidence[m] << " " << y_hat[m].burst << " " << y_hat[m].voice;
+			}
+			output_predictions_ofs << std::endl;
+		}
 		
 		// calculate the error
 		if (test_dataset.labels_given()) {
-			int onset_loss = abs(y.burst - y_hat.burst);
-			for (uint j=0; j < sizeof(loss_resolutions)/sizeof(int); j++)
-				if ( onset_loss <= loss_resolutions[j] ) cum_loss_less_than[j]++;
-			
-			
-			rms_onset_loss += onset_loss*onset_loss;
-			
-			int offset_loss = abs(y.voice - y_hat.voice);
-			for (uint j=0; j < sizeof(loss_resolutions)/sizeof(int); j++)
-				if ( offset_loss <= loss_resolutions[j] ) cum_loss_less_than[j]++;
-			
-			LOG(DEBUG) << "burst onset err: " << y_hat.burst - y.burst;
-			LOG(DEBUG) << "voice onset err: " << y_hat.voice - y.voice;
-			
-			int vot_loss = abs(y.voice-y.burst-(y_hat.voice-y_hat.burst));
-			for (uint j=0; j < sizeof(loss_resolutions)/sizeof(int); j++)
-				if ( vot_loss <= loss_resolutions[j] ) cum_vot_loss_less_than[j]++;
-			
-			cumulative_loss += onset_loss + offset_loss;
-			num_boundaries += 2;
-			
-			cumulative_vot_loss += vot_loss;
-			num_vots += 1;
-			
-			if(y.burst < y.voice) { //positive VOT example
-				num_pos++;
-				if(y_hat.burst < y_hat.voice) { //correctly predicited pos
-					for (uint j=0; j < sizeof(loss_resolutions)/sizeof(int); j++)
-						if ( vot_loss <= loss_resolutions[j] ) cum_corr_loss_less_than[j]++;
-					cumulative_corr_loss += vot_loss;
-				} else { //incorrectly predicted neg
-					pos_mislabeled_neg++;
-				}
-			} else { //negative VOT example
-				num_neg++;
-				if(y_hat.burst > y_hat.voice) { //correctly predicted neg
-					for (uint j=0; j < sizeof(loss_resolutions)/sizeof(int); j++)
-						if ( vot_loss <= loss_resolutions[j] ) cum_corr_loss_less_than[j]++;
-					cumulative_corr_loss += vot_loss;
-				} else { //incorrectly predicted pos
-					neg_mislabeled_pos++;
+			for (uint m=0; m < classifiers.size(); m++) {
+				if (classifiers.size() > 1) {
+					LOG(DEBUG) << "Model " << model_names[m];
 				}
+				stats[m].add(y, y_hat[m], confidence[m]);
 			}
-			
-			// labeled and predicted VOT
-			LOG(DEBUG) << "Labeled VOT: " << y.burst << " " << y.voice;
-			LOG(DEBUG) << "Predicted VOT: " << y_hat.burst << " " << y_hat.voice << " conf: " << confidence;
-			
-			// boundaries t<= table
-			LOG(DEBUG) << "Cum loss = " << cumulative_loss/double(num_boundaries);
-			for (uint j=0; j < sizeof(loss_resolutions)/sizeof(int); j++) {
-				LOG(DEBUG) << "% Boundaries (t <= " << loss_resolutions[j] << "ms) = "
-				<< 100.0*cum_loss_less_than[j]/double(num_boundaries) ;
-			}
-
-			// VOT t<= table
-			LOG(DEBUG) << "Cum VOT loss = " << cumulative_vot_loss/double(num_vots);
-			for (uint j=0; j < sizeof(loss_resolutions)/sizeof(int); j++) {
-				LOG(DEBUG) << "% VOT error (t <= " << loss_resolutions[j] << "ms) = "
-				<< 100.0*cum_vot_loss_less_than[j]/double(num_vots);
-			}
-
 		}
 	}
 	
-	// percent misclassified
-	int num_misclassified = neg_mislabeled_pos + pos_mislabeled_neg;
-	int num_corr = num_vots - num_misclassified;
-	if (print_final_results) {
-		LOG(INFO) << "Total num misclassified = " << double(num_misclassified)/double(num_vots);
-		LOG(INFO) << "Num pos misclassified as neg = " << double(pos_mislabeled_neg)/double(num_pos);
-		LOG(INFO) << "Num neg misclassified as pos = " << double(neg_mislabeled_pos)/double(num_neg);
-		
-		// VOT t<= table for correctly classified data only
-		LOG(INFO) << "Cumulative VOT loss on correctly classified data = " << cumulative_corr_loss/double(num_corr);
-		for (int j=0; j < sizeof(loss_resolutions)/sizeof(int); j++) {
-			LOG(INFO) << "% corr VOT error (t <= " << loss_resolutions[j] << "ms) = "
-			<< 100.0*cum_corr_loss_less_than[j]/double(num_corr);
-		}
-		
-		rms_onset_loss /= double(num_vots);
-		rms_onset_loss = sqrt(num_vots);
-		
-		LOG(INFO) << "RMS onset loss: " << rms_onset_loss;
-	}
-	else {
-		LOG(DEBUG) << "Total num misclassified = " << double(num_misclassified)/double(num_vots);
-		LOG(DEBUG) << "Num pos misclassified as neg = " << double(pos_mislabeled_neg)/double(num_pos);
-		LOG(DEBUG) << "Num neg misclassified as pos = " << double(neg_mislabeled_pos)/double(num_neg);
-		
-		// VOT t<= table for correctly classified data only
-		LOG(DEBUG) << "Cumulative VOT loss on correctly classified data = " << cumulative_corr_loss/double(num_corr);
-		for (int j=0; j < sizeof(loss_resolutions)/sizeof(int); j++) {
-			LOG(DEBUG) << "% corr VOT error (t <= " << loss_resolutions[j] << "ms) = "
-			<< 100.0*cum_corr_loss_less_than[j]/double(num_corr);
+	for (uint m=0; m < classifiers.size(); m++) {
+		LogLevel level = print_final_results ? INFO : DEBUG;
+		if (classifiers.size() > 1) {
+			LOG(level) << "Results of " << model_names[m];
 		}
-		
-		rms_onset_loss /= double(num_vots);
-		rms_onset_loss = sqrt(num_vots);
-		
-		LOG(DEBUG) << "RMS onset loss: " << rms_onset_loss;
-
+		stats[m].report(level);
 	}
 	if (output_predictions_filename != "" && output_predictions_ofs.good())
 		output_predictions_ofs.close();
 	
-	delete [] cum_loss_less_than ;
+	for (uint m=0; m < classifiers.size(); m++)
+		delete classifiers[m];
 	LOG(INFO) << "Decoding completed.";
 	
 	return EXIT_SUCCESS;
@@ -0,0 +1,285 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   Main entry point
+ Purpose:  Detect the VOTs of a long, unsegmented recording
+ Date:     19 Oct., 2026
+
+ The wav file is read in pieces and passed to a StopDetector, so the
+ memory does not grow with the recording. Each detected VOT is written
+ as a line "start<TAB>end<TAB>mark" (seconds), where the mark is the
+ confidence, preceded by "neg " for a negative VOT as in
+ auto_vot_decode.py. The detections can also be written as a Praat
+ TextGrid with an "AutoVOT" tier.
+
+ **************************** INCLUDE FILES *****************************/
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cmdline/cmd_line.h>
+#include "Classifier.h"
+#include "StopDetector.h"
+#include "ModelFile.h"
+#include "FrontEnd.h"
+#include "WavFile.h"
+#include "infra_dsp.h"
+#include "Profiler.h"
+#include "Logger.h"
+
+using namespace std;
+
+// samples read from the wav file at once
+#define READ_SAMPLES 16000
+
+/************************************************************************
+ Function:     write_detections
+
+ Description:  Write the detections as lines of start, end and mark
+ Inputs:       ostream &os, vector<VotDetection> &detections
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+static void write_detections(ostream &os, const vector<VotDetection> &detections)
+{
+	for (unsigned int i = 0; i < detections.size(); i++) {
+		os << fixed << setprecision(3) << detections[i].start << "\t" << detections[i].end << "\t"
+		<< (detections[i].negative ? "neg " : "") << setprecision(6) << detections[i].confidence << endl;
+	}
+}
+
+/************************************************************************
+ Function:     write_textgrid
+
+ Description:  Write the detections as a Praat TextGrid
+ Inputs:       string &filename, vector<VotDetection> &detections
+               double duration - of the recording in seconds
+ Output:       bool - true on success
+ Comments:     An "AutoVOT" interval tier, with the VOTs marked "pred"
+               as auto_vot_decode.py does.
+ ***********************************************************************/
+static bool write_textgrid(const string &filename, const vector<VotDetection> &detections,
+													 double duration)
+{
+	ofstream ofs(filename.c_str());
+	if (!ofs.good()) {
+		LOG(ERROR) << "Unable to open " << filename;
+		return false;
+	}
+
+	// the intervals between the detections are empty
+	vector<double> xmin, xmax;
+	vector<string> marks;
+	double last = 0.0;
+	for (unsigned int i = 0; i < detections.size(); i++) {
+		if (detections[i].start > last) {
+			xmin.push_back(last);
+			xmax.push_back(detections[i].start);
+			marks.push_back("");
+		}
+		xmin.push_back(detections[i].start);
+		xmax.push_back(detections[i].end);
+		marks.push_back("pred");
+		last = detections[i].end;
+	}
+	if (duration > last || xmin.size() == 0) {
+		xmin.push_back(last);
+		xmax.push_back(_max(duration, last));
+		marks.push_back("");
+	}
+
+	ofs << setprecision(12);
+	ofs << "File type = \"ooTextFile\"\nObject class = \"TextGrid\"\n\n";
+	ofs << "xmin = 0\nxmax = " << xmax.back() << "\ntiers? <exists>\nsize = 1\nitem []:\n";
+	ofs << "    item [1]:\n        class = \"IntervalTier\"\n        name = \"AutoVOT\"\n";
+	ofs << "        xmin = 0\n        xmax = " << xmax.back() << "\n";
+	ofs << "        intervals: size = " << xmin.size() << "\n";
+	for (unsigned int i = 0; i < xmin.size(); i++) {
+		ofs << "        intervals [" << i+1 << "]:\n";
+		ofs << "            xmin = " << xmin[i] << "\n";
+		ofs << "            xmax = " << xmax[i] << "\n";
+		ofs << "            text = \"" << marks[i] << "\"\n";
+	}
+	return ofs.good();
+}
+
+/************************************************************************
+ Function:     main
+
+ Description:  Main entry point
+ Inputs:       int argc, char *argv[] - main input params
+ Output:       int - EXIT_SUCCESS or EXIT_FAILURE
+ Comments:     none.
+ ***********************************************************************/
+int main(int argc, char **argv)
+{
+	// Parse command line
+	int min_vot_length;
+	int max_vot_length;
+	int max_onset_time;
+	string wav_filename;
+	string classifier_filename;
+	string output_filename;
+	string textgrid_filename;
+	string ignore_features_str;
+	string voicing_tracker_str;
+	bool pos_only;
+	bool full_precision;
+	string kernel_expansion_name;
+	double sigma;
+	StopDetectorOptions options;
+	string profile_filename;
+	string verbose;
+
+	learning::cmd_line cmdline;
+	cmdline.info("Initial VOT detection - long recordings");
+	cmdline.add("-output", "write the detections to this file instead of the standard output", &output_filename, "");
+	cmdline.add("-textgrid", "write the detections as a TextGrid with an AutoVOT tier", &textgrid_filename, "");
+	cmdline.add("-min_vot_length", "min. phoneme duration in msec [15]", &min_vot_length, 15);
+	cmdline.add("-max_vot_length", "max. phoneme duration in msec [250]", &max_vot_length, 250);
+	cmdline.add("-max_onset", "max. onset of the burst in the window in msec [200]", &max_onset_time, 200);
+	cmdline.add("-ignore_features", "ignore the following features. E.g., \"3,7,19\".", &ignore_features_str, "");
+	cmdline.add("-voicing_tracker", "voicing tracker of the features: 'rapt' or 'yin' [rapt]", &voicing_tracker_str, "rapt");
+	cmdline.add("-pos_only", "Assume only positive VOTs", &pos_only, false);
+	cmdline.add("-kernel_expansion", "use kernel expansion of type 'poly2' or 'rbf2'", &kernel_expansion_name, "");
+	cmdline.add("-sigma", "if kernel is rbf2 or rbf3 this is the sigma", &sigma, 1.0);
+	cmdline.add("-block_size", "seconds of audio processed at once [10]", &options.block_size, 10.0);
+	cmdline.add("-window_before", "window start before a proposed burst in sec [0.05]", &options.window_before, 0.05);
+	cmdline.add("-window_after", "window end after a proposed burst in sec [0.4]", &options.window_after, 0.4);
+	cmdline.add("-burst_rise", "rise of the energy above 3 kHz that proposes a burst in dB [18]", &options.burst_rise, 18.0);
+	cmdline.add("-min_gap", "min. distance of two proposed bursts in sec [0.1]", &options.min_gap, 0.1);
+	cmdline.add("-min_confidence", "drop the detections of lower confidence", &options.min_confidence, -HUGE_VAL);
+	cmdline.add("-full_precision", "decode the features as computed instead of rounding them "
+							"as in a features file", &full_precision, false);
+	cmdline.add("-profile", "write the time spent in each stage as JSON to the given file (- for stderr)", &profile_filename, "");
+	cmdline.add("-verbose", "log reporting level [ERROR, WARNING, INFO, or DEBUG]", &verbose, "INFO");
+	cmdline.add_master_option("wav_filename", &wav_filename);
+	cmdline.add_master_option("classifier_filename", &classifier_filename);
+	int rc = cmdline.parse(argc, argv);
+	if (rc < 3) {
+		cmdline.print_help();
+		return EXIT_FAILURE;
+	}
+
+	Log::ReportingLevel() = Log::FromString(verbose);
+	Log::ExecutableName() = basename(argv[0]);
+	Log::Asynchronous() = true;
+	if (profile_filename != "")
+		Profiler::enable(basename(argv[0]), profile_filename);
+
+	// a binary model brings its own defaults, as in VotDecode
+	ModelInfo info;
+	info.min_vot_length = min_vot_length;
+	info.max_vot_length = max_vot_length;
+	info.max_onset = max_onset_time;
+	info.ignore_features = ignore_features_str;
+	info.voicing_tracker = voicing_tracker_str;
+	info.pos_only = pos_only;
+	info.kernel_expansion = kernel_expansion_name;
+	info.sigma = sigma;
+	if (is_model_file(classifier_filename)) {
+		ModelInfo stored;
+		if (!read_model_file(classifier_filename, stored))
+			return EXIT_FAILURE;
+		if (!cmdline.given("-min_vot_length")) info.min_vot_length = stored.min_vot_length;
+		if (!cmdline.given("-max_vot_length")) info.max_vot_length = stored.max_vot_length;
+		if (!cmdline.given("-max_onset")) info.max_onset = stored.max_onset;
+		if (!cmdline.given("-ignore_features")) info.ignore_features = stored.ignore_features;
+		if (!cmdline.given("-voicing_tracker")) info.voicing_tracker = stored.voicing_tracker;
+		if (!cmdline.given("-pos_only")) info.pos_only = stored.pos_only;
+		if (!cmdline.given("-kernel_expansion")) info.kernel_expansion = stored.kernel_expansion;
+		if (!cmdline.given("-sigma")) info.sigma = stored.sigma;
+	}
+	Classifier classifier(info.min_vot_length, info.max_vot_length, info.max_onset,
+												0.0, 0.0, 0.0, 0.0, info.kernel_expansion, info.sigma);
+	classifier.load(classifier_filename);
+	if (info.ignore_features != "")
+		classifier.ignore_features(info.ignore_features);
+	if (!parse_voicing_tracker(info.voicing_tracker, options.voicing_tracker)) {
+		LOG(ERROR) << "Unknown voicing tracker " << info.voicing_tracker;
+		return EXIT_FAILURE;
+	}
+	options.pos_only = info.pos_only;
+	options.text_precision = !full_precision;
+
+	CWavFile wav_file;
+	if (!wav_file.Open(wav_filename)) {
+		LOG(ERROR) << "Unable to open " << wav_filename;
+		return EXIT_FAILURE;
+	}
+	unsigned long num_samples = wav_file.ReadHeader();
+	double sampling_rate = wav_file.GetRate();
+	if (num_samples == 0 || sampling_rate <= 0) {
+		LOG(ERROR) << "Unable to read the samples of " << wav_filename;
+		wav_file.Close();
+		return EXIT_FAILURE;
+	}
+	LOG(INFO) << "Detecting the VOTs of " << wav_filename << " (" << num_samples/sampling_rate << " sec).";
+
+	StopDetector detector(classifier, options, sampling_rate);
+	vector<VotDetection> detections;
+	vector<short> pcm(READ_SAMPLES);
+	vector<double> samples(READ_SAMPLES);
+	unsigned long num_read = 0;
+	unsigned long max_buffer = 0;
+	while (num_read < num_samples) {
+		unsigned long n;
+		{
+			ProfileScope profile(PROFILE_WAV_READ);
+			n = wav_file.LoadSamples(&pcm[0], _min(num_samples - num_read, (unsigned long)READ_SAMPLES));
+		}
+		if (n == 0)
+			break;
+		for (unsigned long i = 0; i < n; i++)
+			samples[i] = double(pcm[i]/32767.0);
+		num_read += n;
+		detector.push(&samples[0], n, detections);
+		max_buffer = _max(max_buffer, detector.buffer_size());
+	}
+	wav_file.Close();
+	Profiler::count(PROFILE_BYTES_READ, num_read*sizeof(short));
+	detector.finish(detections);
+
+	LOG(INFO) << detections.size() << " VOTs detected in " << detector.num_proposals()
+	<< " proposed bursts (at most " << max_buffer/sampling_rate << " sec of audio in memory).";
+
+	if (output_filename != "") {
+		ofstream ofs(output_filename.c_str());
+		if (!ofs.good()) {
+			LOG(ERROR) << "Unable to open " << output_filename;
+			return EXIT_FAILURE;
+		}
+		write_detections(ofs, detections);
+	}
+	else {
+		write_detections(cout, detections);
+	}
+	if (textgrid_filename != "" && !write_textgrid(textgrid_filename, detections, num_read/sampling_rate))
+		return EXIT_FAILURE;
+
+	return EXIT_SUCCESS;
+}
+
+// ------------------------------- EOF -----------------------------//
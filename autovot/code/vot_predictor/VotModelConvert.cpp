@@ -0,0 +1,182 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   Main entry point
+ Purpose:  Convert between .pos/.neg classifiers and binary model files
+ Date:     19 Oct., 2026
+
+ **************************** INCLUDE FILES *****************************/
+#include <iostream>
+#include <fstream>
+#include <cmdline/cmd_line.h>
+#include "Classifier.h"
+#include "ModelFile.h"
+#include "Logger.h"
+
+using namespace std;
+
+/************************************************************************
+ Function:     print_info
+
+ Description:  Print the manifest of a binary model
+ Inputs:       ModelInfo &info
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+static void print_info(const ModelInfo &info)
+{
+	cout << "version=" << info.version << endl;
+	cout << "kernel_expansion=" << info.kernel_expansion << endl;
+	cout << "sigma=" << info.sigma << endl;
+	cout << "pos_only=" << (info.pos_only ? 1 : 0) << endl;
+	cout << "ignore_features=" << info.ignore_features << endl;
+	cout << "voicing_tracker=" << info.voicing_tracker << endl;
+	cout << "min_vot_length=" << info.min_vot_length << endl;
+	cout << "max_vot_length=" << info.max_vot_length << endl;
+	cout << "max_onset=" << info.max_onset << endl;
+	cout << "num_features=" << info.num_features << endl;
+	cout << "phi_pos_size=" << info.phi_pos_size << endl;
+	cout << "phi_neg_size=" << info.phi_neg_size << endl;
+	map<string, string>::const_iterator it;
+	for (it = info.metadata.begin(); it != info.metadata.end(); it++)
+		cout << it->first << "=" << it->second << endl;
+}
+
+/************************************************************************
+ Function:     main
+
+ Description:  Main entry point
+ Inputs:       int argc, char *argv[] - main input params
+ Output:       int - EXIT_SUCCESS or EXIT_FAILURE
+ Comments:     none.
+ ***********************************************************************/
+int main(int argc, char **argv)
+{
+	// Parse command line
+	int min_vot_length;
+	int max_vot_length;
+	int max_onset_time;
+	string ignore_features_str;
+	string voicing_tracker;
+	bool pos_only;
+	string kernel_expansion_name;
+	double sigma;
+	bool to_text;
+	bool info_only;
+	string input_filename;
+	string output_filename;
+	string verbose;
+
+	learning::cmd_line cmdline;
+	cmdline.info("Initial VOT detection - convert a classifier to a binary model file and back");
+	cmdline.add("-min_vot_length", "min. VOT length in msec stored as decoding default [15]", &min_vot_length, 15);
+	cmdline.add("-max_vot_length", "max. VOT length in msec stored as decoding default [200]", &max_vot_length, 200);
+	cmdline.add("-max_onset", "max. time to onset in msec stored as decoding default [150]", &max_onset_time, 150);
+	cmdline.add("-ignore_features", "features the classifier was trained without. E.g., \"3,7,19\".", &ignore_features_str, "");
+	cmdline.add("-voicing_tracker", "voicing tracker of the features the classifier was trained on, 'rapt' or 'yin' [rapt]",
+							&voicing_tracker, "rapt");
+	cmdline.add("-pos_only", "the classifier assumes only positive VOTs", &pos_only, false);
+	cmdline.add("-kernel_expansion", "kernel expansion of the classifier, 'poly2', 'rbf2' or 'rbf3'", &kernel_expansion_name, "");
+	cmdline.add("-sigma", "if kernel is rbf2 or rbf3 this is the sigma", &sigma, 1.0);
+	cmdline.add("-to_text", "convert a binary model file to <output>.pos and <output>.neg", &to_text, false);
+	cmdline.add("-info", "print the options stored in a binary model file", &info_only, false);
+	cmdline.add("-verbose", "log reporting level [ERROR, WARNING, INFO, or DEBUG]", &verbose, "INFO");
+	cmdline.add_master_option("input_classifier", &input_filename);
+	cmdline.add_master_option("output_classifier", &output_filename);
+	int rc = cmdline.parse(argc, argv);
+	if (rc < 1 || input_filename == "" || (output_filename == "" && !info_only)) {
+		cmdline.print_help();
+		return EXIT_FAILURE;
+	}
+
+	Log::ReportingLevel() = Log::FromString(verbose);
+	Log::ExecutableName() = basename(argv[0]);
+	Log::Asynchronous() = true;
+
+	if (info_only || to_text) {
+		ModelInfo info;
+		if (!is_model_file(input_filename)) {
+			LOG(ERROR) << input_filename << " is not a binary model file";
+			return EXIT_FAILURE;
+		}
+		if (!read_model_file(input_filename, info))
+			return EXIT_FAILURE;
+		if (info_only) {
+			print_info(info);
+			return EXIT_SUCCESS;
+		}
+		Classifier classifier(info.min_vot_length, info.max_vot_length, info.max_onset,
+													0.0, 0.0, 0.0, 0.0, info.kernel_expansion, info.sigma);
+		classifier.load(input_filename);
+		classifier.save(output_filename);
+		LOG(INFO) << "Wrote " << output_filename << ".pos and " << output_filename << ".neg";
+		return EXIT_SUCCESS;
+	}
+
+	if (voicing_tracker != "rapt" && voicing_tracker != "yin") {
+		LOG(ERROR) << "Unknown voicing tracker " << voicing_tracker;
+		return EXIT_FAILURE;
+	}
+	Classifier classifier(min_vot_length, max_vot_length, max_onset_time,
+												0.0, 0.0, 0.0, 0.0, kernel_expansion_name, sigma);
+
+	// the sizes are not checked when the weights are read as text
+	string filename_pos = input_filename + ".pos";
+	string filename_neg = input_filename + ".neg";
+	ifstream ifs_pos(filename_pos.c_str());
+	ifstream ifs_neg(filename_neg.c_str());
+	if (!ifs_pos.good() || !ifs_neg.good()) {
+		LOG(ERROR) << "Unable to open " << filename_pos << " and " << filename_neg;
+		return EXIT_FAILURE;
+	}
+	long pos_size = -1, neg_size = -1;
+	ifs_pos >> pos_size;
+	ifs_neg >> neg_size;
+	if (pos_size != classifier.get_kernel_phi_size_pos() || neg_size != classifier.get_phi_size_neg()) {
+		LOG(ERROR) << input_filename << " has weights of size " << pos_size << "+" << neg_size
+		<< ", expected " << classifier.get_kernel_phi_size_pos() << "+" << classifier.get_phi_size_neg()
+		<< " for kernel expansion \"" << kernel_expansion_name << "\"";
+		return EXIT_FAILURE;
+	}
+	classifier.load(input_filename);
+	if (ignore_features_str != "")
+		classifier.ignore_features(ignore_features_str);
+
+	ModelInfo info;
+	info.kernel_expansion = kernel_expansion_name;
+	info.sigma = sigma;
+	info.pos_only = pos_only;
+	info.ignore_features = ignore_features_str;
+	info.voicing_tracker = voicing_tracker;
+	info.min_vot_length = min_vot_length;
+	info.max_vot_length = max_vot_length;
+	info.max_onset = max_onset_time;
+	info.metadata["converted_from"] = input_filename;
+	classifier.set_model_info(info);
+	classifier.save(output_filename);
+	LOG(INFO) << "Wrote " << output_filename;
+
+	return EXIT_SUCCESS;
+}
+
+// ------------------------------- EOF -----------------------------//
@@ -0,0 +1,629 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   Main entry point
+ Purpose:  Decode server: the models are loaded once and requests are
+           served over a Unix domain socket
+ Date:     19 Oct., 2026
+
+ Protocol: every message (in both directions) is a 4-byte length in
+           network byte order followed by that many bytes of payload.
+           A request starts with a text command line ended by '\n':
+
+           DECODE <wav_filename> <window_start> <window_end>
+           PCM <sampling_rate> <window_start> <window_end>
+               followed by 16-bit little-endian signed samples
+           HEALTH
+           STATS
+           SHUTDOWN
+
+           Window times are in seconds; a window end of -1 means the end
+           of the signal. A DECODE or PCM request is answered by
+           "OK <num_models>" followed by one line per model:
+           "<model> <confidence> <burst> <voice>", where burst and voice
+           are times in seconds in the signal. Errors are answered by
+           "ERR <message>". A connection can send any number of requests.
+
+ **************************** INCLUDE FILES *****************************/
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <arpa/inet.h>
+#include <cmdline/cmd_line.h>
+#include "Classifier.h"
+#include "Dataset.h"
+#include "FrontEnd.h"
+#include "Logger.h"
+
+using namespace std;
+
+// largest request accepted (about 30 minutes of 16 kHz audio)
+#define MAX_MESSAGE_SIZE (64*1024*1024)
+// msec between checks of the shutdown flag while waiting
+#define POLL_INTERVAL 200
+// msec a client may stall in the middle of a message
+#define MESSAGE_TIMEOUT 30000
+
+static std::atomic<bool> stopping(false);
+
+/************************************************************************
+ Function:     stop_handler
+
+ Description:  SIGINT/SIGTERM handler: starts a graceful shutdown
+ Inputs:       int - signal number
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+static void stop_handler(int)
+{
+	stopping = true;
+}
+
+// The loaded models and the decoding options shared by all workers. The
+// classifiers are only read while serving.
+struct DecodeServer
+{
+	vector<Classifier*> classifiers;
+	vector<string> model_names;
+	vector<bool> pos_only;     // of each model
+	vector<VoicingTracker> voicing_tracker;  // of the features of each model
+	bool text_precision;
+	int min_vot_length;        // the largest of the models
+
+	// statistics
+	chrono::steady_clock::time_point start_time;
+	unsigned int num_threads;
+	std::atomic<unsigned long> num_connections;
+	std::atomic<unsigned long> num_active;
+	std::atomic<unsigned long> num_requests;
+	std::atomic<unsigned long> num_errors;
+	std::atomic<unsigned long> front_end_usec;
+	std::atomic<unsigned long> decode_usec;
+
+	// accepted connections waiting for a worker
+	deque<int> pending;
+	std::mutex pending_mutex;
+	std::condition_variable pending_cv;
+};
+
+/************************************************************************
+ Function:     wait_fd
+
+ Description:  Wait until a socket is readable or writable
+ Inputs:       int fd - the socket
+               short events - POLLIN or POLLOUT
+               bool stop_early - give up when the server is stopping
+ Output:       bool - true if the socket is ready
+ Comments:     Without stop_early it gives up after MESSAGE_TIMEOUT.
+               Data that is already buffered is reported as ready even
+               when the server is stopping.
+ ***********************************************************************/
+static bool wait_fd(int fd, short events, bool stop_early)
+{
+	int waited = 0;
+	for (;;) {
+		struct pollfd pfd;
+		pfd.fd = fd;
+		pfd.events = events;
+		pfd.revents = 0;
+		int rc = poll(&pfd, 1, (stop_early && stopping) ? 0 : POLL_INTERVAL);
+		if (rc > 0)
+			return true;
+		if (rc < 0 && errno != EINTR)
+			return false;
+		if (stop_early && stopping)
+			return false;
+		waited += POLL_INTERVAL;
+		if (!stop_early && waited >= MESSAGE_TIMEOUT)
+			return false;
+	}
+}
+
+/************************************************************************
+ Function:     read_full
+
+ Description:  Read exactly num_bytes from a socket
+ Inputs:       int fd, char *buffer, size_t num_bytes
+               bool stop_early - give up before the first byte if the
+               server is stopping
+ Output:       bool - false on end of file, error or timeout
+ Comments:     none.
+ ***********************************************************************/
+static bool read_full(int fd, char *buffer, size_t num_bytes, bool stop_early)
+{
+	size_t done = 0;
+	while (done < num_bytes) {
+		if (!wait_fd(fd, POLLIN, stop_early && done == 0))
+			return false;
+		ssize_t n = recv(fd, buffer + done, num_bytes - done, 0);
+		if (n == 0)
+			return false;
+		if (n < 0) {
+			if (errno == EINTR || errno == EAGAIN)
+				continue;
+			return false;
+		}
+		done += n;
+	}
+	return true;
+}
+
+/************************************************************************
+ Function:     write_message
+
+ Description:  Write a length-prefixed message to a socket
+ Inputs:       int fd, const string &payload
+ Output:       bool - true on success
+ Comments:     none.
+ ***********************************************************************/
+static bool write_message(int fd, const string &payload)
+{
+	uint32_t length = htonl(payload.size());
+	string message(reinterpret_cast<char*>(&length), sizeof(length));
+	message += payload;
+	size_t done = 0;
+	while (done < message.size()) {
+		if (!wait_fd(fd, POLLOUT, false))
+			return false;
+		ssize_t n = send(fd, message.data() + done, message.size() - done, MSG_NOSIGNAL);
+		if (n < 0) {
+			if (errno == EINTR || errno == EAGAIN)
+				continue;
+			return false;
+		}
+		done += n;
+	}
+	return true;
+}
+
+/************************************************************************
+ Function:     decode_samples
+
+ Description:  Run the front end and all the models on a window of speech
+ Inputs:       DecodeServer &server
+               infra::vector &samples, double sampling_rate
+               double window_start, window_end - in seconds
+               string &response - the reply
+ Output:       bool - true on success, otherwise response is the error
+ Comments:     none.
+ ***********************************************************************/
+static bool decode_samples(DecodeServer &server, infra::vector &samples,
+													 double sampling_rate, double window_start,
+													 double window_end, string &response)
+{
+	if (window_start < 0) {
+		response = "window start is negative";
+		return false;
+	}
+	if (window_end == -1)
+		window_end = (samples.size()-1)/double(sampling_rate);
+
+	// round the duration up to 3 figures after the point (as VotFrontEnd2)
+	double duration = round(1000*samples.size()/double(sampling_rate))/1000.0;
+	if (window_end > duration) {
+		ostringstream os;
+		os << "window end (" << window_end << ") is greater than the signal length (" << duration << ")";
+		response = os.str();
+		return false;
+	}
+
+	// the features once for each voicing tracker the models use
+	chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+	SpeechUtterance x[2];
+	for (int tracker=VOICING_RAPT; tracker <= VOICING_YIN; tracker++) {
+		if (find(server.voicing_tracker.begin(), server.voicing_tracker.end(), tracker) ==
+				server.voicing_tracker.end())
+			continue;
+		infra::matrix features;
+		infra::vector frame_times;
+		int first_frame;
+		if (!extract_features(samples, sampling_rate, window_start, window_end, true,
+													features, frame_times, first_frame, VoicingTracker(tracker))) {
+			response = "unable to extract features of the window";
+			return false;
+		}
+		features_to_utterance(features, server.text_precision, x[tracker]);
+
+		// Classifier::predict needs room for the shortest VOT and the feature span
+		if (int(x[tracker].size()) <= server.min_vot_length + PHI_SPAN) {
+			response = "window is too short";
+			return false;
+		}
+	}
+	chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+
+	ostringstream os;
+	os.precision(12);
+	os << "OK " << server.classifiers.size() << "\n";
+	for (unsigned int m=0; m < server.classifiers.size(); m++) {
+		VotLocation y_hat;
+		double confidence = server.classifiers[m]->predict(x[server.voicing_tracker[m]], y_hat,
+																											 server.pos_only[m]);
+		os << server.model_names[m] << " " << confidence << " "
+		<< window_start + y_hat.burst*FRAME_SIZE << " "
+		<< window_start + y_hat.voice*FRAME_SIZE << "\n";
+	}
+	chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+	server.front_end_usec += chrono::duration_cast<chrono::microseconds>(t1-t0).count();
+	server.decode_usec += chrono::duration_cast<chrono::microseconds>(t2-t1).count();
+	response = os.str();
+
+	return true;
+}
+
+/************************************************************************
+ Function:     handle_request
+
+ Description:  Serve one request
+ Inputs:       DecodeServer &server
+               string &request - the payload of the request
+               string &response - the reply
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+static void handle_request(DecodeServer &server, const string &request, string &response)
+{
+	size_t eol = request.find('\n');
+	string command_line = request.substr(0, eol);
+	istringstream is(command_line);
+	string command;
+	is >> command;
+
+	bool ok = true;
+	if (command == "DECODE") {
+		string wav_filename;
+		double window_start, window_end;
+		infra::vector samples;
+		double sampling_rate;
+		if (!(is >> wav_filename >> window_start >> window_end)) {
+			response = "usage: DECODE <wav_filename> <window_start> <window_end>";
+			ok = false;
+		}
+		else if (!read_wav_samples(wav_filename, samples, sampling_rate)) {
+			response = "unable to read " + wav_filename;
+			ok = false;
+		}
+		else {
+			ok = decode_samples(server, samples, sampling_rate, window_start, window_end, response);
+		}
+		server.num_requests++;
+	}
+	else if (command == "PCM") {
+		double sampling_rate, window_start, window_end;
+		if (!(is >> sampling_rate >> window_start >> window_end) || sampling_rate <= 0 ||
+				eol == string::npos) {
+			response = "usage: PCM <sampling_rate> <window_start> <window_end>\\n<samples>";
+			ok = false;
+		}
+		else {
+			const unsigned char *data = reinterpret_cast<const unsigned char*>(request.data()) + eol + 1;
+			unsigned long num_samples = (request.size() - eol - 1)/2;
+			infra::vector samples(num_samples);
+			for (unsigned long i=0; i < num_samples; i++) {
+				short sample = short(data[2*i] | (data[2*i+1] << 8));
+				samples[i] = double(sample/32767.0);
+			}
+			ok = decode_samples(server, samples, sampling_rate, window_start, window_end, response);
+		}
+		server.num_requests++;
+	}
+	else if (command == "HEALTH") {
+		response = "OK";
+	}
+	else if (command == "STATS") {
+		unsigned long num_requests = server.num_requests;
+		unsigned long num_decoded = num_requests - server.num_errors;
+		ostringstream os;
+		os << "OK\n";
+		os << "uptime " << chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now() -
+																														 server.start_time).count() << "\n";
+		os << "models " << server.classifiers.size() << "\n";
+		os << "threads " << server.num_threads << "\n";
+		os << "connections " << server.num_connections << "\n";
+		os << "active_connections " << server.num_active << "\n";
+		os << "requests " << num_requests << "\n";
+		os << "errors " << server.num_errors << "\n";
+		os << "front_end_msec " << (num_decoded ? server.front_end_usec/1000.0/num_decoded : 0.0) << "\n";
+		os << "decode_msec " << (num_decoded ? server.decode_usec/1000.0/num_decoded : 0.0) << "\n";
+		response = os.str();
+	}
+	else if (command == "SHUTDOWN") {
+		LOG(INFO) << "Shutdown requested by a client.";
+		stopping = true;
+		response = "OK";
+	}
+	else {
+		response = "unknown command '" + command + "'";
+		ok = false;
+	}
+
+	if (!ok) {
+		if (command == "DECODE" || command == "PCM")
+			server.num_errors++;
+		LOG(DEBUG) << "Request '" << command_line << "' failed: " << response;
+		response = "ERR " + response;
+	}
+}
+
+/************************************************************************
+ Function:     serve_connection
+
+ Description:  Serve the requests of one client until it disconnects or
+               the server is stopping
+ Inputs:       DecodeServer &server, int fd - the client socket
+ Output:       none.
+ Comments:     A request that was received is always answered, so
+               in-flight requests complete during a shutdown.
+ ***********************************************************************/
+static void serve_connection(DecodeServer &server, int fd)
+{
+	server.num_active++;
+	for (;;) {
+		uint32_t length;
+		if (!read_full(fd, reinterpret_cast<char*>(&length), sizeof(length), true))
+			break;
+		length = ntohl(length);
+		if (length > MAX_MESSAGE_SIZE) {
+			write_message(fd, "ERR message too long");
+			break;
+		}
+		string request(length, '\0');
+		if (length > 0 && !read_full(fd, &request[0], length, false))
+			break;
+		string response;
+		handle_request(server, request, response);
+		if (!write_message(fd, response))
+			break;
+	}
+	close(fd);
+	server.num_active--;
+}
+
+/************************************************************************
+ Function:     worker
+
+ Description:  Worker thread: serves the accepted connections
+ Inputs:       DecodeServer *server
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+static void worker(DecodeServer *server)
+{
+	for (;;) {
+		int fd;
+		{
+			std::unique_lock<std::mutex> lock(server->pending_mutex);
+			while (server->pending.empty() && !stopping)
+				server->pending_cv.wait_for(lock, chrono::milliseconds(POLL_INTERVAL));
+			if (server->pending.empty())
+				return;
+			fd = server->pending.front();
+			server->pending.pop_front();
+		}
+		serve_connection(*server, fd);
+	}
+}
+
+/************************************************************************
+ Function:     main
+
+ Description:  Main entry point
+ Inputs:       int argc, char *argv[] - main input params
+ Output:       int - EXIT_SUCCESS or EXIT_FAILURE
+ Comments:     none.
+ ***********************************************************************/
+int main(int argc, char **argv)
+{
+	// Parse command line
+	int min_vot_length;
+	int max_vot_length;
+	int max_onset_time;
+	string socket_path;
+	string classifier_filenames;
+	string ignore_features_str;
+	string voicing_tracker_str;
+	bool pos_only;
+	bool full_precision;
+	string kernel_expansion_name;
+	double sigma;
+	unsigned int num_threads;
+	unsigned int request_threads;
+	string verbose;
+
+	learning::cmd_line cmdline;
+	cmdline.info("Initial VOT detection - decode server");
+	cmdline.add("-min_vot_length", "min. phoneme duration in msec [15]", &min_vot_length, 15);
+	cmdline.add("-max_vot_length", "max. phoneme duration in msec [200]", &max_vot_length, 200);
+	cmdline.add("-max_onset", "min. phoneme duration in msec [150]", &max_onset_time, 150);
+	cmdline.add("-ignore_features", "ignore the following features. E.g., \"3,7,19\".", &ignore_features_str, "");
+	cmdline.add("-voicing_tracker", "voicing tracker of the features: 'rapt' or 'yin' [rapt]", &voicing_tracker_str, "rapt");
+	cmdline.add("-pos_only", "Assume only positive VOTs", &pos_only, false);
+	cmdline.add("-kernel_expansion", "use kernel expansion of type 'poly2' or 'rbf2'", &kernel_expansion_name, "");
+	cmdline.add("-sigma", "if kernel is rbf2 or rbf3 this is the sigma", &sigma, 1.0);
+	cmdline.add("-threads", "number of worker threads [4]", &num_threads, 4);
+	cmdline.add("-request_threads", "number of threads computing the features of each request [1]",
+							&request_threads, 1);
+	cmdline.add("-full_precision", "decode the features as computed instead of rounding them "
+							"as in a features file", &full_precision, false);
+	cmdline.add("-verbose", "log reporting level [ERROR, WARNING, INFO, or DEBUG]", &verbose, "INFO");
+	cmdline.add_master_option("socket_path", &socket_path);
+	cmdline.add_master_option("classifier_filenames (comma separated)", &classifier_filenames);
+	int rc = cmdline.parse(argc, argv);
+	if (rc < 2) {
+		cmdline.print_help();
+		return EXIT_FAILURE;
+	}
+
+	Log::ReportingLevel() = Log::FromString(verbose);
+	Log::ExecutableName() = basename(argv[0]);
+	Log::Asynchronous() = true;
+	set_front_end_threads(request_threads);
+
+	DecodeServer server;
+	server.text_precision = !full_precision;
+	server.min_vot_length = 0;
+	server.num_threads = (num_threads < 1) ? 1 : num_threads;
+	server.num_connections = 0;
+	server.num_active = 0;
+	server.num_requests = 0;
+	server.num_errors = 0;
+	server.front_end_usec = 0;
+	server.decode_usec = 0;
+
+	// load the models
+	istringstream filenames(classifier_filenames);
+	string classifier_filename;
+	while (getline(filenames, classifier_filename, ',')) {
+		if (classifier_filename == "")
+			continue;
+		// a binary model brings its own defaults, as in VotDecode
+		ModelInfo info;
+		info.min_vot_length = min_vot_length;
+		info.max_vot_length = max_vot_length;
+		info.max_onset = max_onset_time;
+		info.ignore_features = ignore_features_str;
+		info.voicing_tracker = voicing_tracker_str;
+		info.pos_only = pos_only;
+		info.kernel_expansion = kernel_expansion_name;
+		info.sigma = sigma;
+		if (is_model_file(classifier_filename)) {
+			ModelInfo stored;
+			if (!read_model_file(classifier_filename, stored))
+				return EXIT_FAILURE;
+			if (!cmdline.given("-min_vot_length")) info.min_vot_length = stored.min_vot_length;
+			if (!cmdline.given("-max_vot_length")) info.max_vot_length = stored.max_vot_length;
+			if (!cmdline.given("-max_onset")) info.max_onset = stored.max_onset;
+			if (!cmdline.given("-ignore_features")) info.ignore_features = stored.ignore_features;
+			if (!cmdline.given("-voicing_tracker")) info.voicing_tracker = stored.voicing_tracker;
+			if (!cmdline.given("-pos_only")) info.pos_only = stored.pos_only;
+			if (!cmdline.given("-kernel_expansion")) info.kernel_expansion = stored.kernel_expansion;
+			if (!cmdline.given("-sigma")) info.sigma = stored.sigma;
+		}
+		VoicingTracker voicing_tracker;
+		if (!parse_voicing_tracker(info.voicing_tracker, voicing_tracker)) {
+			LOG(ERROR) << "Unknown voicing tracker " << info.voicing_tracker << " of " << classifier_filename;
+			return EXIT_FAILURE;
+		}
+		Classifier *classifier = new Classifier(info.min_vot_length, info.max_vot_length, info.max_onset,
+																						0.0, 0.0, 0.0, 0.0, info.kernel_expansion, info.sigma);
+		classifier->load(classifier_filename);
+		if (info.ignore_features != "")
+			classifier->ignore_features(info.ignore_features);
+		server.classifiers.push_back(classifier);
+		server.pos_only.push_back(info.pos_only);
+		server.voicing_tracker.push_back(voicing_tracker);
+		if (info.min_vot_length > server.min_vot_length)
+			server.min_vot_length = info.min_vot_length;
+		server.model_names.push_back(basename(classifier_filename));
+	}
+	if (server.classifiers.size() == 0) {
+		LOG(ERROR) << "No classifier was given.";
+		return EXIT_FAILURE;
+	}
+	LOG(INFO) << "Loaded " << server.classifiers.size() << " model(s).";
+
+	// open the socket
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (socket_path.size() >= sizeof(address.sun_path)) {
+		LOG(ERROR) << "Socket path " << socket_path << " is too long.";
+		return EXIT_FAILURE;
+	}
+	strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path)-1);
+
+	// remove a socket left by a previous server
+	struct stat st;
+	if (stat(socket_path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+		unlink(socket_path.c_str());
+
+	int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listen_fd < 0 ||
+			::bind(listen_fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+			listen(listen_fd, 64) != 0) {
+		LOG(ERROR) << "Unable to listen on " << socket_path << ": " << strerror(errno);
+		return EXIT_FAILURE;
+	}
+
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = stop_handler;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	server.start_time = chrono::steady_clock::now();
+	vector<thread> workers;
+	for (uint t = 0; t < server.num_threads; t++)
+		workers.push_back(thread(worker, &server));
+	LOG(INFO) << "Listening on " << socket_path << " with " << server.num_threads << " threads.";
+
+	// accept connections until a shutdown is requested
+	while (!stopping) {
+		if (!wait_fd(listen_fd, POLLIN, true))
+			continue;
+		int fd = accept(listen_fd, NULL, NULL);
+		if (fd < 0)
+			continue;
+		server.num_connections++;
+		std::lock_guard<std::mutex> lock(server.pending_mutex);
+		server.pending.push_back(fd);
+		server.pending_cv.notify_one();
+	}
+
+	// stop accepting, let the workers finish their requests
+	LOG(INFO) << "Shutting down.";
+	close(listen_fd);
+	unlink(socket_path.c_str());
+	server.pending_cv.notify_all();
+	for (uint t = 0; t < workers.size(); t++)
+		workers[t].join();
+	for (uint i = 0; i < server.pending.size(); i++)
+		close(server.pending[i]);
+	for (uint m = 0; m < server.classifiers.size(); m++)
+		delete server.classifiers[m];
+
+	LOG(INFO) << "Served " << server.num_requests << " requests (" << server.num_errors << " errors).";
+
+	return EXIT_SUCCESS;
+}
+
+// ------------------------------- EOF -----------------------------//
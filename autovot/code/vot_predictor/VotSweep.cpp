@@ -0,0 +1,396 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   Main entry point
+ Purpose:  Grid search over the training parameters
+ Date:     19 Oct., 2026
+
+ **************************** INCLUDE FILES *****************************/
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cmdline/cmd_line.h>
+#include "Classifier.h"
+#include "CandidateFeatures.h"
+#include "Dataset.h"
+#include "Logger.h"
+
+using namespace std;
+
+// A labeled set of utterances read once and shared (read only) by all threads
+struct LabeledSet
+{
+	void read(string &instances_filelist, string &labels_filename);
+	vector<SpeechUtterance> x;
+	vector<VotLocation> y;
+};
+
+// One point of the grid and its results on the validation set
+struct SweepConfig
+{
+	double C;
+	unsigned int epochs;
+	int min_vot_length;
+	int max_vot_length;
+	string kernel_expansion_name;
+	double sigma;
+
+	double vot_loss;        // mean |VOT error| in msec
+	double boundary_loss;   // mean burst and voice onset error in msec
+	double vot_within[3];   // % VOT errors <= 5, 10 and 20 msec
+	double train_seconds;
+};
+
+// Options common to all the configurations
+struct SweepOptions
+{
+	int max_onset_time;
+	double loss_epsilon;
+	double loss_ep_on;
+	double loss_ep_off;
+	bool vot_loss;
+	bool pos_only;
+	string training_method;
+	string ignore_features_str;
+	double cache_mb;
+};
+
+static int vot_resolutions[] = {5,10,20};
+
+/************************************************************************
+ Function:     LabeledSet::read
+
+ Description:  Read all the instances and labels of a dataset
+ Inputs:       string &instances_filelist, string &labels_filename
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+void LabeledSet::read(string &instances_filelist, string &labels_filename)
+{
+	Dataset dataset(instances_filelist, labels_filename);
+	x.resize(dataset.size());
+	y.resize(dataset.size());
+	for (uint i = 0; i < dataset.size(); i++)
+		dataset.read(x[i], y[i]);
+}
+
+/************************************************************************
+ Function:     parse_list
+
+ Description:  Split a comma separated list
+ Inputs:       string &str
+ Output:       vector<string>
+ Comments:     none.
+ ***********************************************************************/
+static vector<string> parse_list(const string &str)
+{
+	vector<string> items;
+	stringstream ss(str);
+	string item;
+	while (getline(ss, item, ','))
+		if (item != "")
+			items.push_back(item);
+	return items;
+}
+
+/************************************************************************
+ Function:     parse_number_list
+
+ Description:  Split a comma separated list of numbers
+ Inputs:       string &str, string &option_name
+ Output:       vector<double>
+ Comments:     none.
+ ***********************************************************************/
+static vector<double> parse_number_list(const string &str, const string &option_name)
+{
+	vector<string> items = parse_list(str);
+	vector<double> values;
+	for (uint i = 0; i < items.size(); i++) {
+		char *end;
+		double value = strtod(items[i].c_str(), &end);
+		if (*end != '\0') {
+			LOG(ERROR) << "Unable to parse \"" << items[i] << "\" in " << option_name;
+			exit(-1);
+		}
+		values.push_back(value);
+	}
+	if (values.size() == 0) {
+		LOG(ERROR) << "No values given for " << option_name;
+		exit(-1);
+	}
+	return values;
+}
+
+/************************************************************************
+ Function:     train_and_evaluate
+
+ Description:  Train a classifier with one configuration and evaluate it
+               on the validation set
+ Inputs:       SweepConfig &config - configuration, results are set here
+               SweepOptions &options
+               LabeledSet &training_set, LabeledSet &validation_set
+               Classifier *&classifier - the trained classifier
+ Output:       none.
+ Comments:     Same training as VotTrain without a validation set: the
+               mean of all the w_i is used.
+ ***********************************************************************/
+static void train_and_evaluate(SweepConfig &config, const SweepOptions &options,
+															 LabeledSet &training_set, LabeledSet &validation_set,
+															 Classifier *&classifier)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	classifier = new Classifier(config.min_vot_length, config.max_vot_length, options.max_onset_time,
+															config.C, options.loss_epsilon, options.loss_ep_on, options.loss_ep_off,
+															config.kernel_expansion_name, config.sigma);
+	if (options.ignore_features_str != "") {
+		string ignore_features_str = options.ignore_features_str;
+		classifier->ignore_features(ignore_features_str);
+	}
+
+	CandidateFeaturesCache candidate_cache(config.epochs > 1 ? options.cache_mb : 0.0);
+
+	for (uint epoch = 0; epoch < config.epochs; epoch++) {
+		for (uint i = 0; i < training_set.x.size(); i++) {
+			SpeechUtterance &x = training_set.x[i];
+			VotLocation &y = training_set.y[i];
+			VotLocation y_hat;
+			if (options.training_method == "PA") {
+				CandidateFeatures *cf = candidate_cache.find(i);
+				if (cf == NULL && epoch == 0)
+					cf = classifier->cache_candidates(x, i, candidate_cache, options.pos_only);
+				if (cf != NULL)
+					classifier->predict_epsilon(*cf, y_hat, y, -1.0, options.vot_loss, options.pos_only);
+				else
+					classifier->predict_epsilon(x, y_hat, y, -1.0, options.vot_loss, options.pos_only);
+			}
+			else {
+				classifier->predict(x, y_hat, options.pos_only);
+			}
+			classifier->update(x, y, y_hat, options.vot_loss);
+		}
+	}
+	int num_training_examples = config.epochs*training_set.x.size();
+	classifier->w_star_mean(num_training_examples);
+
+	config.train_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	// evaluate on the validation set
+	int cumulative_loss = 0;
+	int cumulative_vot_loss = 0;
+	int cum_vot_loss_less_than[sizeof(vot_resolutions)/sizeof(int)] = {0};
+	for (uint i = 0; i < validation_set.x.size(); i++) {
+		VotLocation &y = validation_set.y[i];
+		VotLocation y_hat;
+		classifier->predict(validation_set.x[i], y_hat, options.pos_only);
+		cumulative_loss += abs(y.burst - y_hat.burst) + abs(y.voice - y_hat.voice);
+		int vot_loss = abs(y.voice-y.burst-(y_hat.voice-y_hat.burst));
+		cumulative_vot_loss += vot_loss;
+		for (uint j = 0; j < sizeof(vot_resolutions)/sizeof(int); j++)
+			if (vot_loss <= vot_resolutions[j]) cum_vot_loss_less_than[j]++;
+	}
+	double num_vots = validation_set.x.size();
+	config.vot_loss = cumulative_vot_loss/num_vots;
+	config.boundary_loss = cumulative_loss/(2.0*num_vots);
+	for (uint j = 0; j < sizeof(vot_resolutions)/sizeof(int); j++)
+		config.vot_within[j] = 100.0*cum_vot_loss_less_than[j]/num_vots;
+}
+
+/************************************************************************
+ Function:     main
+
+ Description:  Main entry point
+ Inputs:       int argc, char *argv[] - main input params
+ Output:       int - EXIT_SUCCESS or EXIT_FAILURE
+ Comments:     none.
+ ***********************************************************************/
+int main(int argc, char **argv)
+{
+	// Parse command line
+	string C_list;
+	string epochs_list;
+	string min_vot_length_list;
+	string max_vot_length_list;
+	string kernel_expansion_list;
+	string sigma_list;
+	SweepOptions options;
+	unsigned int num_threads;
+	string best_classifier_filename;
+	string train_instances_filelist;
+	string train_labels_filename;
+	string val_instances_filelist;
+	string val_labels_filename;
+	string results_filename;
+	string verbose;
+
+	learning::cmd_line cmdline;
+	cmdline.info("Initial VOT detection - grid search over training parameters");
+	cmdline.add("-C", "comma separated values of C [5.0]", &C_list, "5.0");
+	cmdline.add("-epochs", "comma separated numbers of epochs [1]", &epochs_list, "1");
+	cmdline.add("-min_vot_length", "comma separated min. vot durations in msec [10]", &min_vot_length_list, "10");
+	cmdline.add("-max_vot_length", "comma separated max. vot durations in msec [200]", &max_vot_length_list, "200");
+	cmdline.add("-kernel_expansion", "comma separated kernel expansions, 'none', 'poly2', 'rbf2' or 'rbf3' [none]",
+							&kernel_expansion_list, "none");
+	cmdline.add("-sigma", "comma separated values of sigma, used with rbf2 and rbf3 [1.0]", &sigma_list, "1.0");
+	cmdline.add("-max_onset", "max. time to onset in msec [150]", &options.max_onset_time, 150);
+	cmdline.add("-loss_eps", "epsilon parameter of the loss", &options.loss_epsilon, 1.0);
+	cmdline.add("-ep_on", "epsilon parameter of the onset loss", &options.loss_ep_on, 10.0);
+	cmdline.add("-ep_off", "epsilon parameter of the offset loss", &options.loss_ep_off, 1.0);
+	cmdline.add("-ignore_features", "ignore the following features. E.g., \"3,7,19\".", &options.ignore_features_str, "");
+	cmdline.add("-vot_loss", "use the VOT loss instead of alignment loss", &options.vot_loss, false);
+	cmdline.add("-training_method", "PA or Perceptron", &options.training_method, "PA");
+	cmdline.add("-pos_only", "Assume only positive VOTs", &options.pos_only, false);
+	cmdline.add("-cache_mb", "cache candidate features across epochs, up to this size in MB per configuration [0]",
+							&options.cache_mb, 0.0);
+	cmdline.add("-threads", "number of configurations trained concurrently [1]", &num_threads, 1);
+	cmdline.add("-save_best", "save the classifier with the lowest validation VOT error to this file",
+							&best_classifier_filename, "");
+	cmdline.add("-verbose", "log reporting level [ERROR, WARNING, INFO, or DEBUG]", &verbose, "INFO");
+	cmdline.add_master_option("train_instances_filelist", &train_instances_filelist);
+	cmdline.add_master_option("train_labels_filename", &train_labels_filename);
+	cmdline.add_master_option("val_instances_filelist", &val_instances_filelist);
+	cmdline.add_master_option("val_labels_filename", &val_labels_filename);
+	cmdline.add_master_option("results_filename", &results_filename);
+	int rc = cmdline.parse(argc, argv);
+	if (rc < 5) {
+		cmdline.print_help();
+		return EXIT_FAILURE;
+	}
+
+	Log::ReportingLevel() = Log::FromString(verbose);
+	Log::ExecutableName() = basename(argv[0]);
+	Log::Asynchronous() = true;
+
+	if (options.training_method != "PA" && options.training_method != "Perceptron") {
+		LOG(ERROR) << "Unsupported training method";
+		return EXIT_FAILURE;
+	}
+
+	// build the grid
+	vector<double> C_values = parse_number_list(C_list, "-C");
+	vector<double> epochs_values = parse_number_list(epochs_list, "-epochs");
+	vector<double> min_vot_length_values = parse_number_list(min_vot_length_list, "-min_vot_length");
+	vector<double> max_vot_length_values = parse_number_list(max_vot_length_list, "-max_vot_length");
+	vector<string> kernel_values = parse_list(kernel_expansion_list);
+	vector<double> sigma_values = parse_number_list(sigma_list, "-sigma");
+	if (kernel_values.size() == 0) kernel_values.push_back("none");
+
+	vector<SweepConfig> configs;
+	for (uint k = 0; k < kernel_values.size(); k++) {
+		// sigma has no effect on the other kernels
+		bool rbf = (kernel_values[k] == "rbf2" || kernel_values[k] == "rbf3");
+		for (uint s = 0; s < (rbf ? sigma_values.size() : 1); s++)
+			for (uint c = 0; c < C_values.size(); c++)
+				for (uint e = 0; e < epochs_values.size(); e++)
+					for (uint m = 0; m < min_vot_length_values.size(); m++)
+						for (uint n = 0; n < max_vot_length_values.size(); n++) {
+							SweepConfig config;
+							config.C = C_values[c];
+							config.epochs = (unsigned int)epochs_values[e];
+							config.min_vot_length = int(min_vot_length_values[m]);
+							config.max_vot_length = int(max_vot_length_values[n]);
+							config.kernel_expansion_name = kernel_values[k];
+							config.sigma = rbf ? sigma_values[s] : 1.0;
+							configs.push_back(config);
+						}
+	}
+
+	// read the features once
+	LabeledSet training_set;
+	training_set.read(train_instances_filelist, train_labels_filename);
+	LabeledSet validation_set;
+	validation_set.read(val_instances_filelist, val_labels_filename);
+	if (training_set.x.size() == 0 || validation_set.x.size() == 0) {
+		LOG(ERROR) << "Empty training or validation set";
+		return EXIT_FAILURE;
+	}
+	LOG(INFO) << "Sweeping " << configs.size() << " configurations on " << training_set.x.size()
+	<< " training and " << validation_set.x.size() << " validation examples.";
+
+	// train the configurations on a pool of threads
+	atomic<size_t> next_config(0);
+	mutex best_mutex;
+	int best_config = -1;
+
+	if (num_threads < 1) num_threads = 1;
+	if (num_threads > configs.size()) num_threads = configs.size();
+	vector<thread> workers;
+	for (uint t = 0; t < num_threads; t++) {
+		workers.push_back(thread([&]() {
+			for (size_t i = next_config++; i < configs.size(); i = next_config++) {
+				Classifier *classifier = NULL;
+				train_and_evaluate(configs[i], options, training_set, validation_set, classifier);
+				LOG(INFO) << "Configuration " << i+1 << "/" << configs.size() << ": VOT error = "
+				<< configs[i].vot_loss << " msec";
+				{
+					lock_guard<mutex> lock(best_mutex);
+					if (best_config < 0 || configs[i].vot_loss < configs[best_config].vot_loss ||
+							(configs[i].vot_loss == configs[best_config].vot_loss && int(i) < best_config)) {
+						best_config = i;
+						if (best_classifier_filename != "")
+							classifier->save(best_classifier_filename);
+					}
+				}
+				delete classifier;
+			}
+		}));
+	}
+	for (uint t = 0; t < workers.size(); t++)
+		workers[t].join();
+
+	// results table
+	ofstream ofs(results_filename.c_str());
+	if (!ofs.good()) {
+		LOG(ERROR) << "Unable to open " << results_filename << " for writing.";
+		return EXIT_FAILURE;
+	}
+	ofs << "C\tepochs\tmin_vot\tmax_vot\tkernel\tsigma\tvot_err\tboundary_err"
+	<< "\tvot<=5\tvot<=10\tvot<=20\ttrain_sec" << endl;
+	ofs << fixed;
+	for (uint i = 0; i < configs.size(); i++) {
+		SweepConfig &config = configs[i];
+		ofs << setprecision(4) << config.C << "\t" << config.epochs << "\t" << config.min_vot_length << "\t"
+		<< config.max_vot_length << "\t" << config.kernel_expansion_name << "\t" << config.sigma << "\t"
+		<< setprecision(2) << config.vot_loss << "\t" << config.boundary_loss << "\t"
+		<< config.vot_within[0] << "\t" << config.vot_within[1] << "\t" << config.vot_within[2] << "\t"
+		<< config.train_seconds << endl;
+	}
+	ofs.close();
+
+	SweepConfig &best = configs[best_config];
+	LOG(INFO) << "Best configuration: -C " << best.C << " -epochs " << best.epochs
+	<< " -min_vot_length " << best.min_vot_length << " -max_vot_length " << best.max_vot_length
+	<< " -kernel_expansion " << best.kernel_expansion_name << " -sigma " << best.sigma
+	<< " (VOT error " << best.vot_loss << " msec)";
+	LOG(INFO) << "Sweep completed.";
+
+	return EXIT_SUCCESS;
+}
+
+// ------------------------------- EOF -----------------------------//
@@ -30,13 +30,558 @@ License along with Autovot.  If not, see
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <sstream>
+#include <ctime>
+#include <thread>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <signal.h>
 #include <cmdline/cmd_line.h>
 #include "Classifier.h"
+#include "CandidateFeatures.h"
 #include "Dataset.h"
+#include "Profiler.h"
 #include "Logger.h"
 
 using namespace std;
 
+// examples of one mini-batch, predicted in parallel against the same w
+struct TrainingBatch
+{
+	Classifier *classifier;
+	CandidateFeaturesCache *candidate_cache;
+	std::string training_method;
+	unsigned long first_index;
+	bool first_epoch;
+	bool vot_loss;
+	bool pos_only;
+	std::vector<SpeechUtterance> x;
+	std::vector<VotLocation> y;
+	std::vector<VotLocation> y_hat;
+};
+
+/************************************************************************
+ Function:     predict_batch
+ 
+ Description:  Worker thread: predicts the examples first, first+step, ...
+               of the batch
+ Inputs:       TrainingBatch *batch, unsigned int first, unsigned int step
+ Output:       none.
+ Comments:     The classifier is only read here; the updates are applied by
+               the main thread after all the workers are joined.
+ ***********************************************************************/
+static void predict_batch(TrainingBatch *batch, unsigned int first, unsigned int step)
+{
+	Classifier &classifier = *batch->classifier;
+	for (unsigned int b = first; b < batch->x.size(); b += step) {
+		if (batch->training_method == "PA") {
+			// predict for large-margin (epsilon=1.0)
+			unsigned long i = batch->first_index + b;
+			CandidateFeatures *cf = batch->candidate_cache->find(i);
+			if (cf == NULL && batch->first_epoch)
+				cf = classifier.cache_candidates(batch->x[b], i, *batch->candidate_cache, batch->pos_only);
+			if (cf != NULL)
+				classifier.predict_epsilon(*cf, batch->y_hat[b], batch->y[b], -1.0, batch->vot_loss, batch->pos_only);
+			else
+				classifier.predict_epsilon(batch->x[b], batch->y_hat[b], batch->y[b], -1.0, batch->vot_loss, batch->pos_only);
+		}
+		//      else if (training_method == "Pegasos") {
+		//        // predict for large-margin (epsilon=1.0)
+		//        VotLocation y_hat_loss;
+		//        classifier.predict_epsilon(x, y_hat_loss, y, 1.0, vot_loss);
+		//        loss = classifier.update_pegasos(x, y, y_hat_loss);
+		//      }
+		//      else if (training_method == "DirectLossMin") {
+		//        // predict for direct-loss if epsilon is given (not zero)
+		//        VotLocation y_hat_eps;
+		//        classifier.predict_epsilon(x, y_hat_eps, y, epsilon, vot_loss);
+		//        VotLocation y_hat;
+		//        classifier.predict(x, y_hat);
+		//        loss = classifier.update_direct_loss(x, y_hat_eps, y_hat, y, epsilon);
+		//      }
+		else { // Perceptron
+			classifier.predict(batch->x[b], batch->y_hat[b], batch->pos_only);
+		}
+	}
+}
+
+/************************************************************************
+ Function:     validation_loss
+ 
+ Description:  Mean onset+offset error of the classifier on a validation set
+ Inputs:       Classifier &classifier
+               string &val_instances_filelist, string &val_labels_filename
+               bool pos_only
+ Output:       double - the mean error in frames
+ Comments:     none.
+ ***********************************************************************/
+static double validation_loss(Classifier &classifier, string &val_instances_filelist,
+															string &val_labels_filename, bool pos_only)
+{
+	Dataset val_dataset(val_instances_filelist, val_labels_filename);
+	double this_w_loss = 0.0;
+	for (uint ii=0; ii < val_dataset.size(); ++ii) {
+		SpeechUtterance xx;
+		VotLocation yy;
+		VotLocation yy_hat;
+		val_dataset.read(xx, yy);
+		classifier.predict(xx, yy_hat, pos_only);
+		int onset_loss = abs(yy.voice - yy_hat.voice);
+		int offset_loss = abs(yy.burst - yy_hat.burst);
+		this_w_loss += onset_loss+offset_loss;
+	}
+	this_w_loss /= val_dataset.size();
+	return this_w_loss;
+}
+
+// Iterative parameter mixing: in every epoch each of K workers trains one
+// epoch of the online algorithm on its shard, starting from the mixed w.
+// The coordinator then mixes the workers' weights, weighted by the shard
+// sizes. All the exchange goes through files in a shared directory:
+//   shard<k>.features, shard<k>.labels  - the shards (written once)
+//   mixed.<epoch>                       - weights the workers start from
+//   shard<k>.<epoch>                    - weights after training on a shard
+// Files are written under a temporary name and renamed when complete.
+struct MixingState
+{
+	MixingState(int pos_dim, int neg_dim) :
+	w_pos(pos_dim), w_neg(neg_dim), w_pos_sum(pos_dim), w_neg_sum(neg_dim),
+	num_examples(0.0), loss(0.0) {
+		w_pos.zeros(); w_neg.zeros(); w_pos_sum.zeros(); w_neg_sum.zeros();
+	}
+	bool save(const string &filename);
+	bool load(const string &filename);
+	
+	infra::vector w_pos;
+	infra::vector w_neg;
+	infra::vector w_pos_sum; // sum of the w_i while training on the shard
+	infra::vector w_neg_sum;
+	double num_examples;
+	double loss;
+};
+
+/************************************************************************
+ Function:     MixingState::save
+ 
+ Description:  Save the state to a file, atomically
+ Inputs:       string &filename
+ Output:       bool - true on success
+ Comments:     none.
+ ***********************************************************************/
+bool MixingState::save(const string &filename)
+{
+	string tmp_filename = filename + ".tmp";
+	FILE *fp = fopen(tmp_filename.c_str(), "wb");
+	if (fp == NULL) {
+		LOG(ERROR) << "Unable to open " << tmp_filename << " for writing";
+		return false;
+	}
+	infra::save_binary(fp, w_pos);
+	infra::save_binary(fp, w_neg);
+	infra::save_binary(fp, w_pos_sum);
+	infra::save_binary(fp, w_neg_sum);
+	infra::save_binary(fp, num_examples);
+	infra::save_binary(fp, loss);
+	bool ok = (ferror(fp) == 0);
+	ok = (fclose(fp) == 0) && ok;
+	if (!ok || rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+		LOG(ERROR) << "Unable to write " << filename;
+		return false;
+	}
+	return true;
+}
+
+/************************************************************************
+ Function:     MixingState::load
+ 
+ Description:  Load the state from a file
+ Inputs:       string &filename
+ Output:       bool - true on success
+ Comments:     none.
+ ***********************************************************************/
+bool MixingState::load(const string &filename)
+{
+	FILE *fp = fopen(filename.c_str(), "rb");
+	if (fp == NULL) {
+		LOG(ERROR) << "Unable to open " << filename << " for reading";
+		return false;
+	}
+	w_pos.load_binary(fp);
+	w_neg.load_binary(fp);
+	w_pos_sum.load_binary(fp);
+	w_neg_sum.load_binary(fp);
+	infra::load_binary(fp, num_examples);
+	infra::load_binary(fp, loss);
+	bool ok = (ferror(fp) == 0);
+	fclose(fp);
+	if (!ok) {
+		LOG(ERROR) << "Unable to read " << filename;
+	}
+	return ok;
+}
+
+/************************************************************************
+ Function:     ipm_filename
+ 
+ Description:  Name of a file in the parameter mixing directory
+ Inputs:       string &ipm_dir, string name, int number
+ Output:       string - ipm_dir/<name><number>
+ Comments:     none.
+ ***********************************************************************/
+static string ipm_filename(const string &ipm_dir, const string &name, int number)
+{
+	std::ostringstream os;
+	os << ipm_dir << "/" << name << number;
+	return os.str();
+}
+
+/************************************************************************
+ Function:     ipm_shard_filename
+ 
+ Description:  Name of a file of shard k in the parameter mixing directory
+ Inputs:       string &ipm_dir, int shard, string suffix
+ Output:       string - ipm_dir/shard<k><suffix>
+ Comments:     none.
+ ***********************************************************************/
+static string ipm_shard_filename(const string &ipm_dir, int shard, const string &suffix)
+{
+	return ipm_filename(ipm_dir, "shard", shard) + suffix;
+}
+
+/************************************************************************
+ Function:     ipm_wait_for_file
+ 
+ Description:  Block until a file exists
+ Inputs:       string &filename
+               double timeout - seconds, 0 waits forever
+               vector<string> &failed_filenames - a worker that failed
+               creates its file
+               vector<pid_t> &workers - forked workers expected to live
+ Output:       bool - true if the file exists, false on a failure or timeout
+ Comments:     The workers are checked without reaping them.
+ ***********************************************************************/
+static bool ipm_wait_for_file(const string &filename, double timeout,
+															const std::vector<string> &failed_filenames = std::vector<string>(),
+															const std::vector<pid_t> &workers = std::vector<pid_t>())
+{
+	struct stat st;
+	bool reported = false;
+	time_t start = time(NULL);
+	while (stat(filename.c_str(), &st) != 0) {
+		for (unsigned int k = 0; k < failed_filenames.size(); k++) {
+			if (stat(failed_filenames[k].c_str(), &st) == 0) {
+				LOG(ERROR) << "Worker " << k << " failed while waiting for " << filename;
+				return false;
+			}
+		}
+		for (unsigned int k = 0; k < workers.size(); k++) {
+			siginfo_t info;
+			info.si_pid = 0;
+			if (waitid(P_PID, workers[k], &info, WEXITED | WNOHANG | WNOWAIT) == 0 && info.si_pid != 0 &&
+					(info.si_code != CLD_EXITED || info.si_status != EXIT_SUCCESS)) {
+				LOG(ERROR) << "Worker " << k << " died while waiting for " << filename;
+				return false;
+			}
+		}
+		if (timeout > 0 && difftime(time(NULL), start) > timeout) {
+			LOG(ERROR) << "Timed out after " << timeout << " sec waiting for " << filename;
+			return false;
+		}
+		if (!reported) {
+			LOG(DEBUG) << "Waiting for " << filename;
+			reported = true;
+		}
+		usleep(100000);
+	}
+	return true;
+}
+
+/************************************************************************
+ Function:     ipm_split_shards
+ 
+ Description:  Split the training set into K shards, example i goes to
+               shard i mod K
+ Inputs:       string &instances_filelist, string &labels_filename
+               string &ipm_dir, int num_shards
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+static void ipm_split_shards(string &instances_filelist, string &labels_filename,
+														 const string &ipm_dir, int num_shards)
+{
+	StringVector file_list;
+	file_list.read(instances_filelist);
+	
+	std::ifstream ifs_labels(labels_filename.c_str());
+	if (!ifs_labels.good()) {
+		LOG(ERROR) << "Unable to open " << labels_filename << " for reading";
+		exit(-1);
+	}
+	infra::matrix labels(ifs_labels);
+	ifs_labels.close();
+	if (labels.height() != file_list.size() || labels.width() != 2) {
+		LOG(ERROR) << " The width of the matrix in labels file should be " << file_list.size() << "x 2 .";
+		exit(-1);
+	}
+	
+	for (int k = 0; k < num_shards; k++) {
+		std::ofstream ofs_list(ipm_shard_filename(ipm_dir, k, ".features").c_str());
+		std::ofstream ofs_labels(ipm_shard_filename(ipm_dir, k, ".labels").c_str());
+		if (!ofs_list.good() || !ofs_labels.good()) {
+			LOG(ERROR) << "Unable to write shard " << k << " in " << ipm_dir;
+			exit(-1);
+		}
+		unsigned long shard_size = (file_list.size() + num_shards - 1 - k) / num_shards;
+		ofs_labels << shard_size << " 2" << endl;
+		for (unsigned long i = k; i < file_list.size(); i += num_shards) {
+			ofs_list << file_list[i] << endl;
+			ofs_labels << labels(i,0) << " " << labels(i,1) << endl;
+		}
+	}
+}
+
+/************************************************************************
+ Function:     ipm_worker_epoch
+ 
+ Description:  Train one epoch on one shard, starting from the mixed w
+ Inputs:       Classifier &classifier
+               CandidateFeaturesCache &candidate_cache
+               string &ipm_dir, int shard, int epoch
+               string &training_method, bool vot_loss, bool pos_only
+ Output:       bool - true on success
+ Comments:     none.
+ ***********************************************************************/
+static bool ipm_worker_epoch(Classifier &classifier, CandidateFeaturesCache &candidate_cache,
+														 const string &ipm_dir, int shard, int epoch,
+														 const string &training_method, bool vot_loss, bool pos_only)
+{
+	MixingState state(classifier.get_kernel_phi_size_pos(), classifier.get_phi_size_neg());
+	if (!state.load(ipm_filename(ipm_dir, "mixed.", epoch)))
+		return false;
+	classifier.set_w(state.w_pos, state.w_neg);
+	classifier.reset_averaging();
+	
+	string shard_filelist = ipm_shard_filename(ipm_dir, shard, ".features");
+	string shard_labels = ipm_shard_filename(ipm_dir, shard, ".labels");
+	Dataset shard_dataset(shard_filelist, shard_labels);
+	
+	state.loss = 0.0;
+	for (uint i = 0; i < shard_dataset.size(); i++) {
+		TrainingBatch batch;
+		batch.classifier = &classifier;
+		batch.candidate_cache = &candidate_cache;
+		batch.training_method = training_method;
+		batch.first_index = i;
+		batch.first_epoch = (epoch == 0);
+		batch.vot_loss = vot_loss;
+		batch.pos_only = pos_only;
+		batch.x.resize(1);
+		batch.y.resize(1);
+		batch.y_hat.resize(1);
+		shard_dataset.read(batch.x[0], batch.y[0]);
+		predict_batch(&batch, 0, 1);
+		state.loss += classifier.update(batch.x[0], batch.y[0], batch.y_hat[0], vot_loss);
+	}
+	state.num_examples = shard_dataset.size();
+	classifier.get_w(state.w_pos, state.w_neg);
+	classifier.get_w_sum(state.w_pos_sum, state.w_neg_sum);
+	
+	return state.save(ipm_shard_filename(ipm_dir, shard, "." + std::to_string(epoch)));
+}
+
+/************************************************************************
+ Function:     ipm_run_worker
+ 
+ Description:  Parameter mixing worker of one shard, for all the epochs
+ Inputs:       Classifier &classifier
+               CandidateFeaturesCache &candidate_cache
+               string &ipm_dir, int shard, int num_epochs, double timeout
+               string &training_method, bool vot_loss, bool pos_only
+ Output:       bool - true on success
+ Comments:     The worker lives across the epochs, so its candidate cache
+               is reused. On a failure it creates shard<k>.failed for the
+               coordinator.
+ ***********************************************************************/
+static bool ipm_run_worker(Classifier &classifier, CandidateFeaturesCache &candidate_cache,
+											 const string &ipm_dir, int shard, int num_epochs, double timeout,
+											 const string &training_method, bool vot_loss, bool pos_only)
+{
+	for (int epoch = 0; epoch < num_epochs; epoch++) {
+		if (!ipm_wait_for_file(ipm_filename(ipm_dir, "mixed.", epoch), timeout) ||
+				!ipm_worker_epoch(classifier, candidate_cache, ipm_dir, shard, epoch,
+													training_method, vot_loss, pos_only)) {
+			std::ofstream ofs(ipm_shard_filename(ipm_dir, shard, ".failed").c_str());
+			return false;
+		}
+	}
+	return true;
+}
+
+/************************************************************************
+ Function:     ipm_stop_workers
+ 
+ Description:  Terminate and reap forked workers
+ Inputs:       vector<pid_t> &workers
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+static void ipm_stop_workers(const std::vector<pid_t> &workers)
+{
+	for (unsigned int k = 0; k < workers.size(); k++) {
+		kill(workers[k], SIGTERM);
+		waitpid(workers[k], NULL, 0);
+	}
+}
+
+/************************************************************************
+ Function:     train_parameter_mixing
+ 
+ Description:  Coordinator of iterative parameter mixing
+ Inputs:       Classifier &classifier - initial classifier
+               int num_shards, int num_epochs
+               string &ipm_dir - directory shared with the workers
+               bool spawn_workers - fork the workers, or wait for workers
+               started with -ipm_worker
+               double timeout - seconds to wait for a worker, 0 forever
+               ... training options as in main
+ Output:       int - EXIT_SUCCESS or EXIT_FAILURE
+ Comments:     Without a validation set the saved classifier is the mean of
+               all the w_i of all the workers in all the epochs. With a
+               validation set it is the mixed w with the lowest validation
+               loss.
+ ***********************************************************************/
+static int train_parameter_mixing(Classifier &classifier, CandidateFeaturesCache &candidate_cache,
+																	int num_shards, int num_epochs, const string &ipm_dir, bool spawn_workers,
+																	double timeout,
+																	string &train_instances_filelist, string &train_labels_filename,
+																	string &val_instances_filelist, string &val_labels_filename,
+																	string &classifier_filename, const string &training_method,
+																	bool vot_loss, bool pos_only)
+{
+	mkdir(ipm_dir.c_str(), 0777);
+	// files left by an interrupted run must not start the workers early
+	for (int epoch = 0; epoch < num_epochs; epoch++) {
+		unlink(ipm_filename(ipm_dir, "mixed.", epoch).c_str());
+		for (int k = 0; k < num_shards; k++)
+			unlink(ipm_shard_filename(ipm_dir, k, "." + std::to_string(epoch)).c_str());
+	}
+	std::vector<string> failed_filenames;
+	for (int k = 0; k < num_shards; k++) {
+		failed_filenames.push_back(ipm_shard_filename(ipm_dir, k, ".failed"));
+		unlink(failed_filenames[k].c_str());
+	}
+	ipm_split_shards(train_instances_filelist, train_labels_filename, ipm_dir, num_shards);
+	
+	int pos_dim = classifier.get_kernel_phi_size_pos();
+	int neg_dim = classifier.get_phi_size_neg();
+	MixingState mixed(pos_dim, neg_dim);
+	classifier.get_w(mixed.w_pos, mixed.w_neg);
+	
+	// sum of the w_i of all workers and epochs
+	infra::vector w_pos_sum(pos_dim);
+	infra::vector w_neg_sum(neg_dim);
+	w_pos_sum.zeros();
+	w_neg_sum.zeros();
+	double num_training_examples = 0.0;
+	double best_validation_loss = 1e100;
+	
+	// the workers are started once and train all the epochs
+	std::vector<pid_t> workers;
+	if (spawn_workers) {
+		for (int k = 0; k < num_shards; k++) {
+			pid_t pid = fork();
+			if (pid < 0) {
+				LOG(ERROR) << "Unable to start worker " << k;
+				ipm_stop_workers(workers);
+				return EXIT_FAILURE;
+			}
+			if (pid == 0) {
+				bool ok = ipm_run_worker(classifier, candidate_cache, ipm_dir, k, num_epochs, timeout,
+														 training_method, vot_loss, pos_only);
+				_exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+			}
+			workers.push_back(pid);
+		}
+	}
+	auto fail = [&]() {
+		ipm_stop_workers(workers);
+		return EXIT_FAILURE;
+	};
+	
+	for (int epoch = 0; epoch < num_epochs; epoch++) {
+		
+		if (!mixed.save(ipm_filename(ipm_dir, "mixed.", epoch)))
+			return fail();
+		
+		// mix the weights of the workers
+		mixed.w_pos.zeros();
+		mixed.w_neg.zeros();
+		mixed.num_examples = 0.0;
+		mixed.loss = 0.0;
+		for (int k = 0; k < num_shards; k++) {
+			string shard_result = ipm_shard_filename(ipm_dir, k, "." + std::to_string(epoch));
+			if (!ipm_wait_for_file(shard_result, timeout, failed_filenames, workers))
+				return fail();
+			MixingState state(pos_dim, neg_dim);
+			if (!state.load(shard_result))
+				return fail();
+			state.w_pos *= state.num_examples;
+			state.w_neg *= state.num_examples;
+			mixed.w_pos += state.w_pos;
+			mixed.w_neg += state.w_neg;
+			w_pos_sum += state.w_pos_sum;
+			w_neg_sum += state.w_neg_sum;
+			mixed.num_examples += state.num_examples;
+			mixed.loss += state.loss;
+			unlink(shard_result.c_str());
+		}
+		unlink(ipm_filename(ipm_dir, "mixed.", epoch).c_str());
+		if (mixed.num_examples == 0.0) {
+			LOG(ERROR) << "No training examples in the shards";
+			return fail();
+		}
+		mixed.w_pos /= mixed.num_examples;
+		mixed.w_neg /= mixed.num_examples;
+		num_training_examples += mixed.num_examples;
+		classifier.set_w(mixed.w_pos, mixed.w_neg);
+		
+		LOG(INFO) << "Epoch " << epoch << ": average loss over " << num_shards << " shards = "
+		<< mixed.loss/mixed.num_examples;
+		
+		if (val_instances_filelist != "") {
+			double this_w_loss = validation_loss(classifier, val_instances_filelist,
+																					 val_labels_filename, pos_only);
+			if (this_w_loss <= best_validation_loss) {
+				best_validation_loss = this_w_loss;
+				classifier.save(classifier_filename);
+			}
+			LOG(INFO) << "Epoch " << epoch << ": validation error = " << this_w_loss
+			<< ", best validation loss  = " << best_validation_loss;
+		}
+	}
+	
+	for (int k = 0; k < int(workers.size()); k++) {
+		int status;
+		if (waitpid(workers[k], &status, 0) < 0 || !WIFEXITED(status) ||
+				WEXITSTATUS(status) != EXIT_SUCCESS) {
+			LOG(ERROR) << "Worker " << k << " failed";
+			return EXIT_FAILURE;
+		}
+	}
+	
+	if (val_instances_filelist == "") {
+		// make w the mean of the w_i, over all workers and epochs
+		w_pos_sum /= num_training_examples;
+		w_neg_sum /= num_training_examples;
+		classifier.set_w(w_pos_sum, w_neg_sum);
+		classifier.save(classifier_filename);
+	}
+	
+	return EXIT_SUCCESS;
+}
+
 /************************************************************************
  Function:     main
  
@@ -62,6 +607,7 @@ int main(int argc, char **argv)
 	string val_labels_filename;
 	string classifier_filename;
 	string ignore_features_str;
+	string voicing_tracker;
 	string training_method;
 	string init_classifier;
 	double epsilon = 0.0;
@@ -69,6 +615,17 @@ int main(int argc, char **argv)
 	bool pos_only;
 	string kernel_expansion_name;
 	double sigma;
+	double cache_mb;
+	string cache_dir;
+	unsigned int num_threads;
+	unsigned int batch_size;
+	int ipm_shards;
+	int ipm_worker;
+	string ipm_dir;
+	bool ipm_external;
+	double ipm_timeout;
+	bool binary_model;
+	string profile_filename;
 	string verbose;
 	
 	learning::cmd_line cmdline;
@@ -84,6 +641,8 @@ int main(int argc, char **argv)
 	cmdline.add("-ep_on", "epsilon parameter of the onset loss", &loss_ep_on, 10.0);
 	cmdline.add("-ep_off", "epsilon parameter of the offset loss", &loss_ep_off, 1.0);
 	cmdline.add("-ignore_features", "ignore the following features. E.g., \"3,7,19\".", &ignore_features_str, "");
+	cmdline.add("-voicing_tracker", "voicing tracker the features were extracted with, 'rapt' or 'yin', "
+							"stored in a binary model [rapt]", &voicing_tracker, "rapt");
 	cmdline.add("-direct_loss", "use direct-loss update with the given epsilon [0.0]", &epsilon, 0.0);
 	cmdline.add("-vot_loss", "use the VOT loss instead of alignment loss", &vot_loss, false);
 	cmdline.add("-training_method", "PA, Pegasos, Perceptron, DirectLossMin", &training_method, "PA");
@@ -92,6 +651,17 @@ int main(int argc, char **argv)
   cmdline.add("-kernel_expansion", "use kernel expansion of type 'poly2' or 'rbf2'",
               &kernel_expansion_name, "");
   cmdline.add("-sigma", "if kernel is rbf2 or rbf3 this is the sigma", &sigma, 1.0);
+	cmdline.add("-cache_mb", "cache candidate features across epochs, up to this size in MB (PA only) [0]", &cache_mb, 0.0);
+	cmdline.add("-cache_dir", "keep the candidate features cache in memory mapped files in this directory", &cache_dir, "");
+	cmdline.add("-threads", "number of threads for loss-augmented inference [1]", &num_threads, 1);
+	cmdline.add("-batch", "number of examples predicted with the same w before updating [threads]", &batch_size, 0);
+	cmdline.add("-ipm_shards", "train with iterative parameter mixing over this many shards [0]", &ipm_shards, 0);
+	cmdline.add("-ipm_dir", "directory for the files exchanged by parameter mixing [<classifier_filename>.ipm]", &ipm_dir, "");
+	cmdline.add("-ipm_external", "do not start the parameter mixing workers, wait for workers started with -ipm_worker", &ipm_external, false);
+	cmdline.add("-ipm_worker", "run as parameter mixing worker of the given shard (0..ipm_shards-1)", &ipm_worker, -1);
+	cmdline.add("-ipm_timeout", "seconds to wait for a parameter mixing file before failing, 0 waits forever [3600]", &ipm_timeout, 3600.0);
+	cmdline.add("-binary_model", "save a single binary model file, with the training options, instead of .pos/.neg", &binary_model, false);
+	cmdline.add("-profile", "write the time spent in each stage as JSON to the given file (- for stderr)", &profile_filename, "");
 	cmdline.add("-verbose", "log reporting level [ERROR, WARNING, INFO, or DEBUG]", &verbose, "INFO");
 	cmdline.add_master_option("train_instances_filelist", &train_instances_filelist);
 	cmdline.add_master_option("train_labels_filename", &train_labels_filename);
@@ -104,6 +674,9 @@ int main(int argc, char **argv)
 	
 	Log::ReportingLevel() = Log::FromString(verbose);
 	Log::ExecutableName() = basename(argv[0]);
+	Log::Asynchronous() = true;
+	if (profile_filename != "")
+		Profiler::enable(basename(argv[0]), profile_filename);
 	
 	// Initiate classifier
 	Classifier classifier(min_vot_length, max_vot_length, max_onset_time, C,
@@ -118,9 +691,88 @@ int main(int argc, char **argv)
 		classifier.ignore_features(ignore_features_str);
 	}
 	
+	if (voicing_tracker != "rapt" && voicing_tracker != "yin") {
+		LOG(ERROR) << "Unknown voicing tracker " << voicing_tracker;
+		return EXIT_FAILURE;
+	}
+
 	if (training_method != "") {
 		LOG(DEBUG) << "Training method is " << training_method;
 	}
+	if (training_method == "") {
+		training_method = "Perceptron";
+	}
+	else if (training_method != "PA" && training_method != "Perceptron") {
+		LOG(ERROR) << "Unsupported training method";
+		return EXIT_FAILURE;
+	}
+	
+	if (binary_model) {
+		// the options VotDecode needs, and how the model was trained
+		ModelInfo info;
+		info.kernel_expansion = kernel_expansion_name;
+		info.sigma = sigma;
+		info.pos_only = pos_only;
+		info.ignore_features = ignore_features_str;
+		info.voicing_tracker = voicing_tracker;
+		info.min_vot_length = min_vot_length;
+		info.max_vot_length = max_vot_length;
+		info.max_onset = max_onset_time;
+		std::ostringstream C_str, loss_eps_str, ep_on_str, ep_off_str;
+		C_str << C;
+		loss_eps_str << loss_epsilon;
+		ep_on_str << loss_ep_on;
+		ep_off_str << loss_ep_off;
+		info.metadata["training_method"] = training_method;
+		info.metadata["epochs"] = std::to_string(num_epochs);
+		info.metadata["C"] = C_str.str();
+		info.metadata["loss_eps"] = loss_eps_str.str();
+		info.metadata["ep_on"] = ep_on_str.str();
+		info.metadata["ep_off"] = ep_off_str.str();
+		info.metadata["vot_loss"] = vot_loss ? "1" : "0";
+		info.metadata["train_instances_filelist"] = train_instances_filelist;
+		info.metadata["train_labels_filename"] = train_labels_filename;
+		if (init_classifier != "")
+			info.metadata["load_classifier"] = init_classifier;
+		char date[64];
+		time_t now = time(NULL);
+		strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime(&now));
+		info.metadata["date"] = date;
+		classifier.set_model_info(info);
+	}
+	
+	if (num_threads < 1) num_threads = 1;
+	if (batch_size < 1) batch_size = num_threads;
+	if (batch_size > 1) {
+		LOG(INFO) << "Mini-batches of " << batch_size << " examples on " << num_threads << " threads.";
+	}
+	
+	// features of the candidates of each training example, reused in later epochs
+	CandidateFeaturesCache candidate_cache(num_epochs > 1 ? cache_mb : 0.0, cache_dir);
+	
+	if (ipm_dir == "") ipm_dir = classifier_filename + ".ipm";
+	if (ipm_worker >= 0) {
+		if (ipm_worker >= ipm_shards) {
+			LOG(ERROR) << "Worker " << ipm_worker << " is not one of the " << ipm_shards << " shards";
+			return EXIT_FAILURE;
+		}
+		if (!ipm_run_worker(classifier, candidate_cache, ipm_dir, ipm_worker, num_epochs, ipm_timeout,
+												training_method, vot_loss, pos_only))
+			return EXIT_FAILURE;
+		LOG(INFO) << "Worker " << ipm_worker << " completed.";
+		return EXIT_SUCCESS;
+	}
+	if (ipm_shards > 0) {
+		LOG(INFO) << "Iterative parameter mixing over " << ipm_shards << " shards in " << ipm_dir << ".";
+		int rc = train_parameter_mixing(classifier, candidate_cache, ipm_shards, num_epochs, ipm_dir,
+																		!ipm_external, ipm_timeout, train_instances_filelist, train_labels_filename,
+																		val_instances_filelist, val_labels_filename, classifier_filename,
+																		training_method, vot_loss, pos_only);
+		if (rc == EXIT_SUCCESS) {
+			LOG(INFO) << "Training completed.";
+		}
+		return rc;
+	}
 	
 	double loss;
 	double cum_loss = 0.0;
@@ -138,79 +790,73 @@ int main(int argc, char **argv)
 		
 		num_training_examples += training_dataset.size();
 		
-		// Run over all dataset
-		for (uint i=0; i <  training_dataset.size(); i++) {
+		// Run over all dataset, batch_size examples at a time. All the examples
+		// of a batch are predicted with the same w, then the updates are applied
+		// in order. With a batch of one example this is the online algorithm.
+		for (uint batch_start = 0; batch_start < training_dataset.size(); batch_start += batch_size) {
 			
-			SpeechUtterance x;
-			VotLocation y;
+			TrainingBatch batch;
+			batch.classifier = &classifier;
+			batch.candidate_cache = &candidate_cache;
+			batch.training_method = training_method;
+			batch.first_index = batch_start;
+			batch.first_epoch = (epoch == 0);
+			batch.vot_loss = vot_loss;
+			batch.pos_only = pos_only;
 			
-			LOG(DEBUG) << "=========================================================================";
+			uint this_batch_size = std::min(batch_size, uint(training_dataset.size() - batch_start));
+			batch.x.resize(this_batch_size);
+			batch.y.resize(this_batch_size);
+			batch.y_hat.resize(this_batch_size);
 			
-			// read next example for dataset
-			training_dataset.read(x, y);
+			// read next examples for dataset
+			for (uint b = 0; b < this_batch_size; b++)
+				training_dataset.read(batch.x[b], batch.y[b]);
 			
-			if (training_method == "PA") {
-				// predict for large-margin (epsilon=1.0)
-				VotLocation y_hat_loss;
-				classifier.predict_epsilon(x, y_hat_loss, y, -1.0, vot_loss, pos_only);
-				loss = classifier.update(x, y, y_hat_loss, vot_loss);
-			}
-			//      else if (training_method == "Pegasos") {
-			//        // predict for large-margin (epsilon=1.0)
-			//        VotLocation y_hat_loss;
-			//        classifier.predict_epsilon(x, y_hat_loss, y, 1.0, vot_loss);
-			//        loss = classifier.update_pegasos(x, y, y_hat_loss);
-			//      }
-			//      else if (training_method == "DirectLossMin") {
-			//        // predict for direct-loss if epsilon is given (not zero)
-			//        VotLocation y_hat_eps;
-			//        classifier.predict_epsilon(x, y_hat_eps, y, epsilon, vot_loss);
-			//        VotLocation y_hat;
-			//        classifier.predict(x, y_hat);
-			//        loss = classifier.update_direct_loss(x, y_hat_eps, y_hat, y, epsilon);
-			//      }
-			else if (training_method == "Perceptron" || training_method == "") {
-				VotLocation y_hat;
-				classifier.predict(x, y_hat, pos_only);
-				loss = classifier.update(x, y, y_hat, vot_loss);
+			uint this_num_threads = std::min(num_threads, this_batch_size);
+			if (this_num_threads == 1) {
+				predict_batch(&batch, 0, 1);
 			}
 			else {
-				LOG(ERROR) << "Unsupported training method";
-				return EXIT_FAILURE;
+				std::vector<std::thread> workers;
+				for (uint t = 0; t < this_num_threads; t++)
+					workers.push_back(std::thread(predict_batch, &batch, t, this_num_threads));
+				for (uint t = 0; t < this_num_threads; t++)
+					workers[t].join();
 			}
 			
-			cum_loss += loss;
-			
-			if (max_loss_in_epoch < loss) max_loss_in_epoch = loss;
-			avg_loss_in_epoch += loss;
+			for (uint b = 0; b < this_batch_size; b++) {
 			
-			// now, check the validations error
-			if ( val_instances_filelist != "" && classifier.was_changed() ) {
-				LOG(DEBUG) << "Validation...";
-				Dataset val_dataset(val_instances_filelist, val_labels_filename);
-				double this_w_loss = 0.0;
-				for (uint ii=0; ii < val_dataset.size(); ++ii) {
-					SpeechUtterance xx;
-					VotLocation yy;
-					VotLocation yy_hat;
-					val_dataset.read(xx, yy);
-					classifier.predict(xx, yy_hat, pos_only);
-					int onset_loss = abs(yy.voice - yy_hat.voice);
-					int offset_loss = abs(yy.burst - yy_hat.burst);
-					this_w_loss += onset_loss+offset_loss;
-				}
-				this_w_loss /= val_dataset.size();
-				if (this_w_loss <= best_validation_loss) {
-					best_validation_loss = this_w_loss;
-					classifier.save(classifier_filename);
+				uint i = batch_start + b;
+				
+				LOG(DEBUG) << "=========================================================================";
+				
+				// only the first prediction of the batch was made with the current w
+				loss = classifier.update(batch.x[b], batch.y[b], batch.y_hat[b], vot_loss, b > 0);
+				
+				cum_loss += loss;
+				
+				if (max_loss_in_epoch < loss) max_loss_in_epoch = loss;
+				avg_loss_in_epoch += loss;
+				
+				// now, check the validations error
+				if ( val_instances_filelist != "" && classifier.was_changed() ) {
+					LOG(DEBUG) << "Validation...";
+					double this_w_loss = validation_loss(classifier, val_instances_filelist,
+																							 val_labels_filename, pos_only);
+					if (this_w_loss <= best_validation_loss) {
+						best_validation_loss = this_w_loss;
+						classifier.save(classifier_filename);
+					}
+					LOG(DEBUG) << "i = " << i << ", this validation error = " << this_w_loss
+					<< ", best validation loss  = " << best_validation_loss;
+					
+					// stopping criterion for iterate until convergence
+					//        if (best_validation_loss < 1.0)
+					//          break;
 				}
-				LOG(DEBUG) << "i = " << i << ", this validation error = " << this_w_loss
-				<< ", best validation loss  = " << best_validation_loss;
 				
-				// stopping criterion for iterate until convergence
-				//        if (best_validation_loss < 1.0)
-				//          break;
-			}
+			} // end running over the batch
 			
 		} // end running over the dataset
 		
@@ -228,6 +874,9 @@ int main(int argc, char **argv)
 		LOG(DEBUG) << "Did not save the averaged classifier";
 	}
 	
+	if (candidate_cache.enabled()) {
+		LOG(INFO) << "Candidate features cache used " << candidate_cache.size_in_bytes()/(1024*1024) << " MB.";
+	}
 	LOG(INFO) << "Training completed.";
 	
 	return EXIT_SUCCESS;
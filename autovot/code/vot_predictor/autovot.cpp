@@ -0,0 +1,588 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   libautovot
+ Purpose:  C interface to the front end and the decoder
+ Date:     19 Oct., 2026
+
+ **************************** INCLUDE FILES *****************************/
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <new>
+#include "autovot.h"
+#include "Classifier.h"
+#include "Dataset.h"
+#include "FrontEnd.h"
+#include "IncrementalDecoder.h"
+
+// The state of a loaded model. Everything the library keeps lives here.
+struct autovot_model
+{
+	Classifier *classifier;
+	bool pos_only;
+	bool text_precision;
+	int min_vot_length;
+};
+
+// A decoder of a stream of samples
+struct autovot_stream
+{
+	IncrementalDecoder *decoder;
+};
+
+/************************************************************************
+ Function:     check_window
+
+ Description:  Check a window against the length of the signal
+ Inputs:       long num_samples, double sampling_rate
+               double window_start
+               double &window_end - -1 is replaced by the end of the signal
+ Output:       int - AUTOVOT_OK or an error code
+ Comments:     Same checks as VotFrontEnd2. The duration is rounded to
+               the millisecond, so window_end may be up to half a
+               millisecond past the last sample: extract_features()
+               reads only the samples of the signal.
+ ***********************************************************************/
+static int check_window(long num_samples, double sampling_rate,
+												double window_start, double &window_end)
+{
+	if (num_samples <= 0 || sampling_rate <= 0)
+		return AUTOVOT_ERR_ARGUMENT;
+	if (window_end == -1)
+		window_end = (num_samples-1)/double(sampling_rate);
+	// round the duration up to 3 figures after the point
+	double duration = round(1000*num_samples/double(sampling_rate))/1000.0;
+	if (window_start < 0 || window_end <= window_start || window_end > duration)
+		return AUTOVOT_ERR_WINDOW;
+	return AUTOVOT_OK;
+}
+
+/************************************************************************
+ Function:     extract
+
+ Description:  Extract the features of a window
+ Inputs:       see autovot_extract_features
+               infra::matrix &features - NUM_FEATURES x frames output
+ Output:       int - AUTOVOT_OK or an error code
+ Comments:     none.
+ ***********************************************************************/
+static int extract(const double *samples, long num_samples, double sampling_rate,
+									 double window_start, double window_end, int normalize,
+									 infra::matrix &features)
+{
+	if (samples == NULL)
+		return AUTOVOT_ERR_ARGUMENT;
+	int rc = check_window(num_samples, sampling_rate, window_start, window_end);
+	if (rc != AUTOVOT_OK)
+		return rc;
+
+	infra::vector x(num_samples);
+	for (long i=0; i < num_samples; i++)
+		x[i] = samples[i];
+	infra::vector frame_times;
+	int first_frame;
+	if (!extract_features(x, sampling_rate, window_start, window_end, normalize != 0,
+												features, frame_times, first_frame))
+		return AUTOVOT_ERR_WINDOW;
+
+	return AUTOVOT_OK;
+}
+
+/************************************************************************
+ Function:     copy_features
+
+ Description:  Copy a features matrix into a frame-major buffer
+ Inputs:       infra::matrix &features - NUM_FEATURES x frames
+               double *buffer - frames x NUM_FEATURES
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+static void copy_features(const infra::matrix &features, double *buffer)
+{
+	for (unsigned long j=0; j < features.width(); j++)
+		for (unsigned long k=0; k < features.height(); k++)
+			buffer[j*features.height()+k] = features(k,j);
+}
+
+extern "C" {
+
+int autovot_api_version(void)
+{
+	return AUTOVOT_API_VERSION;
+}
+
+const char *autovot_strerror(int code)
+{
+	switch (code) {
+		case AUTOVOT_OK: return "no error";
+		case AUTOVOT_ERR_ARGUMENT: return "invalid argument";
+		case AUTOVOT_ERR_FILE: return "unable to read file";
+		case AUTOVOT_ERR_MODEL: return "model does not match the options";
+		case AUTOVOT_ERR_WINDOW: return "window is outside of the signal or too short";
+		case AUTOVOT_ERR_BUFFER: return "buffer is too small";
+		case AUTOVOT_ERR_MEMORY: return "out of memory";
+	}
+	return "unknown error";
+}
+
+/************************************************************************
+ Function:     autovot_default_options
+
+ Description:  Fill the options with the defaults of VotDecode
+ Inputs:       autovot_options *options
+ Output:       none.
+ Comments:     none.
+ ***********************************************************************/
+void autovot_default_options(autovot_options *options)
+{
+	if (options == NULL)
+		return;
+	options->min_vot_length = 15;
+	options->max_vot_length = 200;
+	options->max_onset = 150;
+	options->pos_only = 0;
+	options->kernel_expansion = "";
+	options->sigma = 1.0;
+	options->ignore_features = "";
+	options->text_precision = 1;
+}
+
+/************************************************************************
+ Function:     autovot_model_load
+
+ Description:  Load a classifier
+ Inputs:       const char *classifier_filename - without .pos/.neg, or
+               a binary model file
+               autovot_options *options - NULL for the defaults
+               autovot_model **model - the loaded model
+ Output:       int - AUTOVOT_OK or an error code
+ Comments:     Everything the Classifier would exit on is checked first.
+               A binary model of features of another voicing tracker
+               than RAPT is refused, as the library has no other.
+ ***********************************************************************/
+int autovot_model_load(const char *classifier_filename,
+											 const autovot_options *options, autovot_model **model)
+{
+	if (classifier_filename == NULL || model == NULL)
+		return AUTOVOT_ERR_ARGUMENT;
+	*model = NULL;
+
+	autovot_options defaults;
+	autovot_default_options(&defaults);
+	if (options == NULL)
+		options = &defaults;
+
+	std::string filename = classifier_filename;
+	autovot_options model_options = *options;
+	std::string kernel_name = options->kernel_expansion ? options->kernel_expansion : "";
+	std::string ignore_features_str = options->ignore_features ? options->ignore_features : "";
+	long pos_size = -1, neg_size = -1;
+	if (is_model_file(filename)) {
+		// a binary model is decoded with the options it was trained with,
+		// except those the caller changed from the defaults, as the options
+		// given on the command line of VotDecode
+		ModelInfo info;
+		if (!read_model_file(filename, info))
+			return AUTOVOT_ERR_MODEL;
+		// the features of the library and of its streams are those of RAPT
+		VoicingTracker voicing_tracker;
+		if (!parse_voicing_tracker(info.voicing_tracker, voicing_tracker) ||
+				voicing_tracker != VOICING_RAPT)
+			return AUTOVOT_ERR_MODEL;
+		if (options->min_vot_length == defaults.min_vot_length)
+			model_options.min_vot_length = info.min_vot_length;
+		if (options->max_vot_length == defaults.max_vot_length)
+			model_options.max_vot_length = info.max_vot_length;
+		if (options->max_onset == defaults.max_onset)
+			model_options.max_onset = info.max_onset;
+		if (options->pos_only == defaults.pos_only)
+			model_options.pos_only = info.pos_only;
+		if (options->sigma == defaults.sigma)
+			model_options.sigma = info.sigma;
+		if (kernel_name == "")
+			kernel_name = info.kernel_expansion;
+		if (ignore_features_str == "")
+			ignore_features_str = info.ignore_features;
+		pos_size = info.phi_pos_size;
+		neg_size = info.phi_neg_size;
+	}
+	else {
+		// each file starts with the number of weights
+		std::ifstream ifs_pos((filename + ".pos").c_str());
+		std::ifstream ifs_neg((filename + ".neg").c_str());
+		if (!ifs_pos.good() || !ifs_neg.good())
+			return AUTOVOT_ERR_FILE;
+		ifs_pos >> pos_size;
+		ifs_neg >> neg_size;
+		ifs_pos.close();
+		ifs_neg.close();
+	}
+	options = &model_options;
+
+	if (kernel_name != "" && kernel_name != "none" && kernel_name != "poly2" &&
+			kernel_name != "rbf2" && kernel_name != "rbf3")
+		return AUTOVOT_ERR_ARGUMENT;
+
+	autovot_model *m = new (std::nothrow) autovot_model;
+	if (m == NULL)
+		return AUTOVOT_ERR_MEMORY;
+	m->classifier = NULL;
+	m->pos_only = (options->pos_only != 0);
+	m->text_precision = (options->text_precision != 0);
+	m->min_vot_length = options->min_vot_length;
+	try {
+		m->classifier = new Classifier(options->min_vot_length, options->max_vot_length,
+																	 options->max_onset, 0.0, 0.0, 0.0, 0.0,
+																	 kernel_name, options->sigma);
+		Classifier &classifier = *m->classifier;
+
+		if (ignore_features_str != "") {
+			int phi_size = classifier.get_kernel_phi_size_pos() + classifier.get_phi_size_neg();
+			std::istringstream is(ignore_features_str);
+			std::string token;
+			while (std::getline(is, token, ',')) {
+				char *end;
+				long feature_num = strtol(token.c_str(), &end, 10);
+				if (end == token.c_str() || feature_num < 0 || feature_num >= phi_size) {
+					delete m->classifier;
+					delete m;
+					return AUTOVOT_ERR_ARGUMENT;
+				}
+			}
+			classifier.ignore_features(ignore_features_str);
+		}
+
+		// the sizes are not checked when the weights are read
+		if (pos_size != classifier.get_kernel_phi_size_pos() ||
+				neg_size != classifier.get_phi_size_neg()) {
+			delete m->classifier;
+			delete m;
+			return AUTOVOT_ERR_MODEL;
+		}
+		classifier.load(filename);
+	}
+	catch (...) {
+		delete m->classifier;
+		delete m;
+		return AUTOVOT_ERR_MODEL;
+	}
+
+	*model = m;
+	return AUTOVOT_OK;
+}
+
+void autovot_model_free(autovot_model *model)
+{
+	if (model == NULL)
+		return;
+	delete model->classifier;
+	delete model;
+}
+
+/************************************************************************
+ Function:     autovot_window_frames
+
+ Description:  Number of frames of the features of a window
+ Inputs:       long num_samples, double sampling_rate
+               double window_start, window_end - in seconds
+               long *num_frames - the number of frames
+ Output:       int - AUTOVOT_OK or an error code
+ Comments:     none.
+ ***********************************************************************/
+int autovot_window_frames(long num_samples, double sampling_rate,
+													double window_start, double window_end, long *num_frames)
+{
+	if (num_frames == NULL)
+		return AUTOVOT_ERR_ARGUMENT;
+	int rc = check_window(num_samples, sampling_rate, window_start, window_end);
+	if (rc != AUTOVOT_OK)
+		return rc;
+
+	infra::vector frame_times;
+	int first_frame, last_frame;
+	if (!window_frames(num_samples, sampling_rate, window_start, window_end,
+										 frame_times, first_frame, last_frame))
+		return AUTOVOT_ERR_WINDOW;
+	*num_frames = last_frame - first_frame + 1;
+
+	return AUTOVOT_OK;
+}
+
+/************************************************************************
+ Function:     autovot_extract_features
+
+ Description:  Extract the features of a window into a caller buffer
+ Inputs:       const double *samples, long num_samples - the signal
+               double sampling_rate
+               double window_start, window_end - in seconds
+               int normalize - z-score the features (as VotFrontEnd2)
+               double *features - frames x AUTOVOT_NUM_FEATURES buffer
+               long capacity - frames the buffer can hold
+               long *num_frames - frames written (or needed)
+ Output:       int - AUTOVOT_OK or an error code
+ Comments:     none.
+ ***********************************************************************/
+int autovot_extract_features(const double *samples, long num_samples,
+														 double sampling_rate, double window_start,
+														 double window_end, int normalize,
+														 double *features, long capacity, long *num_frames)
+{
+	if (num_frames == NULL)
+		return AUTOVOT_ERR_ARGUMENT;
+	int rc = autovot_window_frames(num_samples, sampling_rate, window_start, window_end,
+																 num_frames);
+	if (rc != AUTOVOT_OK)
+		return rc;
+	if (features == NULL || capacity < *num_frames)
+		return AUTOVOT_ERR_BUFFER;
+
+	try {
+		infra::matrix m;
+		rc = extract(samples, num_samples, sampling_rate, window_start, window_end,
+								 normalize, m);
+		if (rc != AUTOVOT_OK)
+			return rc;
+		copy_features(m, features);
+	}
+	catch (std::bad_alloc&) {
+		return AUTOVOT_ERR_MEMORY;
+	}
+	catch (...) {
+		return AUTOVOT_ERR_WINDOW;
+	}
+
+	return AUTOVOT_OK;
+}
+
+/************************************************************************
+ Function:     autovot_extract_features_alloc
+
+ Description:  Extract the features of a window into a library buffer
+ Inputs:       as autovot_extract_features
+               double **features - the buffer, freed by autovot_free
+ Output:       int - AUTOVOT_OK or an error code
+ Comments:     none.
+ ***********************************************************************/
+int autovot_extract_features_alloc(const double *samples, long num_samples,
+																	 double sampling_rate, double window_start,
+																	 double window_end, int normalize,
+																	 double **features, long *num_frames)
+{
+	if (features == NULL || num_frames == NULL)
+		return AUTOVOT_ERR_ARGUMENT;
+	*features = NULL;
+
+	try {
+		infra::matrix m;
+		int rc = extract(samples, num_samples, sampling_rate, window_start, window_end,
+										 normalize, m);
+		if (rc != AUTOVOT_OK)
+			return rc;
+		double *buffer = (double*)malloc(m.width()*m.height()*sizeof(double));
+		if (buffer == NULL)
+			return AUTOVOT_ERR_MEMORY;
+		copy_features(m, buffer);
+		*features = buffer;
+		*num_frames = m.width();
+	}
+	catch (std::bad_alloc&) {
+		return AUTOVOT_ERR_MEMORY;
+	}
+	catch (...) {
+		return AUTOVOT_ERR_WINDOW;
+	}
+
+	return AUTOVOT_OK;
+}
+
+void autovot_free(void *buffer)
+{
+	free(buffer);
+}
+
+/************************************************************************
+ Function:     autovot_decode
+
+ Description:  Predict the VOT of a window
+ Inputs:       autovot_model *model
+               const double *features - frames x AUTOVOT_NUM_FEATURES
+               long num_frames
+               autovot_prediction *prediction - the predicted VOT
+ Output:       int - AUTOVOT_OK or an error code
+ Comments:     none.
+ ***********************************************************************/
+int autovot_decode(const autovot_model *model, const double *features,
+									 long num_frames, autovot_prediction *prediction)
+{
+	if (model == NULL || features == NULL || prediction == NULL)
+		return AUTOVOT_ERR_ARGUMENT;
+	// Classifier::predict needs room for the shortest VOT and the feature span
+	if (num_frames <= model->min_vot_length + PHI_SPAN)
+		return AUTOVOT_ERR_WINDOW;
+
+	try {
+		SpeechUtterance x;
+		x.resize(num_frames, AUTOVOT_NUM_FEATURES);
+		for (long j=0; j < num_frames; j++) {
+			const double *row = features + j*AUTOVOT_NUM_FEATURES;
+			for (int k=0; k < AUTOVOT_NUM_FEATURES; k++)
+				x.set(j, k, model->text_precision ? round_as_text(row[k]) : row[k]);
+		}
+		VotLocation y_hat;
+		prediction->confidence = model->classifier->predict(x, y_hat, model->pos_only);
+		prediction->burst = y_hat.burst;
+		prediction->voice = y_hat.voice;
+	}
+	catch (std::bad_alloc&) {
+		return AUTOVOT_ERR_MEMORY;
+	}
+	catch (...) {
+		return AUTOVOT_ERR_MODEL;
+	}
+
+	return AUTOVOT_OK;
+}
+
+/************************************************************************
+ Function:     autovot_stream_new
+
+ Description:  Create a stream decoder
+ Inputs:       autovot_model *model
+               double sampling_rate
+               autovot_stream **stream - the new stream
+ Output:       int - AUTOVOT_OK or an error code
+ Comments:     none.
+ ***********************************************************************/
+int autovot_stream_new(const autovot_model *model, double sampling_rate,
+											 autovot_stream **stream)
+{
+	if (model == NULL || stream == NULL || sampling_rate <= 0)
+		return AUTOVOT_ERR_ARGUMENT;
+	*stream = NULL;
+
+	autovot_stream *s = new (std::nothrow) autovot_stream;
+	if (s == NULL)
+		return AUTOVOT_ERR_MEMORY;
+	try {
+		s->decoder = new IncrementalDecoder(*model->classifier, sampling_rate, model->pos_only,
+																				model->text_precision);
+	}
+	catch (...) {
+		delete s;
+		return AUTOVOT_ERR_MEMORY;
+	}
+
+	*stream = s;
+	return AUTOVOT_OK;
+}
+
+void autovot_stream_free(autovot_stream *stream)
+{
+	if (stream == NULL)
+		return;
+	delete stream->decoder;
+	delete stream;
+}
+
+int autovot_stream_reset(autovot_stream *stream)
+{
+	if (stream == NULL)
+		return AUTOVOT_ERR_ARGUMENT;
+	stream->decoder->reset();
+	return AUTOVOT_OK;
+}
+
+/************************************************************************
+ Function:     autovot_stream_push
+
+ Description:  Add samples to a stream
+ Inputs:       autovot_stream *stream
+               const double *samples, long num_samples
+               long *num_used - samples used, may be NULL
+               int *final - 1 if the decoding is final, may be NULL
+ Output:       int - AUTOVOT_OK or an error code
+ Comments:     none.
+ ***********************************************************************/
+int autovot_stream_push(autovot_stream *stream, const double *samples,
+												long num_samples, long *num_used, int *final)
+{
+	if (stream == NULL || num_samples < 0 || (samples == NULL && num_samples > 0))
+		return AUTOVOT_ERR_ARGUMENT;
+	try {
+		long used = stream->decoder->push(samples, num_samples);
+		if (num_used != NULL)
+			*num_used = used;
+		if (final != NULL)
+			*final = stream->decoder->final() ? 1 : 0;
+	}
+	catch (std::bad_alloc&) {
+		return AUTOVOT_ERR_MEMORY;
+	}
+	return AUTOVOT_OK;
+}
+
+int autovot_stream_finish(autovot_stream *stream)
+{
+	if (stream == NULL)
+		return AUTOVOT_ERR_ARGUMENT;
+	try {
+		stream->decoder->finish();
+	}
+	catch (std::bad_alloc&) {
+		return AUTOVOT_ERR_MEMORY;
+	}
+	return AUTOVOT_OK;
+}
+
+/************************************************************************
+ Function:     autovot_stream_best
+
+ Description:  The best VOT of a stream so far
+ Inputs:       autovot_stream *stream
+               autovot_prediction *prediction
+               long *frames_scored - may be NULL
+ Output:       int - AUTOVOT_OK or an error code
+ Comments:     none.
+ ***********************************************************************/
+int autovot_stream_best(const autovot_stream *stream, autovot_prediction *prediction,
+												long *frames_scored)
+{
+	if (stream == NULL || prediction == NULL)
+		return AUTOVOT_ERR_ARGUMENT;
+	if (frames_scored != NULL)
+		*frames_scored = stream->decoder->frames_scored();
+	VotLocation y_hat;
+	double confidence;
+	if (!stream->decoder->best(y_hat, confidence))
+		return AUTOVOT_ERR_WINDOW;
+	prediction->confidence = confidence;
+	prediction->burst = y_hat.burst;
+	prediction->voice = y_hat.voice;
+	return AUTOVOT_OK;
+}
+
+} // extern "C"
+
+// ------------------------------- EOF -----------------------------//
@@ -0,0 +1,164 @@
+/************************************************************************
+ Copyright (c) 2014 Joseph Keshet, Morgan Sonderegger, Thea Knowles
+
+This file is part of Autovot, a package for automatic extraction of
+voice onset time (VOT) from audio files.
+
+Autovot is free software: you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+Autovot is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Autovot.  If not, see
+<http://www.gnu.org/licenses/>.
+************************************************************************/
+
+#ifndef _AUTOVOT_H
+#define _AUTOVOT_H
+
+/************************************************************************
+ Project:  Initial VOT Detection
+ Module:   libautovot
+ Purpose:  C interface to the front end and the decoder
+ Date:     19 Oct., 2026
+
+ The features of a window are a num_frames x AUTOVOT_NUM_FEATURES array
+ of doubles stored frame after frame (the rows of a features file), so
+ they can be wrapped by numpy without a copy. Burst and voice onsets are
+ frame indices relative to the window start, one frame per
+ AUTOVOT_FRAME_SIZE seconds, as in the predictions of VotDecode.
+
+ A stream decodes the window starting at its first sample while the
+ samples arrive: the best VOT of the frames seen so far is available at
+ any time, and the decoding is final max_onset + max_vot_length frames
+ (plus the look-ahead of the features) after the start. Its features are
+ z-scored with the statistics of the frames seen so far, so they differ
+ from those of autovot_extract_features().
+
+ A model is only read after it is loaded, so it can be shared by several
+ threads and streams. Feature extraction may be called from several threads too,
+ but the RAPT pitch tracker inside it runs one call at a time.
+
+ ***********************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUTOVOT_API_VERSION 2
+
+#define AUTOVOT_NUM_FEATURES 63
+#define AUTOVOT_FRAME_SIZE 0.001
+
+/* return codes */
+#define AUTOVOT_OK 0
+#define AUTOVOT_ERR_ARGUMENT -1      /* invalid argument */
+#define AUTOVOT_ERR_FILE -2          /* unable to read a file */
+#define AUTOVOT_ERR_MODEL -3         /* model does not match the options */
+#define AUTOVOT_ERR_WINDOW -4        /* window outside of the signal or too short */
+#define AUTOVOT_ERR_BUFFER -5        /* output buffer too small */
+#define AUTOVOT_ERR_MEMORY -6        /* allocation failed */
+
+typedef struct autovot_model autovot_model;
+typedef struct autovot_stream autovot_stream;
+
+/* decoding options, the defaults are those of VotDecode */
+typedef struct autovot_options {
+  int min_vot_length;            /* min. VOT length in msec [15] */
+  int max_vot_length;            /* max. VOT length in msec [200] */
+  int max_onset;                 /* max. burst onset in msec [150] */
+  int pos_only;                  /* assume only positive VOTs [0] */
+  const char *kernel_expansion;  /* "", "poly2", "rbf2" or "rbf3" [""] */
+  double sigma;                  /* sigma of the rbf kernels [1.0] */
+  const char *ignore_features;   /* e.g. "3,7,19" [""] */
+  int text_precision;            /* round the features to the precision of a
+                                    features file, so the predictions are those
+                                    of VotDecode [1] */
+} autovot_options;
+
+typedef struct autovot_prediction {
+  double confidence;
+  int burst;
+  int voice;
+} autovot_prediction;
+
+int autovot_api_version(void);
+const char *autovot_strerror(int code);
+void autovot_default_options(autovot_options *options);
+
+/* Load the classifier <classifier_filename>.pos/.neg, or a binary model
+   file written by VotTrain -binary_model or VotModelConvert. A binary model
+   is decoded with the options stored in it, except the fields of options
+   that differ from autovot_default_options(), which win as the options
+   given to VotDecode do. text_precision is always taken from options.
+   A binary model trained on the features of a voicing tracker other than
+   RAPT (VotFrontEnd2 -voicing_tracker yin) is refused with
+   AUTOVOT_ERR_MODEL, since the features of the library, extracted or
+   streamed, are those of RAPT. */
+int autovot_model_load(const char *classifier_filename,
+                       const autovot_options *options, autovot_model **model);
+void autovot_model_free(autovot_model *model);
+
+/* Number of frames of the features of a window. window_end can be -1 for
+   the end of the signal. */
+int autovot_window_frames(long num_samples, double sampling_rate,
+                          double window_start, double window_end,
+                          long *num_frames);
+
+/* Extract the features of a window into a caller-provided buffer of
+   capacity frames. If the buffer is too small AUTOVOT_ERR_BUFFER is
+   returned and num_frames is set to the required size. The samples are
+   scaled to [-1,1] (16-bit samples divided by 32767). */
+int autovot_extract_features(const double *samples, long num_samples,
+                             double sampling_rate, double window_start,
+                             double window_end, int normalize,
+                             double *features, long capacity, long *num_frames);
+
+/* Same, into a buffer allocated by the library and released with
+   autovot_free() */
+int autovot_extract_features_alloc(const double *samples, long num_samples,
+                                   double sampling_rate, double window_start,
+                                   double window_end, int normalize,
+                                   double **features, long *num_frames);
+void autovot_free(void *buffer);
+
+/* Predict the VOT of the features of a window */
+int autovot_decode(const autovot_model *model, const double *features,
+                   long num_frames, autovot_prediction *prediction);
+
+/* Start decoding a stream of samples with a model. The model must outlive
+   the stream. */
+int autovot_stream_new(const autovot_model *model, double sampling_rate,
+                       autovot_stream **stream);
+void autovot_stream_free(autovot_stream *stream);
+
+/* Start a new window at the next sample */
+int autovot_stream_reset(autovot_stream *stream);
+
+/* Add samples scaled to [-1,1]. num_used is set to the number of samples
+   used, fewer than num_samples once the decoding is final, and final to 1
+   once it is. */
+int autovot_stream_push(autovot_stream *stream, const double *samples,
+                        long num_samples, long *num_used, int *final);
+
+/* The audio ended before the decoding was final: decode as if it was
+   followed by silence */
+int autovot_stream_finish(autovot_stream *stream);
+
+/* The best VOT so far, relative to the first sample of the window.
+   frames_scored is the number of frames whose candidates were scored, and
+   AUTOVOT_ERR_WINDOW is returned while it is 0. */
+int autovot_stream_best(const autovot_stream *stream, autovot_prediction *prediction,
+                        long *frames_scored);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _AUTOVOT_H */
@@ -73,7 +73,8 @@ typedef struct _wav_params {
   int length;
   int head_pad;
   int tail_pad;
-  float *data;
+  const double *data;   /* the caller's samples, not copied */
+  double scale;         /* of the samples to the 16 bit range */
 } wav_params;
 
 /* output data structure */
@@ -142,7 +143,7 @@ int Get_SoundData( wav_params *par, int ndone , float *fdata, int actsize){
     rs = par->length - ndone;
 	
   for( i=0; i<rs; i++)
-    fdata[i] = (float) par->data[i+ndone];
+    fdata[i] = (float) (par->scale*par->data[i+ndone]);
   
   return rs;  
 }
@@ -314,7 +315,8 @@ static void peak(float *y, float *xp, float *yp)
 /* ----------------------------------------------------------------------- */
 void get_fast_cands(float *fdata, float *fdsdata, int ind, int step, int size, int dec, 
 										int start, int nlags, float *engref, int *maxloc, float *maxval, 
-										Cross *cp, float *peaks, int *locs, int *ncand, F0_params *par)
+										Cross *cp, float *peaks, int *locs, int *ncand, F0_params *par,
+										Xcorr_scratch *scratch)
 {
   int decind, decstart, decnlags, decsize, i, j, *lp;
   float *corp, xp, yp, lag_wt;
@@ -327,7 +329,7 @@ void get_fast_cands(float *fdata, float *fdsdata, int ind, int step, int size, i
   decsize = 1 + (size/dec);
   corp = cp->correl;
 	
-  crossf(fdsdata + decind, decsize, decstart, decnlags, engref, maxloc, maxval, corp);
+  crossf(fdsdata + decind, decsize, decstart, decnlags, engref, maxloc, maxval, corp, scratch);
   cp->maxloc = *maxloc;	/* location of maximum in correlation */
   cp->maxval = *maxval;	/* max. correlation value (found at maxloc) */
   cp->rms = (float) sqrt(*engref/size); /* rms in reference window */
@@ -363,7 +365,7 @@ void get_fast_cands(float *fdata, float *fdsdata, int ind, int step, int size, i
     *ncand = par->n_cands-1;  /* leave room for the unvoiced hypothesis */
   }
   crossfi(fdata + (ind * step), size, start, nlags, 7, engref, maxloc,
-					maxval, corp, locs, *ncand);
+					maxval, corp, locs, *ncand, scratch);
 	
   cp->maxloc = *maxloc;	/* location of maximum in correlation */
   cp->maxval = *maxval;	/* max. correlation value (found at maxloc) */
@@ -680,6 +682,7 @@ freqwt, lagwt;
 static int step, size, nlags, start, stop, ncomp, *locs = NULL;
 static short maxpeaks;
 
+static Xcorr_scratch xcorr_scratch = {NULL, 0, NULL, NULL, 0};	/* of crossf() and crossfi() */
 static int wReuse = 0;  /* number of windows seen before resued */
 static Windstat *windstat = NULL;
 
@@ -1182,7 +1185,7 @@ int dp_f0(float	*fdata, int buff_size, int sdstep, double freq,
     headF->rms = stat->rms[i];
     get_fast_cands(fdata, dsdata, i, step, size, decimate, start,
 									 nlags, &engref, &maxloc,
-									 &maxval, headF->cp, peaks, locs, &ncand, par);
+									 &maxval, headF->cp, peaks, locs, &ncand, par, &xcorr_scratch);
     
     /*    Move the peak value and location arrays into the dp structure */
     {
@@ -1469,6 +1472,8 @@ void free_dp_f0()
   
   free((void *)locs);
   locs = NULL;
+
+  free_xcorr_scratch(&xcorr_scratch);
   
   if (wReuse) {
     free((void *)windstat);
@@ -1527,7 +1532,10 @@ int Get_f0(wav_params *wpar, F0_params *par, out_params *opar){
   if (startpos < 0) startpos = 0;
   if (endpos >= (length - 1) || endpos == -1)
     endpos = length - 1;
-  if (startpos > endpos) return GETF0_OK;
+  if (startpos > endpos) {
+    free((void *)par);   /* as on the other successful return */
+    return GETF0_OK;
+  }
 	
   sf = (double) wpar->rate;
 	
@@ -1600,7 +1608,10 @@ int Get_f0(wav_params *wpar, F0_params *par, out_params *opar){
 
 
 
-int get_f0s_main(infra::vector samples, infra::vector &f0, infra::vector &vuv, infra::vector &rms_speech, infra::vector &acpkp,
+/* F0 tracking of num_samples samples in [-1,1], read in place: each
+   buffer of dp_f0() is converted to the 16 bit range as it is read */
+int get_f0s_span(const double *samples, int num_samples, infra::vector &f0, infra::vector &vuv,
+								 infra::vector &rms_speech, infra::vector &acpkp,
 								 double frame_step, double window_duration, double sampling_rate)
 {
   int i, tail_zerofill=0;
@@ -1616,7 +1627,8 @@ int get_f0s_main(infra::vector samples, infra::vector &f0, infra::vector &vuv, i
   wpar->rate = sampling_rate; // defualt 16000
   wpar->size = 2;
   wpar->length = 0;
-  wpar->data = NULL;
+  wpar->data = samples;
+  wpar->scale = 32768.0;
   wpar->swap = 0;
   wpar->head_pad = 0;
   wpar->tail_pad = 0;
@@ -1656,18 +1668,8 @@ int get_f0s_main(infra::vector samples, infra::vector &f0, infra::vector &vuv, i
     }
   }
 	
-	/* load wave data  */
-	wpar->length = samples.size();
-
-	if( wpar->padding){
-		wpar->length += wpar->head_pad;
-		wpar->length += wpar->tail_pad;
-	}
-		
-	wpar->data = (float *) malloc( sizeof(float)*wpar->length);
-	
-	for (int i=0; i < int(samples.size()); i++)
-		wpar->data[i] = 32768.0*samples[i];
+	/* wave data, without padding */
+	wpar->length = num_samples;
 
 	if( wpar->nan == -1) wpar->nan = wpar->length;
 	
@@ -1675,12 +1677,18 @@ int get_f0s_main(infra::vector samples, infra::vector &f0, infra::vector &vuv, i
   if( init_out_params( opar, 
 											(int) ((wpar->length / (wpar->rate * par->frame_step))+0.5)) == GETF0_ERROR){
     fprintf( stderr, "error: init_out_params()\n");
+    free_out_params(opar);
+    free(wpar);
+    free(par);
     return 0;
   }
   
   /* estimate F0 */
   if( Get_f0( wpar, par, opar) == GETF0_ERROR){
     fprintf( stderr, "error: get_f0()\n");
+    free_out_params(opar);
+    free(wpar);
+    free(par);   /* Get_f0() frees it on success only */
     return 0;
   }
 	
@@ -1696,10 +1704,20 @@ int get_f0s_main(infra::vector samples, infra::vector &f0, infra::vector &vuv, i
     acpkp[i] = opar->acpkp[i];
   }
 
-	free(wpar->data);
-  // FREE MORE HERE??
+  free_out_params(opar);
+  free(wpar);
 
   return (f0.size());
 }
 
+int get_f0s_main(const infra::vector &samples, infra::vector &f0, infra::vector &vuv,
+								 infra::vector &rms_speech, infra::vector &acpkp,
+								 double frame_step, double window_duration, double sampling_rate)
+{
+  if (samples.size() == 0)
+    return get_f0s_span(NULL, 0, f0, vuv, rms_speech, acpkp, frame_step, window_duration, sampling_rate);
+  return get_f0s_span(&samples[0], samples.size(), f0, vuv, rms_speech, acpkp, frame_step,
+											window_duration, sampling_rate);
+}
+
 
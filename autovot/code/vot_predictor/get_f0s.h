@@ -1,5 +1,9 @@
-
 #include <infra.h>
 
-unsigned int get_f0s_main(infra::vector samples, infra::vector &f0, infra::vector &vuv, infra::vector &rms_speech, infra::vector &acpkp,
-								 double frame_step=0.01f, double window_duration=0.0075f, double sampling_rate=16000);
\ No newline at end of file
+int get_f0s_main(const infra::vector &samples, infra::vector &f0, infra::vector &vuv, infra::vector &rms_speech, infra::vector &acpkp,
+								 double frame_step=0.01f, double window_duration=0.0075f, double sampling_rate=16000);
+
+// as get_f0s_main(), on num_samples samples read in place
+int get_f0s_span(const double *samples, int num_samples, infra::vector &f0, infra::vector &vuv,
+								 infra::vector &rms_speech, infra::vector &acpkp,
+								 double frame_step=0.01f, double window_duration=0.0075f, double sampling_rate=16000);
@@ -19,11 +19,14 @@ License along with Autovot.  If not, see
 <http://www.gnu.org/licenses/>.
 ************************************************************************/
 
+#include <vector>
+#include <algorithm>
 #include <stdlib.h>
 #include <math.h>
 #include <cfloat>
 #include "infra_dsp.h"
 #include "FFTReal/FFTReal.h"
+#include "Profiler.h"
 //#include <audiofile.h>
 # include "WavFile.h"
 #include "fast_pitch_filters.h"
@@ -34,6 +37,7 @@ double prev_sampling_rate;
 
 double read_samples_from_file(std::string filename, infra::vector &samples, double virtual_sampling_rate)
 {
+	ProfileScope profile(PROFILE_WAV_READ);
 	if (filename == prev_filename) {
 		// caching prev_filename
 		samples.resize(prev_samples.size());
@@ -61,6 +65,7 @@ double read_samples_from_file(std::string filename, infra::vector &samples, doub
 		samples[i] = double(pbuffer[i]/32767.0);
 	delete [] pbuffer;
 	wav_file.Close();
+	Profiler::count(PROFILE_BYTES_READ, num_samples_read*sizeof(short));
 	
 	prev_filename = filename;
 	prev_samples.resize(samples.size());
@@ -99,27 +104,23 @@ double read_samples_from_file(std::string filename, infra::vector &samples, doub
 //	return sampling_rate;
 //}
 
-infra::vector hamming(infra::vector x)
+infra::vector hamming(const infra::vector_base &x)
 {
-  infra::vector y(x.size());
-  y.zeros();
-  
-  infra::vector hamming_window(x.size());
-  
-  for (int i = 0; i < int(x.size()) / 2; i++)
-    hamming_window[i] = 0.54f - 0.46f * (float)cos ((2*M_PI) * i / (x.size() - 1));
-  for (int i = int(x.size() / 2); i < int(x.size()); i++)
-    hamming_window[i] = hamming_window[x.size() - 1 - i];
+  int n = int(x.size());
+  infra::vector y(n);
   
-  for (int i = 0; i < int(x.size()); i++)
-    y[i] = x[i]*hamming_window[i];
+  // the second half of the window mirrors the first
+  for (int i = 0; i < n; i++) {
+    int k = (i < n / 2) ? i : n - 1 - i;
+    y[i] = x[i]*(0.54f - 0.46f * (float)cos ((2*M_PI) * k / (x.size() - 1)));
+  }
   
   return y;
 }
 
 
 
-infra::vector powerspectrum(infra::vector xin, int nfft)
+infra::vector powerspectrum(const infra::vector_base &xin, int nfft)
 {
   const long nbr_points = nfft;			// Power of 2
   flt_t	* const	x = new flt_t [nbr_points];
@@ -145,7 +146,7 @@ infra::vector powerspectrum(infra::vector xin, int nfft)
   return s;
 }
 
-infra::vector autocorrelation_function(infra::vector xin)
+infra::vector autocorrelation_function(const infra::vector_base &xin)
 {
   // check what should be the size of the FFT
 	int mantissa = 0;
@@ -198,7 +199,7 @@ infra::vector autocorrelation_function(infra::vector xin)
 }
 
 
-double autocorrelation_features(infra::vector xin)
+double autocorrelation_features(const infra::vector_base &xin)
 {
   // check what should be the size of the FFT
 	int mantissa = 0;
@@ -239,7 +240,7 @@ double autocorrelation_features(infra::vector xin)
 }
 
 
-infra::vector diff_means(const infra::vector x, int offset)
+infra::vector diff_means(const infra::vector_base &x, int offset)
 {
   infra::vector y(x.size());
   for (int i = 0; i < int(x.size()); i++) {
@@ -256,7 +257,7 @@ infra::vector diff_means(const infra::vector x, int offset)
   return y;
 }
 
-infra::vector cummulative_features(const infra::vector x, std::string type, int offset)
+infra::vector cummulative_features(const infra::vector_base &x, const std::string &type, int offset)
 {
   infra::vector y(x.size());
   y.zeros();
@@ -275,7 +276,7 @@ infra::vector cummulative_features(const infra::vector x, std::string type, int
   return y;
 }
 
-infra::vector rms_diff_means(const infra::matrix X, int offset)
+infra::vector rms_diff_means(const infra::matrix_base &X, int offset)
 {
   infra::vector y(X.width());
   y.zeros();
@@ -309,7 +310,7 @@ infra::vector rms_diff_means(const infra::matrix X, int offset)
 }
 
 
-infra::vector fir_filter(double b[], int nb, const infra::vector x)
+infra::vector fir_filter(double b[], int nb, const infra::vector_base &x)
 {
   infra::vector y(x.size());
   y.zeros();
@@ -323,100 +324,207 @@ infra::vector fir_filter(double b[], int nb, const infra::vector x)
 
 
 
-void fast_pitch(infra::vector x, double window_size, double voicing_threshold, double silence_threshold, 
+// FFT size of the fast pitch filter bank
+#define FAST_PITCH_FFT_SIZE 1024
+
+// The fast pitch filter bank: the low-pass bl followed by each band-pass
+// bf[band], as fir_filter() applies them, combined into one causal filter
+// per band and applied by overlap-save FFT convolution. The transform of
+// a block of the input is shared by all the bands, and two bands are
+// recovered from each inverse transform as its real and imaginary parts.
+class FastPitchFilterBank
+{
+public:
+  FastPitchFilterBank();
+  // the nBands outputs of x, y[band*x.size() + i]
+  void filter(const infra::vector_base &x, std::vector<double> &y) const;
+
+protected:
+  void fft(std::vector<double> &re, std::vector<double> &im, bool inverse) const;
+
+protected:
+  int n;                                       // FFT size
+  int taps;                                    // of the combined filters
+  int step;                                    // new samples per block
+  std::vector<int> bit_reversed;
+  std::vector<double> cos_table;               // of 2*pi*k/n, k < n/2
+  std::vector<double> sin_table;
+  std::vector< std::vector<double> > pair_re;  // transform of the filter of band
+  std::vector< std::vector<double> > pair_im;  // 2p plus i times that of band 2p+1
+};
+
+FastPitchFilterBank::FastPitchFilterBank() :
+n(FAST_PITCH_FFT_SIZE), taps(bl_len + bf_len - 1), step(n - taps + 1),
+bit_reversed(n), cos_table(n/2), sin_table(n/2)
+{
+  int log2n = 0;
+  while ((1 << log2n) < n) log2n++;
+  for (int i=0; i < n; i++) {
+    bit_reversed[i] = 0;
+    for (int k=0; k < log2n; k++)
+      if (i & (1 << k)) bit_reversed[i] |= 1 << (log2n-1-k);
+  }
+  for (int k=0; k < n/2; k++) {
+    cos_table[k] = cos(2*M_PI*k/n);
+    sin_table[k] = sin(2*M_PI*k/n);
+  }
+
+  int num_pairs = (nBands + 1)/2;
+  pair_re.resize(num_pairs);
+  pair_im.resize(num_pairs);
+  for (int p=0; p < num_pairs; p++) {
+    std::vector<double> re(n, 0.0), im(n, 0.0);
+    for (int i=0; i < bl_len; i++)
+      for (int j=0; j < bf_len; j++) {
+        re[i+j] += bl[i]*bf[2*p][j];
+        if (2*p+1 < nBands) im[i+j] += bl[i]*bf[2*p+1][j];
+      }
+    fft(re, im, false);
+    pair_re[p] = re;
+    pair_im[p] = im;
+  }
+}
+
+void FastPitchFilterBank::fft(std::vector<double> &re, std::vector<double> &im, bool inverse) const
+{
+  for (int i=0; i < n; i++) {
+    int j = bit_reversed[i];
+    if (i < j) {
+      std::swap(re[i], re[j]);
+      std::swap(im[i], im[j]);
+    }
+  }
+  double sign = inverse ? 1.0 : -1.0;
+  for (int length=2; length <= n; length <<= 1) {
+    int half = length/2;
+    int stride = n/length;
+    for (int i=0; i < n; i += length)
+      for (int j=0; j < half; j++) {
+        double wr = cos_table[j*stride];
+        double wi = sign*sin_table[j*stride];
+        int u = i+j, v = i+j+half;
+        double vr = re[v]*wr - im[v]*wi;
+        double vi = re[v]*wi + im[v]*wr;
+        re[v] = re[u] - vr;
+        im[v] = im[u] - vi;
+        re[u] += vr;
+        im[u] += vi;
+      }
+  }
+}
+
+void FastPitchFilterBank::filter(const infra::vector_base &x, std::vector<double> &y) const
+{
+  long len = long(x.size());
+  y.assign(nBands*len, 0.0);
+
+  std::vector<double> xr(n), xi(n), zr(n), zi(n);
+  for (long out=0; out < len; out += step) {
+    // the block ends with the next step samples, after the taps-1 before
+    long first = out - (taps - 1);
+    bool silent = true;
+    for (int i=0; i < n; i++) {
+      long k = first + i;
+      xr[i] = (k >= 0 && k < len) ? x[k] : 0.0;
+      xi[i] = 0.0;
+      if (xr[i] != 0.0) silent = false;
+    }
+    // the output of silence is exactly 0, as that of fir_filter()
+    if (silent)
+      continue;
+    fft(xr, xi, false);
+
+    long count = _min(long(step), len - out);
+    for (int p=0; p < int(pair_re.size()); p++) {
+      const std::vector<double> &hr = pair_re[p];
+      const std::vector<double> &hi = pair_im[p];
+      for (int k=0; k < n; k++) {
+        zr[k] = xr[k]*hr[k] - xi[k]*hi[k];
+        zi[k] = xr[k]*hi[k] + xi[k]*hr[k];
+      }
+      fft(zr, zi, true);
+      double *y_even = &y[2*p*len + out];
+      for (long j=0; j < count; j++)
+        y_even[j] = zr[taps-1+j]/n;
+      if (2*p+1 < nBands) {
+        double *y_odd = &y[(2*p+1)*len + out];
+        for (long j=0; j < count; j++)
+          y_odd[j] = zi[taps-1+j]/n;
+      }
+    }
+  }
+}
+
+
+void fast_pitch(const infra::vector_base &x, double window_size, double voicing_threshold, double silence_threshold, 
                 double sampling_rate, infra::vector &f0, infra::vector &cost)
 {
-  f0.resize(x.size());
-  cost.resize(x.size());          
-  
-  infra::vector envA(x.size());
-  envA = fir_filter(bl, bl_len, x);
+  static const FastPitchFilterBank filter_bank;
+
+  int len = int(x.size());
+  f0.resize(len);
+  cost.resize(len);
+  if (len == 0)
+    return;
+
+  // the band-passed signals, xx of band b at bands[b*len]
+  std::vector<double> bands;
+  filter_bank.filter(x, bands);
+
+  // running sums of the current band
+  std::vector<double> xm(len), m2(len), x2(len);
+  int nn = int(window_size*sampling_rate);
 
-  infra::matrix f0_candidates(nBands,x.size());
-  infra::matrix cost_candidates(nBands,x.size());
-  
   for (int band=0; band < nBands; band++) {
-    infra::vector xx(x.size());
-    xx = fir_filter(bf[band],bf_len,envA);
-
-    // track pitch
-    infra::vector mm(int(xx.size()));
-    mm[0] = 2*xx[0];
-    for (int i=0; i < int(xx.size())-2; i++)
-      mm[i+1] = xx[i] + xx[i+2];
-    mm[int(xx.size())-1] = 2*xx[int(xx.size())-1];
-    
-    infra::vector xm(int(xx.size()));
-    xm[0] = xx[0]*mm[0];
-    for (int i=1; i < int(xx.size()); i++) 
-      xm[i] = xm[i-1] + (xx[i]*mm[i]);
-    
-    infra::vector m2(mm.size());
-    m2[0] = mm[0]*mm[0];
-    for (int i=1; i < int(xx.size()); i++) 
-      m2[i] = m2[i-1] + (mm[i]*mm[i]);
-    
-    infra::vector x2(int(xx.size()));
-    x2[0] = xx[0]*xx[0];
-    for (int i=1; i < int(xx.size()); i++) 
-      x2[i] = x2[i-1] + (xx[i]*xx[i]);
-    
-    int nn = int(window_size*sampling_rate);
-		
-		infra::vector xmu(xx.size());
-		for (int i=0; i < nn; i++) 
-			xmu[i] = xm[i];
-    for (int i=nn; i < int(xx.size()); i++) 
-      xmu[i] = xm[i] - xm[i-nn];
-    
-		infra::vector m2u(xx.size());
-		for (int i=0; i < nn; i++) 
-			m2u[i] = m2[i];
-    for (int i=nn; i < int(xx.size()); i++) 
-      m2u[i] = m2[i] - m2[i-nn];
-
-		infra::vector x2u(xx.size());
-		for (int i=0; i < nn; i++) 
-			x2u[i] = x2[i];
-    for (int i=nn; i < int(xx.size()); i++) 
-      x2u[i] = x2[i] - x2[i-nn];
-
-    infra::vector aa(int(xx.size()));
-    for (int i=0; i < int(xx.size()); i++) {
-      if (m2u[i] == 0)
-        aa[i] = 0.5;
+    const double *xx = &bands[band*len];
+    double min_aa = 0.5/cos(2*M_PI*fMin[band]/sampling_rate);
+
+    // track pitch, and keep the candidate of lowest cost over the bands
+    for (int i=0; i < len; i++) {
+      double mm;
+      if (i == 0) mm = 2*xx[0];
+      else if (i == len-1) mm = 2*xx[len-1];
+      else mm = xx[i-1] + xx[i+1];
+
+      xm[i] = (i == 0) ? xx[i]*mm : xm[i-1] + (xx[i]*mm);
+      m2[i] = (i == 0) ? mm*mm : m2[i-1] + (mm*mm);
+      x2[i] = (i == 0) ? xx[i]*xx[i] : x2[i-1] + (xx[i]*xx[i]);
+      double xmu = (i < nn) ? xm[i] : xm[i] - xm[i-nn];
+      double m2u = (i < nn) ? m2[i] : m2[i] - m2[i-nn];
+      double x2u = (i < nn) ? x2[i] : x2[i] - x2[i-nn];
+
+      double aa;
+      if (m2u == 0)
+        aa = 0.5;
       else 
-        aa[i] = xmu[i]/(m2u[i] + DBL_MIN);
+        aa = xmu/(m2u + DBL_MIN);
       // BELOW MINIMUM FREQUENCY?
-      if (fabsl(aa[i]) < 0.5/cos(2*M_PI*fMin[band]/sampling_rate))
-        aa[i] = 0.5;
-    }
-    
+      if (fabsl(aa) < min_aa)
+        aa = 0.5;
 
-    for (int i=0; i < int(xx.size()); i++) {
       // PITCH
-      f0_candidates(band,i) = acos(0.5/aa[i]) * sampling_rate / (2.0*M_PI);
-      f0_candidates(band,i) = _min(f0_candidates(band,i),sampling_rate-f0_candidates(band,i));
+      double f0_candidate = acos(0.5/aa) * sampling_rate / (2.0*M_PI);
+      f0_candidate = _min(f0_candidate,sampling_rate-f0_candidate);
 
-      double sp = sin(2*M_PI*f0_candidates(band,i)/sampling_rate);
-      double cp = cos(2*M_PI*f0_candidates(band,i)/sampling_rate);
+      double sp = sin(2*M_PI*f0_candidate/sampling_rate);
+      double cp = cos(2*M_PI*f0_candidate/sampling_rate);
       
       // COST
-      cost_candidates(band,i) = sqrt(fabsl(x2u[i]+aa[i]*aa[i]*m2u[i]-2*aa[i]*xmu[i])/fabsl(m2u[i]+DBL_MIN));
-      cost_candidates(band,i) = cost_candidates(band,i)*(cp*cp*sampling_rate)/(M_PI*sp+DBL_MIN);
-      cost_candidates(band,i) = cost_candidates(band,i)/(f0_candidates(band,i)+DBL_MIN);
-      if (f0_candidates(band,i)==0 || m2u[i]==0 || x2u[i]==0)
-				cost_candidates(band,i) = 1.0/DBL_MIN; // which is basically inf
+      double cost_candidate = sqrt(fabsl(x2u+aa*aa*m2u-2*aa*xmu)/fabsl(m2u+DBL_MIN));
+      cost_candidate = cost_candidate*(cp*cp*sampling_rate)/(M_PI*sp+DBL_MIN);
+      cost_candidate = cost_candidate/(f0_candidate+DBL_MIN);
+      if (f0_candidate==0 || m2u==0 || x2u==0)
+        cost_candidate = 1.0/DBL_MIN; // which is basically inf
+
+      // SELECT BEST CANDIDATE FROM BANDS (IMPROVE BY VITERBI??)
+      if (band == 0 || cost_candidate < cost[i]) {
+        f0[i] = f0_candidate;
+        cost[i] = cost_candidate;
+      }
     }
-    
   }
   
-  for (int i=0; i < int(x.size()); i++) {
-    // SELECT BEST CANDIDATE FROM BANDS (IMPROVE BY VITERBI??)
-    unsigned int best_f0_band = cost_candidates.column(i).argmin();
-    f0[i] = f0_candidates(best_f0_band,i);
-    cost[i] = cost_candidates(best_f0_band,i);
-      
+  for (int i=0; i < len; i++) {
     // VOICED/UNVOICED DETERMINATION
     bool voiced = (cost[i] < voicing_threshold && x[i]*x[i] > silence_threshold);
     if (!voiced) f0[i] = 0;
@@ -426,7 +534,105 @@ void fast_pitch(infra::vector x, double window_size, double voicing_threshold, d
 
 
 
-double zero_crossing(const infra::vector x)
+// The voicing decisions of a YIN-style detector (de Cheveigne & Kawahara
+// 2002), a cheaper alternative to RAPT: the signal is low-passed and
+// decimated to about YIN_RATE, and each frame is voiced when its level is
+// less than YIN_SILENCE_DB below the peak of the signal and the minimum
+// of its cumulative mean normalized difference over the lags of
+// YIN_MIN_F0..YIN_MAX_F0 is below YIN_THRESHOLD. Isolated decisions are
+// then flipped by a 3-frame majority, as the dynamic programming of RAPT
+// does. The thresholds give the best frame agreement with RAPT on the
+// tutorial data (87%). Frame j is centered frame_step*(j+1) into the
+// signal, and frames are only made while the samples mapped to them (half
+// a step on each side) are in the signal.
+#define YIN_MIN_F0 50.0
+#define YIN_MAX_F0 550.0
+#define YIN_RATE 4000.0
+#define YIN_LOWPASS_TAPS 31
+#define YIN_THRESHOLD 0.5
+#define YIN_SILENCE_DB -30.0
+
+void yin_voicing(const double *x, int len, double frame_step, double sampling_rate, infra::vector &vuv)
+{
+  int step = int(frame_step*sampling_rate + 0.5);
+  int num_frames = (step > 0 && len > step/2) ? (len - step/2)/step : 0;
+  vuv.resize(num_frames);
+  if (num_frames == 0)
+    return;
+  vuv.zeros();
+
+  // low-pass and decimate to about YIN_RATE
+  int dec = _max(1, int(sampling_rate/YIN_RATE));
+  double rate = sampling_rate/dec;
+  int half_taps = YIN_LOWPASS_TAPS/2;
+  std::vector<double> lowpass(YIN_LOWPASS_TAPS);
+  double cutoff = 0.8/(2*dec);
+  double gain = 0.0;
+  for (int i=0; i < YIN_LOWPASS_TAPS; i++) {
+    double k = i - half_taps;
+    double sinc = (k == 0) ? 2*cutoff : sin(2*M_PI*cutoff*k)/(M_PI*k);
+    lowpass[i] = sinc*(0.5 - 0.5*cos(2*M_PI*(i+1)/(YIN_LOWPASS_TAPS+1)));
+    gain += lowpass[i];
+  }
+  int ds_len = (len + dec - 1)/dec;
+  std::vector<double> y(ds_len, 0.0);
+  double peak = 0.0;
+  for (int n=0; n < ds_len; n++) {
+    double acc = 0.0;
+    for (int i=0; i < YIN_LOWPASS_TAPS; i++) {
+      int k = n*dec + i - half_taps;
+      if (k >= 0 && k < len) acc += lowpass[i]*x[k];
+    }
+    y[n] = acc/gain;
+    peak = _max(peak, fabs(y[n]));
+  }
+
+  // each frame: the integration window of max_lag samples and the lags
+  // after it, centered on the samples the frame is mapped to
+  int min_lag = _max(2, int(rate/YIN_MAX_F0));
+  int max_lag = int(rate/YIN_MIN_F0 + 0.5);
+  int window = max_lag;
+  double silence = peak*peak*pow(10.0, YIN_SILENCE_DB/10.0);
+  std::vector<double> frame(window + max_lag);
+  for (int j=0; j < num_frames; j++) {
+    int center = (step/2 + j*step + step/2)/dec;
+    int first = center - (window + max_lag)/2;
+    double energy = 0.0;
+    for (int i=0; i < window + max_lag; i++) {
+      int k = first + i;
+      frame[i] = (k >= 0 && k < ds_len) ? y[k] : 0.0;
+      if (i < window) energy += frame[i]*frame[i];
+    }
+    if (energy/window <= silence)
+      continue;
+
+    // difference function and its cumulative mean normalized minimum
+    double cumulative = 0.0;
+    double aperiodicity = 1.0;
+    for (int lag=1; lag <= max_lag; lag++) {
+      double d = 0.0;
+      for (int i=0; i < window; i++) {
+        double e = frame[i] - frame[i+lag];
+        d += e*e;
+      }
+      cumulative += d;
+      if (lag >= min_lag && cumulative > 0)
+        aperiodicity = _min(aperiodicity, d*lag/cumulative);
+    }
+    vuv[j] = (aperiodicity < YIN_THRESHOLD) ? 1.0 : 0.0;
+  }
+
+  // 3-frame majority
+  std::vector<double> raw(num_frames);
+  for (int j=0; j < num_frames; j++)
+    raw[j] = vuv[j];
+  for (int j=1; j+1 < num_frames; j++)
+    vuv[j] = (raw[j-1] + raw[j] + raw[j+1] >= 2.0) ? 1.0 : 0.0;
+}
+
+
+
+double zero_crossing(const infra::vector_base &x)
 {
   double zc = 0.0;
   
@@ -26,14 +26,15 @@ License along with Autovot.  If not, see
 
 
 double read_samples_from_file(std::string filename, infra::vector &x, double virtual_sampling_rate);
-infra::vector hamming(infra::vector x);
-infra::vector powerspectrum(infra::vector x, int nfft);
-infra::vector autocorrelation_function(infra::vector xin);
-double autocorrelation_features(infra::vector xin);
-infra::vector diff_means(const infra::vector x, int offset);
-infra::vector cummulative_features(const infra::vector x, std::string type, int offset);
-infra::vector rms_diff_means(const infra::matrix X, int offset);
-infra::vector fir_filter(double b[], int nb, const infra::vector x);
-void fast_pitch(infra::vector x, double window_size, double voicing_threshold, double silence_threshold, 
+infra::vector hamming(const infra::vector_base &x);
+infra::vector powerspectrum(const infra::vector_base &x, int nfft);
+infra::vector autocorrelation_function(const infra::vector_base &xin);
+double autocorrelation_features(const infra::vector_base &xin);
+infra::vector diff_means(const infra::vector_base &x, int offset);
+infra::vector cummulative_features(const infra::vector_base &x, const std::string &type, int offset);
+infra::vector rms_diff_means(const infra::matrix_base &X, int offset);
+infra::vector fir_filter(double b[], int nb, const infra::vector_base &x);
+void fast_pitch(const infra::vector_base &x, double window_size, double voicing_threshold, double silence_threshold, 
                 double sampling_rate, infra::vector &f0, infra::vector &cost);
-double zero_crossing(const infra::vector x);
\ No newline at end of file
+void yin_voicing(const double *x, int len, double frame_step, double sampling_rate, infra::vector &vuv);
+double zero_crossing(const infra::vector_base &x);
\ No newline at end of file
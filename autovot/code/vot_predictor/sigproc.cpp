@@ -32,6 +32,12 @@
 #endif
 #include "getf0.h"
 #include "sigproc.h"
+#include "FFTReal/FFTReal.h"
+
+/* crossf() computes the cross products by FFT from this many lags on, when
+   size*nlags exceeds XCORR_FFT_COST times n*log2(n) of the FFT size n */
+#define XCORR_FFT_MIN_LAGS 512
+#define XCORR_FFT_COST 16.0
 
 #define ckalloc(x) malloc(x)
 #define ckfree(x) free(x)
@@ -399,6 +405,176 @@ int xlpc(int lpc_ord, float lpc_stabl, int wsize, float *data, float *lpca, floa
 }
 
 
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Cross products of the reference window ref (size samples) with sig at
+   nlags successive lags: out[i] = sum_j ref[j] * sig[i+j].
+ *
+ * The SIMD versions compute several lags per pass, one lag per lane, and
+ * accumulate each of them in the same order as the scalar loop, so all
+ * versions give the same floats. The widest one the processor supports
+ * is chosen on the first call, the scalar one if AUTOVOT_NO_SIMD is set
+ * in the environment.
+ */
+static void xcorr_lags_scalar(const float *ref, const float *sig, int size, int nlags, float *out)
+{
+  const float *dp, *ds;
+  float sum;
+  int i, j;
+
+  for(i=0; i < nlags; i++) {
+    for(j=size, sum=0.0, dp=ref, ds=sig+i; j--; )
+      sum += *dp++ * *ds++;
+    out[i] = sum;
+  }
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+
+__attribute__((target("sse2")))
+static int xcorr_lags_sse(const float *ref, const float *sig, int size, int nlags, float *out)
+{
+  int i, j;
+
+  for(i=0; i+4 <= nlags; i += 4) {
+    __m128 sum = _mm_setzero_ps();
+    for(j=0; j < size; j++)
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(ref[j]), _mm_loadu_ps(sig+i+j)));
+    _mm_storeu_ps(out+i, sum);
+  }
+  return(i);
+}
+
+__attribute__((target("avx2")))
+static void xcorr_lags_avx2(const float *ref, const float *sig, int size, int nlags, float *out)
+{
+  int i, j;
+
+  for(i=0; i+8 <= nlags; i += 8) {
+    __m256 sum = _mm256_setzero_ps();
+    for(j=0; j < size; j++)
+      sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(ref[j]), _mm256_loadu_ps(sig+i+j)));
+    _mm256_storeu_ps(out+i, sum);
+  }
+  i += xcorr_lags_sse(ref, sig+i, size, nlags-i, out+i);
+  xcorr_lags_scalar(ref, sig+i, size, nlags-i, out+i);
+}
+
+static void xcorr_lags_sse2(const float *ref, const float *sig, int size, int nlags, float *out)
+{
+  int i = xcorr_lags_sse(ref, sig, size, nlags, out);
+  xcorr_lags_scalar(ref, sig+i, size, nlags-i, out+i);
+}
+
+static void xcorr_lags_dispatch(const float *ref, const float *sig, int size, int nlags, float *out);
+static void (*xcorr_lags)(const float *, const float *, int, int, float *) = xcorr_lags_dispatch;
+
+static void xcorr_lags_dispatch(const float *ref, const float *sig, int size, int nlags, float *out)
+{
+  __builtin_cpu_init();
+  if(getenv("AUTOVOT_NO_SIMD"))
+    xcorr_lags = xcorr_lags_scalar;
+  else if(__builtin_cpu_supports("avx2"))
+    xcorr_lags = xcorr_lags_avx2;
+  else if(__builtin_cpu_supports("sse2"))
+    xcorr_lags = xcorr_lags_sse2;
+  else
+    xcorr_lags = xcorr_lags_scalar;
+  xcorr_lags(ref, sig, size, nlags, out);
+}
+#else
+static void (*xcorr_lags)(const float *, const float *, int, int, float *) = xcorr_lags_scalar;
+#endif
+
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Grow the buffers of the scratch space to hold total samples, and to an
+   FFT of fftsize points if fftsize > 0. Returns FALSE if out of memory.
+ */
+static int xcorr_scratch_reserve(Xcorr_scratch *scratch, int total, int fftsize)
+{
+  if(total > scratch->dbsize) {
+    ckfree((void *)scratch->dbdata);
+    scratch->dbsize = 0;
+    if(!(scratch->dbdata = (float*)ckalloc(sizeof(float)*total)))
+      return(FALSE);
+    scratch->dbsize = total;
+  }
+  if(fftsize > 0 && fftsize != scratch->fftsize) {
+    delete scratch->fft;
+    ckfree((void *)scratch->fftbuf);
+    scratch->fft = NULL;
+    scratch->fftsize = 0;
+    if(!(scratch->fftbuf = (float*)ckalloc(sizeof(float)*3*fftsize)))
+      return(FALSE);
+    scratch->fft = new FFTReal(fftsize);
+    scratch->fftsize = fftsize;
+  }
+  return(TRUE);
+}
+
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Release the buffers of a scratch space; it can be used again. */
+void free_xcorr_scratch(Xcorr_scratch *scratch)
+{
+  ckfree((void *)scratch->dbdata);
+  scratch->dbdata = NULL;
+  scratch->dbsize = 0;
+  delete scratch->fft;
+  scratch->fft = NULL;
+  ckfree((void *)scratch->fftbuf);
+  scratch->fftbuf = NULL;
+  scratch->fftsize = 0;
+}
+
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Size of the FFT for crossf() at nlags lags from start if it is cheaper
+   than the direct products, 0 otherwise. The FFT covers the reference
+   window and all lags without wrapping around.
+ */
+static int xcorr_fft_size(int size, int start, int nlags)
+{
+  int n, log2n;
+
+  if(nlags < XCORR_FFT_MIN_LAGS)
+    return(0);
+  for(n=1, log2n=0; n < size+start+nlags; n <<= 1, log2n++)
+    ;
+  if((double)size*nlags < XCORR_FFT_COST * (double)n * log2n)
+    return(0);
+  return(n);
+}
+
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* The products of xcorr_lags() from lag start on, as the inverse FFT of
+   the cross spectrum of the reference window and the signal. */
+static void xcorr_lags_fft(Xcorr_scratch *scratch, int size, int start, int nlags, float *out)
+{
+  int n = scratch->fftsize, half = n/2, i;
+  float *x = scratch->fftbuf, *fr = x + n, *fs = fr + n;
+  float rr, ri, sr, si, scale = 1.0f/n;
+
+  for(i=0; i < size; i++) x[i] = scratch->dbdata[i];
+  for( ; i < n; i++) x[i] = 0.0;
+  scratch->fft->do_fft(fr, x);
+  for(i=0; i < size+start+nlags; i++) x[i] = scratch->dbdata[i];
+  for( ; i < n; i++) x[i] = 0.0;
+  scratch->fft->do_fft(fs, x);
+
+  /* conj(R) * S, with the layout of FFTReal: real parts in [0,n/2], the
+     imaginary parts of the coefficients 1..n/2-1 in [n/2+1,n) */
+  fs[0] *= fr[0];
+  fs[half] *= fr[half];
+  for(i=1; i < half; i++) {
+    rr = fr[i]; ri = fr[half+i];
+    sr = fs[i]; si = fs[half+i];
+    fs[i] = rr*sr + ri*si;
+    fs[half+i] = rr*si - ri*sr;
+  }
+  scratch->fft->do_ifft(fs, x);
+  for(i=0; i < nlags; i++)
+    out[i] = x[start+i] * scale;
+}
+
 /*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
 /* Return a sequence based on the normalized crosscorrelation of the signal
    in data.
@@ -411,41 +587,34 @@ int xlpc(int lpc_ord, float lpc_stabl, int wsize, float *data, float *lpca, floa
   maxloc is the lag at which the maximum in the correlation was found
   maxval is the value of the maximum in the CCF over the requested lag interval
   correl is the array of nlags cross-correlation coefficients (-1.0 to 1.0)
+  scratch holds the buffers, owned by the caller
+ *
+  The cross products at wide lag intervals are computed by FFT, which
+  matches the direct sums to float precision.
  *
  */
-void crossf(float *data, int size, int start, int nlags, float *engref, int *maxloc, float *maxval, float *correl)
+void crossf(float *data, int size, int start, int nlags, float *engref, int *maxloc, float *maxval, float *correl, Xcorr_scratch *scratch)
 {
-  static float *dbdata=NULL;
-  static int dbsize = 0;
   register float *dp, *ds, sum, st;
   register int j;
   register  float *dq, t, *p, engr, *dds, amax;
   register  double engc;
-  int i, iloc, total;
-  int sizei, sizeo, maxsize;
+  float *dbdata;
+  int i, iloc, fftsize;
 
   /* Compute mean in reference window and subtract this from the
      entire sequence.  This doesn't do too much damage to the data
      sequenced for the purposes of F0 estimation and removes the need for
      more principled (and costly) low-cut filtering. */
-  if((total = size+start+nlags) > dbsize) {
-    if(dbdata)
-      ckfree((void *)dbdata);
-    dbdata = NULL;
-    dbsize = 0;
-    if(!(dbdata = (float*)ckalloc(sizeof(float)*total))) {
-      Fprintf(stderr,"Allocation failure in crossf()\n");
-      return;/*exit(-1);*/
-    }
-    dbsize = total;
+  fftsize = xcorr_fft_size(size, start, nlags);
+  if(!xcorr_scratch_reserve(scratch, size+start+nlags, fftsize)) {
+    Fprintf(stderr,"Allocation failure in crossf()\n");
+    return;/*exit(-1);*/
   }
+  dbdata = scratch->dbdata;
   for(engr=0.0, j=size, p=data; j--; ) engr += *p++;
   engr /= size;
   for(j=size+nlags+start, dq = dbdata, p=data; j--; )  *dq++ = *p++ - engr;
-
-  maxsize = start + nlags;
-  sizei = size + start + nlags + 1;
-  sizeo = nlags + 1;
  
   /* Compute energy in reference window. */
   for(j=size, dp=dbdata, sum=0.0; j--; ) {
@@ -462,10 +631,17 @@ void crossf(float *data, int size, int start, int nlags, float *engref, int *max
     }
     engc = sum;
 
+    /* The cross products at all requested lags, normalized below. */
+    if(fftsize)
+      xcorr_lags_fft(scratch, size, start, nlags, correl);
+    else
+      xcorr_lags(dbdata, dbdata+start, size, nlags, correl);
+
     /* COMPUTE CORRELATIONS AT ALL OTHER REQUESTED LAGS. */
     for(i=0, dq=correl, amax=0.0, iloc = -1; i < nlags; i++) {
-      for(j=size, sum=0.0, dp=dbdata, dds = ds = dbdata+i+start; j--; )
-	sum += *dp++ * *ds++;
+      dds = dbdata+i+start;
+      ds = dds+size;
+      sum = *dq;
       *dq++ = t = (float) (sum/sqrt((double)(engc*engr))); /* output norm. CC */
       engc -= (double)(*dds * *dds); /* adjust norm. energy for next lag */
       if((engc += (double)(*ds * *ds)) < 1.0)
@@ -505,31 +681,25 @@ void crossf(float *data, int size, int start, int nlags, float *engref, int *max
   locs is an array of indices pointing to the center of a patches where the
        cross correlation is to be computed.
   nlocs is the number of correlation patches to compute.
+  scratch holds the buffers, owned by the caller
  *
  */
-void crossfi(float *data, int size, int start0, int nlags0, int nlags, float *engref, int *maxloc, float *maxval, float *correl, int *locs, int nlocs)
+void crossfi(float *data, int size, int start0, int nlags0, int nlags, float *engref, int *maxloc, float *maxval, float *correl, int *locs, int nlocs, Xcorr_scratch *scratch)
 {
-  static float *dbdata=NULL;
-  static int dbsize = 0;
   register float *dp, *ds, sum, st;
   register int j;
   register  float *dq, t, *p, engr, *dds, amax;
   register  double engc;
-  int i, iloc, start, total;
+  float *dbdata;
+  int i, iloc, start;
 
   /* Compute mean in reference window and subtract this from the
      entire sequence. */
-  if((total = size+start0+nlags0) > dbsize) {
-    if(dbdata)
-      ckfree((void *)dbdata);
-    dbdata = NULL;
-    dbsize = 0;
-    if(!(dbdata = (float*)ckalloc(sizeof(float)*total))) {
-      Fprintf(stderr,"Allocation failure in crossfi()\n");
-      return;/*exit(-1);*/
-    }
-    dbsize = total;
+  if(!xcorr_scratch_reserve(scratch, size+start0+nlags0, 0)) {
+    Fprintf(stderr,"Allocation failure in crossfi()\n");
+    return;/*exit(-1);*/
   }
+  dbdata = scratch->dbdata;
   for(engr=0.0, j=size, p=data; j--; ) engr += *p++;
   engr /= size;
 /*  for(j=size+nlags0+start0, t = -2.1, amax = 2.1, dq = dbdata, p=data; j--; ) {
@@ -569,9 +739,11 @@ void crossfi(float *data, int size, int start0, int nlags0, int nlags, float *en
       engc = sum;
 
       /* COMPUTE CORRELATIONS AT ALL REQUESTED LAGS */
+      xcorr_lags(dbdata, dbdata+start, size, nlags, dq);
       for(i=0; i < nlags; i++) {
-	for(j=size, sum=0.0, dp=dbdata, dds = ds = dbdata+i+start; j--; )
-	  sum += *dp++ * *ds++;
+	dds = dbdata+i+start;
+	ds = dds+size;
+	sum = *dq;
 	if(engc < 1.0)
 	  engc = 1.0;		/* in case of roundoff error */
 	*dq++ = t = (float) (sum/sqrt((double)(10000.0 + (engc*engr))));
@@ -21,6 +21,19 @@
  * 
  */
 
+class FFTReal;
+
+/* Scratch space of crossf() and crossfi(), owned by the caller. Start
+   from {NULL, 0, NULL, NULL, 0}; the buffers grow as needed and are
+   released by free_xcorr_scratch(). */
+typedef struct {
+  float *dbdata;        /* the signal minus the mean of the reference window */
+  int dbsize;
+  float *fftbuf;        /* 3 x fftsize */
+  FFTReal *fft;
+  int fftsize;
+} Xcorr_scratch;
+
 int xget_window(float *dout, int n, int type);
 void xrwindow(float *din, float *dout, int n, float preemp);
 void xcwindow(float *din, float *dout, int n, float preemp);
@@ -33,5 +46,6 @@ void xa_to_aca(float *a, float *b, float *c, int p);
 float xitakura (int p, float *b, float *c, float *r, float *gain );
 float wind_energy(float *data, int size, int w_type);
 int xlpc(int lpc_ord, float lpc_stabl, int wsize, float *data, float *lpca, float *ar, float *lpck, float *normerr, float *rms, float preemp, int type);
-void crossf(float *data, int size, int start, int nlags, float *engref, int *maxloc, float *maxval, float *correl);
-void crossfi(float *data, int size, int start0, int nlags0, int nlags, float *engref, int *maxloc, float *maxval, float *correl, int *locs, int nlocs);
+void crossf(float *data, int size, int start, int nlags, float *engref, int *maxloc, float *maxval, float *correl, Xcorr_scratch *scratch);
+void crossfi(float *data, int size, int start0, int nlags0, int nlags, float *engref, int *maxloc, float *maxval, float *correl, int *locs, int nlocs, Xcorr_scratch *scratch);
+void free_xcorr_scratch(Xcorr_scratch *scratch);